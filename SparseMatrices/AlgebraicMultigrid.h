@@ -0,0 +1,614 @@
+/**
+	Smoothed aggregation algebraic multigrid preconditioner
+
+	Author: Belousov K.
+	Repository: https://github.com/kombuchamp/SparseMatrices
+*/
+
+#pragma once
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <utility>
+#include <vector>
+#include "CSRSparseMatrix.h"
+#include "IterativeSolver.h"
+#include "Relaxation.h"
+#include "SpMVKernels.h"
+#include "ThreadPool.h"
+
+struct MultigridOptions
+{
+	// j is a strong neighbour of i when |a_ij| >= StrengthThreshold * sqrt(|a_ii a_jj|)
+	double StrengthThreshold = 0.08;
+	// Prolongator smoothing weight, divided by Gershgorin estimate of the spectral radius of D^-1 A
+	double ProlongatorDamping = 4. / 3.;
+	size_t MaxLevels = 20;
+	// Coarsening stops at this size, such coarsest system is solved by dense LU
+	size_t CoarsestSize = 200;
+	// Multicolor Gauss-Seidel sweeps, forward before coarse correction and backward after it
+	size_t PreSmoothingSweeps = 1;
+	size_t PostSmoothingSweeps = 1;
+};
+
+/**
+ * Hierarchy of coarser systems built from the matrix alone. Every level groups strongly connected rows
+ * into aggregates, tentative prolongator P0 maps an aggregate to its rows, smoothed prolongator
+ * P = (I - w D^-1 A) P0, restrictor R = P^T and the coarse matrix is the Galerkin product R A P.
+ * Strength of connection, prolongator smoothing, products and transposes run on the thread pool,
+ * aggregation and coloring of smoothers are sequential greedy passes.
+ * Apply(r, z) is one V-cycle from zero initial guess. With as many post-smoothing sweeps as pre-smoothing ones,
+ * forward pre-smoothing and backward post-smoothing make the cycle symmetric, so it preconditions conjugate
+ * gradient. Unequal sweep counts give a nonsymmetric cycle, which suits GMRES or BiCGSTAB only.
+ * Like Relaxation, AlgebraicMultigrid holds a reference to the matrix. When values of the matrix change
+ * without changing its pattern, UpdateValues recomputes prolongators, coarse matrices and smoothers keeping
+ * aggregates, sparsity patterns and colorings, and the hierarchy is reused for the new system.
+ */
+template<typename T = double, typename Index = size_t>
+class AlgebraicMultigrid
+{
+public:
+	explicit AlgebraicMultigrid(const CSRSparseMatrix<T, Index> &matrix, const MultigridOptions &options = MultigridOptions(),
+		ThreadPool &pool = ThreadPool::Default());
+	void UpdateValues();
+	void Apply(const T *r, T *z);
+	// One V-cycle improving x
+	void Cycle(const T *b, T *x);
+	[[nodiscard]] const MultigridOptions &GetOptions() const;
+	[[nodiscard]] size_t GetLevelCount() const;
+	[[nodiscard]] const CSRSparseMatrix<T, Index> &GetLevelMatrix(size_t level) const;
+	// Prolongator from level + 1 to level
+	[[nodiscard]] const CSRSparseMatrix<T, Index> &GetProlongator(size_t level) const;
+	// Total number of nonzero elements of all levels relative to the matrix
+	[[nodiscard]] double GetOperatorComplexity() const;
+private:
+	static constexpr size_t NotAggregated = std::numeric_limits<size_t>::max();
+	struct Level
+	{
+		// Matrix of the level, empty for the finest one
+		CSRSparseMatrix<T, Index> Matrix;
+		// Transfer operators to the next coarser level, empty for the coarsest one
+		CSRSparseMatrix<T, Index> Tentative;
+		CSRSparseMatrix<T, Index> Prolongator;
+		CSRSparseMatrix<T, Index> Restrictor;
+		std::unique_ptr<Relaxation<T, Index>> Smoother;
+		// Right-hand side and solution of coarse levels
+		std::vector<T> B;
+		std::vector<T> X;
+		std::vector<T> Residual;
+	};
+	[[nodiscard]] std::vector<size_t> Aggregate(const CSRSparseMatrix<T, Index> &matrix, size_t &aggregateCount) const;
+	[[nodiscard]] CSRSparseMatrix<T, Index> SmoothProlongator(const CSRSparseMatrix<T, Index> &matrix, const CSRSparseMatrix<T, Index> &tentative) const;
+	void ComputeTransfers(size_t level);
+	void FactorizeCoarsest();
+	void SolveCoarsest(const T *b, T *x);
+	void CycleLevel(size_t level, const T *b, T *x);
+	const CSRSparseMatrix<T, Index> &_matrix;
+	MultigridOptions _options;
+	ThreadPool &_pool;
+	// Pattern of the matrix the hierarchy was built for
+	std::vector<size_t> _rowPtr;
+	std::vector<Index> _colIdx;
+	std::vector<Level> _levels;
+	// Dense LU of the coarsest matrix with row pivots, empty if it is too large and is smoothed instead
+	std::vector<T> _coarseLU;
+	std::vector<size_t> _coarsePivots;
+};
+
+template<typename T, typename Index>
+AlgebraicMultigrid<T, Index>::AlgebraicMultigrid(const CSRSparseMatrix<T, Index> &matrix, const MultigridOptions &options, ThreadPool &pool)
+	: _matrix(matrix), _options(options), _pool(pool), _rowPtr(matrix.GetRowPointers()),
+	_colIdx(matrix.GetColIndices())
+{
+	GetSystemSize(matrix);
+	_levels.emplace_back();
+	while (_levels.size() < std::max<size_t>(1, _options.MaxLevels) && GetLevelMatrix(_levels.size() - 1).GetRowCount() > _options.CoarsestSize)
+	{
+		const auto level = _levels.size() - 1;
+		const auto &matrixOfLevel = GetLevelMatrix(level);
+		const auto rowCount = matrixOfLevel.GetRowCount();
+		size_t aggregateCount = 0;
+		const auto aggregates = Aggregate(matrixOfLevel, aggregateCount);
+		if (aggregateCount == 0 || aggregateCount == rowCount)
+		{
+			break;
+		}
+		// Rows of an aggregate share a column of P0, normalized so that P0^T P0 = I
+		std::vector<size_t> sizes(aggregateCount, 0);
+		for (auto aggregate : aggregates)
+		{
+			if (aggregate != NotAggregated)
+			{
+				++sizes[aggregate];
+			}
+		}
+		auto &tentative = _levels[level].Tentative;
+		tentative = CSRSparseMatrix<T, Index>(rowCount, aggregateCount);
+		for (size_t i = 0; i < rowCount; i++)
+		{
+			tentative._rowPtr[i + 1] = tentative._rowPtr[i];
+			if (aggregates[i] != NotAggregated)
+			{
+				tentative._colIdx.push_back(static_cast<Index>(aggregates[i]));
+				tentative._values.push_back(T(1) / std::sqrt(static_cast<T>(sizes[aggregates[i]])));
+				++tentative._rowPtr[i + 1];
+			}
+		}
+		_levels.emplace_back();
+		ComputeTransfers(level);
+	}
+
+	// Smoothers hold references to level matrices, so they are created once the levels stop moving
+	for (size_t level = 0; level < _levels.size(); level++)
+	{
+		auto &current = _levels[level];
+		const auto size = GetLevelMatrix(level).GetRowCount();
+		current.Smoother = std::make_unique<Relaxation<T, Index>>(GetLevelMatrix(level), pool);
+		current.Residual.resize(size);
+		if (level > 0)
+		{
+			current.B.resize(size);
+			current.X.resize(size);
+		}
+	}
+	FactorizeCoarsest();
+}
+
+/**
+ * Standard aggregation in three passes over rows in order:
+ * 1. a row with all strong neighbours free forms an aggregate with them;
+ * 2. a free row joins the aggregate of a strong neighbour aggregated by pass 1;
+ * 3. a free row forms an aggregate with its free strong neighbours.
+ * Rows without strong neighbours stay out of aggregates and are left to smoothers.
+ */
+template<typename T, typename Index>
+std::vector<size_t> AlgebraicMultigrid<T, Index>::Aggregate(const CSRSparseMatrix<T, Index> &matrix, size_t &aggregateCount) const
+{
+	const auto n = matrix.GetRowCount();
+	const auto &rowPtr = matrix.GetRowPointers();
+	const auto &colIdx = matrix.GetColIndices();
+	const auto &values = matrix.GetValues();
+
+	std::vector<T> diagonal(n, T());
+	std::vector<char> strong(values.size(), 0);
+	_pool.ParallelForRange(n,
+		[&](size_t begin, size_t end, size_t)
+		{
+			for (auto i = begin; i < end; i++)
+			{
+				for (auto p = rowPtr[i]; p < rowPtr[i + 1]; p++)
+				{
+					if (colIdx[p] == i)
+					{
+						diagonal[i] = std::abs(values[p]);
+					}
+				}
+			}
+		});
+	const auto threshold = _options.StrengthThreshold;
+	_pool.ParallelForRange(n,
+		[&](size_t begin, size_t end, size_t)
+		{
+			for (auto i = begin; i < end; i++)
+			{
+				for (auto p = rowPtr[i]; p < rowPtr[i + 1]; p++)
+				{
+					const size_t j = colIdx[p];
+					strong[p] = j != i && std::abs(values[p]) >= threshold * std::sqrt(diagonal[i] * diagonal[j]);
+				}
+			}
+		});
+
+	std::vector<size_t> aggregates(n, NotAggregated);
+	std::vector<char> hasStrongNeighbours(n, 0);
+	aggregateCount = 0;
+	for (size_t i = 0; i < n; i++)
+	{
+		auto allFree = true;
+		for (auto p = rowPtr[i]; p < rowPtr[i + 1]; p++)
+		{
+			if (strong[p])
+			{
+				hasStrongNeighbours[i] = 1;
+				allFree = allFree && aggregates[colIdx[p]] == NotAggregated;
+			}
+		}
+		if (!hasStrongNeighbours[i] || !allFree || aggregates[i] != NotAggregated)
+		{
+			continue;
+		}
+		aggregates[i] = aggregateCount;
+		for (auto p = rowPtr[i]; p < rowPtr[i + 1]; p++)
+		{
+			if (strong[p])
+			{
+				aggregates[colIdx[p]] = aggregateCount;
+			}
+		}
+		++aggregateCount;
+	}
+
+	const auto firstPass = aggregates;
+	for (size_t i = 0; i < n; i++)
+	{
+		if (aggregates[i] != NotAggregated)
+		{
+			continue;
+		}
+		for (auto p = rowPtr[i]; p < rowPtr[i + 1]; p++)
+		{
+			if (strong[p] && firstPass[colIdx[p]] != NotAggregated)
+			{
+				aggregates[i] = firstPass[colIdx[p]];
+				break;
+			}
+		}
+	}
+
+	for (size_t i = 0; i < n; i++)
+	{
+		if (aggregates[i] != NotAggregated || !hasStrongNeighbours[i])
+		{
+			continue;
+		}
+		aggregates[i] = aggregateCount;
+		for (auto p = rowPtr[i]; p < rowPtr[i + 1]; p++)
+		{
+			if (strong[p] && aggregates[colIdx[p]] == NotAggregated)
+			{
+				aggregates[colIdx[p]] = aggregateCount;
+			}
+		}
+		++aggregateCount;
+	}
+	return aggregates;
+}
+
+/**
+ * P = P0 - w / rho D^-1 A P0. P0 has at most one element per row, so row i of P is gathered from the aggregates
+ * of the columns of row i of A. Elements that cancel out are kept, so the pattern of P depends only
+ * on the pattern of A and the aggregates.
+ */
+template<typename T, typename Index>
+CSRSparseMatrix<T, Index> AlgebraicMultigrid<T, Index>::SmoothProlongator(const CSRSparseMatrix<T, Index> &matrix,
+	const CSRSparseMatrix<T, Index> &tentative) const
+{
+	const auto n = matrix.GetRowCount();
+	const auto &rowPtr = matrix.GetRowPointers();
+	const auto &colIdx = matrix.GetColIndices();
+	const auto &values = matrix.GetValues();
+
+	// Gershgorin bound of the spectral radius of D^-1 A, taken per row and reduced per range
+	std::vector<T> inverseDiagonal(n, T());
+	std::vector<T> rangeRadius(4 * _pool.GetThreadCount(), T());
+	const auto rangeSize = (n + rangeRadius.size() - 1) / rangeRadius.size();
+	_pool.ParallelFor(rangeRadius.size(),
+		[&](size_t range, size_t)
+		{
+			for (auto i = range * rangeSize; i < std::min(n, (range + 1) * rangeSize); i++)
+			{
+				T diagonal = T();
+				T sum = T();
+				for (auto p = rowPtr[i]; p < rowPtr[i + 1]; p++)
+				{
+					sum += std::abs(values[p]);
+					if (colIdx[p] == i)
+					{
+						diagonal = values[p];
+					}
+				}
+				if (diagonal == T())
+				{
+					throw std::invalid_argument("Invalid argument: multigrid requires nonzero diagonal");
+				}
+				inverseDiagonal[i] = T(1) / diagonal;
+				rangeRadius[range] = std::max(rangeRadius[range], sum / std::abs(diagonal));
+			}
+		});
+	const auto radius = *std::max_element(rangeRadius.begin(), rangeRadius.end());
+	const auto weight = static_cast<T>(_options.ProlongatorDamping) / radius;
+
+	// Sorted distinct columns of row i of P with their values
+	const auto gatherRow = [&](size_t i, std::vector<std::pair<Index, T>> &entries)
+	{
+		entries.clear();
+		const auto scale = -weight * inverseDiagonal[i];
+		for (auto p = rowPtr[i]; p < rowPtr[i + 1]; p++)
+		{
+			const size_t j = colIdx[p];
+			for (auto q = tentative._rowPtr[j]; q < tentative._rowPtr[j + 1]; q++)
+			{
+				entries.emplace_back(tentative._colIdx[q], scale * values[p] * tentative._values[q]);
+			}
+		}
+		for (auto q = tentative._rowPtr[i]; q < tentative._rowPtr[i + 1]; q++)
+		{
+			entries.emplace_back(tentative._colIdx[q], tentative._values[q]);
+		}
+		std::sort(entries.begin(), entries.end(),
+			[](const std::pair<Index, T> &a, const std::pair<Index, T> &b)
+			{
+				return a.first < b.first;
+			});
+		size_t count = 0;
+		for (auto &entry : entries)
+		{
+			if (count > 0 && entries[count - 1].first == entry.first)
+			{
+				entries[count - 1].second += entry.second;
+			}
+			else
+			{
+				entries[count++] = entry;
+			}
+		}
+		entries.resize(count);
+	};
+
+	CSRSparseMatrix<T, Index> prolongator(n, tentative.GetColCount());
+	_pool.ParallelForRange(n,
+		[&](size_t begin, size_t end, size_t)
+		{
+			std::vector<std::pair<Index, T>> entries;
+			for (auto i = begin; i < end; i++)
+			{
+				gatherRow(i, entries);
+				prolongator._rowPtr[i + 1] = entries.size();
+			}
+		});
+	std::partial_sum(prolongator._rowPtr.begin(), prolongator._rowPtr.end(), prolongator._rowPtr.begin());
+	prolongator._colIdx.resize(prolongator._rowPtr.back());
+	prolongator._values.resize(prolongator._rowPtr.back());
+	_pool.ParallelForRange(n,
+		[&](size_t begin, size_t end, size_t)
+		{
+			std::vector<std::pair<Index, T>> entries;
+			for (auto i = begin; i < end; i++)
+			{
+				gatherRow(i, entries);
+				auto position = prolongator._rowPtr[i];
+				for (auto &entry : entries)
+				{
+					prolongator._colIdx[position] = entry.first;
+					prolongator._values[position++] = entry.second;
+				}
+			}
+		});
+	return prolongator;
+}
+
+/**
+ * Smoothed prolongator, restrictor and Galerkin coarse matrix of the next level from the tentative prolongator
+ */
+template<typename T, typename Index>
+void AlgebraicMultigrid<T, Index>::ComputeTransfers(const size_t level)
+{
+	auto &current = _levels[level];
+	const auto &matrix = GetLevelMatrix(level);
+	current.Prolongator = SmoothProlongator(matrix, current.Tentative);
+	current.Restrictor = current.Prolongator.Transposed(_pool);
+	_levels[level + 1].Matrix = current.Restrictor.ParallelMultiply(matrix.ParallelMultiply(current.Prolongator, _pool), _pool);
+}
+
+template<typename T, typename Index>
+void AlgebraicMultigrid<T, Index>::UpdateValues()
+{
+	if (_matrix.GetRowPointers() != _rowPtr || _matrix.GetColIndices() != _colIdx)
+	{
+		throw std::invalid_argument("Invalid argument: matrix pattern differs from the one of the hierarchy");
+	}
+	_levels[0].Smoother->UpdateValues();
+	for (size_t level = 0; level + 1 < _levels.size(); level++)
+	{
+		auto &coarse = _levels[level + 1];
+		const auto rowPtr = coarse.Matrix.GetRowPointers();
+		const auto colIdx = coarse.Matrix.GetColIndices();
+		ComputeTransfers(level);
+		// Galerkin product drops elements that cancel out, so the coarse pattern may change with values
+		if (coarse.Matrix.GetRowPointers() == rowPtr && coarse.Matrix.GetColIndices() == colIdx)
+		{
+			coarse.Smoother->UpdateValues();
+		}
+		else
+		{
+			coarse.Smoother = std::make_unique<Relaxation<T, Index>>(coarse.Matrix, _pool);
+		}
+	}
+	FactorizeCoarsest();
+}
+
+/**
+ * Gaussian elimination with partial pivoting of the coarsest matrix if it is small enough
+ */
+template<typename T, typename Index>
+void AlgebraicMultigrid<T, Index>::FactorizeCoarsest()
+{
+	const auto &matrix = GetLevelMatrix(_levels.size() - 1);
+	const auto n = matrix.GetRowCount();
+	if (n > _options.CoarsestSize)
+	{
+		_coarseLU.clear();
+		_coarsePivots.clear();
+		return;
+	}
+	_coarseLU.assign(n * n, T());
+	_coarsePivots.resize(n);
+	const auto &rowPtr = matrix.GetRowPointers();
+	for (size_t i = 0; i < n; i++)
+	{
+		for (auto p = rowPtr[i]; p < rowPtr[i + 1]; p++)
+		{
+			_coarseLU[i * n + matrix.GetColIndices()[p]] = matrix.GetValues()[p];
+		}
+	}
+	auto *lu = _coarseLU.data();
+	for (size_t k = 0; k < n; k++)
+	{
+		auto pivot = k;
+		for (auto i = k + 1; i < n; i++)
+		{
+			if (std::abs(lu[i * n + k]) > std::abs(lu[pivot * n + k]))
+			{
+				pivot = i;
+			}
+		}
+		if (lu[pivot * n + k] == T())
+		{
+			throw std::invalid_argument("Invalid argument: coarsest multigrid matrix is singular");
+		}
+		_coarsePivots[k] = pivot;
+		if (pivot != k)
+		{
+			std::swap_ranges(lu + k * n, lu + (k + 1) * n, lu + pivot * n);
+		}
+		for (auto i = k + 1; i < n; i++)
+		{
+			const auto multiplier = lu[i * n + k] /= lu[k * n + k];
+			for (auto j = k + 1; j < n; j++)
+			{
+				lu[i * n + j] -= multiplier * lu[k * n + j];
+			}
+		}
+	}
+}
+
+template<typename T, typename Index>
+void AlgebraicMultigrid<T, Index>::SolveCoarsest(const T *b, T *x)
+{
+	auto &coarsest = _levels.back();
+	if (_coarseLU.empty())
+	{
+		coarsest.Smoother->MulticolorGaussSeidel(b, x, _options.PreSmoothingSweeps, SweepDirection::Forward);
+		coarsest.Smoother->MulticolorGaussSeidel(b, x, _options.PostSmoothingSweeps, SweepDirection::Backward);
+		return;
+	}
+	const auto n = _coarsePivots.size();
+	const auto *lu = _coarseLU.data();
+	std::copy(b, b + n, x);
+	for (size_t k = 0; k < n; k++)
+	{
+		std::swap(x[k], x[_coarsePivots[k]]);
+		for (size_t j = 0; j < k; j++)
+		{
+			x[k] -= lu[k * n + j] * x[j];
+		}
+	}
+	for (auto k = n; k > 0; k--)
+	{
+		for (auto j = k; j < n; j++)
+		{
+			x[k - 1] -= lu[(k - 1) * n + j] * x[j];
+		}
+		x[k - 1] /= lu[(k - 1) * n + k - 1];
+	}
+}
+
+template<typename T, typename Index>
+void AlgebraicMultigrid<T, Index>::Apply(const T *r, T *z)
+{
+	const auto n = _matrix.GetRowCount();
+	_pool.ParallelForRange(n,
+		[&](size_t begin, size_t end, size_t)
+		{
+			std::fill(z + begin, z + end, T());
+		});
+	CycleLevel(0, r, z);
+}
+
+template<typename T, typename Index>
+void AlgebraicMultigrid<T, Index>::Cycle(const T *b, T *x)
+{
+	CycleLevel(0, b, x);
+}
+
+/**
+ * Sparse products of the cycle are fused row loops, so the cycle allocates nothing
+ */
+template<typename T, typename Index>
+void AlgebraicMultigrid<T, Index>::CycleLevel(const size_t level, const T *b, T *x)
+{
+	if (level + 1 == _levels.size())
+	{
+		SolveCoarsest(b, x);
+		return;
+	}
+	auto &current = _levels[level];
+	auto &coarse = _levels[level + 1];
+	const auto &matrix = GetLevelMatrix(level);
+	current.Smoother->MulticolorGaussSeidel(b, x, _options.PreSmoothingSweeps, SweepDirection::Forward);
+
+	const auto rowProduct = [](const CSRSparseMatrix<T, Index> &a, size_t row, const T *vector)
+	{
+		const auto begin = a.GetRowPointers()[row];
+		return SparseDot(a.GetColIndices().data() + begin, a.GetValues().data() + begin, a.GetRowPointers()[row + 1] - begin, vector);
+	};
+	auto *residual = current.Residual.data();
+	_pool.ParallelForRange(matrix.GetRowCount(),
+		[&](size_t begin, size_t end, size_t)
+		{
+			for (auto i = begin; i < end; i++)
+			{
+				residual[i] = b[i] - rowProduct(matrix, i, x);
+			}
+		});
+	auto *coarseB = coarse.B.data();
+	auto *coarseX = coarse.X.data();
+	_pool.ParallelForRange(coarse.B.size(),
+		[&](size_t begin, size_t end, size_t)
+		{
+			for (auto i = begin; i < end; i++)
+			{
+				coarseB[i] = rowProduct(current.Restrictor, i, residual);
+				coarseX[i] = T();
+			}
+		});
+	CycleLevel(level + 1, coarseB, coarseX);
+	_pool.ParallelForRange(matrix.GetRowCount(),
+		[&](size_t begin, size_t end, size_t)
+		{
+			for (auto i = begin; i < end; i++)
+			{
+				x[i] += rowProduct(current.Prolongator, i, coarseX);
+			}
+		});
+
+	current.Smoother->MulticolorGaussSeidel(b, x, _options.PostSmoothingSweeps, SweepDirection::Backward);
+}
+
+template<typename T, typename Index>
+const MultigridOptions &AlgebraicMultigrid<T, Index>::GetOptions() const
+{
+	return _options;
+}
+
+template<typename T, typename Index>
+size_t AlgebraicMultigrid<T, Index>::GetLevelCount() const
+{
+	return _levels.size();
+}
+
+template<typename T, typename Index>
+const CSRSparseMatrix<T, Index> &AlgebraicMultigrid<T, Index>::GetLevelMatrix(const size_t level) const
+{
+	return level == 0 ? _matrix : _levels[level].Matrix;
+}
+
+template<typename T, typename Index>
+const CSRSparseMatrix<T, Index> &AlgebraicMultigrid<T, Index>::GetProlongator(const size_t level) const
+{
+	return _levels[level].Prolongator;
+}
+
+template<typename T, typename Index>
+double AlgebraicMultigrid<T, Index>::GetOperatorComplexity() const
+{
+	size_t nonZeros = 0;
+	for (size_t level = 0; level < _levels.size(); level++)
+	{
+		nonZeros += GetLevelMatrix(level).GetNonZeroElementsCount();
+	}
+	return _colIdx.empty() ? 1. : static_cast<double>(nonZeros) / static_cast<double>(_colIdx.size());
+}
\ No newline at end of file
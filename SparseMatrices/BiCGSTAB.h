@@ -0,0 +1,218 @@
+/**
+	Stabilized biconjugate gradient solver for general square systems
+
+	Author: Belousov K.
+	Repository: https://github.com/kombuchamp/SparseMatrices
+*/
+
+#pragma once
+#include <stdexcept>
+#include <cmath>
+#include <utility>
+#include <vector>
+#include "IterativeSolver.h"
+#include "ThreadPool.h"
+#include "VectorKernels.h"
+
+/**
+ * BiCGSTAB with right preconditioning: every iteration makes two products and two preconditioner applications,
+ * memory use doesn't grow with iterations, unlike GMRES. Residual norm is tracked by recurrence.
+ * Search direction update, both solution updates and residual updates with their norms are fused
+ * into single passes over vectors. Work vectors are kept between solves.
+ */
+template<typename T = double>
+class BiCGSTAB
+{
+public:
+	explicit BiCGSTAB(const SolverOptions &options = SolverOptions(), ThreadPool &pool = ThreadPool::Default())
+		: _options(options), _kernels(pool)
+	{
+	}
+	template<typename Matrix, typename Preconditioner = IdentityPreconditioner>
+	SolverResult Solve(const Matrix &matrix, const T *b, T *x, Preconditioner &&preconditioner = Preconditioner());
+	template<typename Matrix, typename Preconditioner = IdentityPreconditioner>
+	SolverResult Solve(const Matrix &matrix, const std::vector<T> &b, std::vector<T> &x, Preconditioner &&preconditioner = Preconditioner());
+	[[nodiscard]] const SolverOptions &GetOptions() const;
+	void SetOptions(const SolverOptions &options);
+private:
+	void Resize(size_t size);
+	SolverOptions _options;
+	VectorKernels<T> _kernels;
+	std::vector<T> _r;
+	std::vector<T> _shadow;
+	std::vector<T> _p;
+	std::vector<T> _v;
+	std::vector<T> _s;
+	std::vector<T> _t;
+	std::vector<T> _pHat;
+	std::vector<T> _sHat;
+};
+
+/**
+ * x holds initial guess on input and solution on output.
+ * Solver stops without convergence on breakdown (rho or omega turning zero).
+ */
+template<typename T>
+template<typename Matrix, typename Preconditioner>
+SolverResult BiCGSTAB<T>::Solve(const Matrix &matrix, const T *b, T *x, Preconditioner &&preconditioner)
+{
+	constexpr auto unpreconditioned = IsIdentityPreconditioner<Preconditioner>();
+	const auto n = GetSystemSize(matrix);
+	Resize(n);
+	SolverResult result;
+	if (_options.RecordResidualHistory)
+	{
+		result.ResidualHistory.reserve(_options.MaxIterations + 1);
+	}
+	const auto record = [&](T squaredNorm)
+	{
+		result.ResidualNorm = std::sqrt(static_cast<double>(squaredNorm));
+		if (_options.RecordResidualHistory)
+		{
+			result.ResidualHistory.push_back(result.ResidualNorm);
+		}
+	};
+	const auto threshold = _options.RelativeTolerance * _kernels.Norm(b);
+
+	auto *r = _r.data();
+	auto *shadow = _shadow.data();
+	auto *p = _p.data();
+	auto *v = _v.data();
+	auto *s = _s.data();
+	auto *t = _t.data();
+	auto *pHat = unpreconditioned ? p : _pHat.data();
+	auto *sHat = unpreconditioned ? s : _sHat.data();
+
+	_kernels.Multiply(matrix, x, v);
+	record(_kernels.Residual(b, v, r));
+	if (result.ResidualNorm <= threshold)
+	{
+		result.Converged = true;
+		return result;
+	}
+	_kernels.Copy(r, shadow);
+	_kernels.Fill(T(), p);
+	_kernels.Fill(T(), v);
+	T rho = 1;
+	T alpha = 1;
+	T omega = 1;
+
+	while (result.Iterations < _options.MaxIterations)
+	{
+		const auto rhoNext = _kernels.Dot(shadow, r);
+		if (rhoNext == T())
+		{
+			break;
+		}
+		const auto beta = rhoNext / rho * (alpha / omega);
+		rho = rhoNext;
+		_kernels.ForEachBlock(
+			[&](size_t begin, size_t end)
+			{
+				for (auto i = begin; i < end; i++)
+				{
+					p[i] = r[i] + beta * (p[i] - omega * v[i]);
+				}
+			});
+		if constexpr (!unpreconditioned)
+		{
+			preconditioner.Apply(p, pHat);
+		}
+		const auto shadowV = _kernels.MultiplyDot(matrix, pHat, v, shadow);
+		if (shadowV == T())
+		{
+			break;
+		}
+		alpha = rho / shadowV;
+		const auto ss = _kernels.Reduce(
+			[&](size_t begin, size_t end)
+			{
+				T sum = T();
+				for (auto i = begin; i < end; i++)
+				{
+					s[i] = r[i] - alpha * v[i];
+					sum += s[i] * s[i];
+				}
+				return sum;
+			});
+		++result.Iterations;
+		if (std::sqrt(static_cast<double>(ss)) <= threshold)
+		{
+			_kernels.Axpy(alpha, pHat, x);
+			record(ss);
+			result.Converged = true;
+			break;
+		}
+
+		if constexpr (!unpreconditioned)
+		{
+			preconditioner.Apply(s, sHat);
+		}
+		const auto ts = _kernels.MultiplyDot(matrix, sHat, t, s);
+		const auto tt = _kernels.Dot(t, t);
+		omega = tt != T() ? ts / tt : T();
+		const auto rr = _kernels.Reduce(
+			[&](size_t begin, size_t end)
+			{
+				T sum = T();
+				for (auto i = begin; i < end; i++)
+				{
+					x[i] += alpha * pHat[i] + omega * sHat[i];
+					r[i] = s[i] - omega * t[i];
+					sum += r[i] * r[i];
+				}
+				return sum;
+			});
+		record(rr);
+		if (result.ResidualNorm <= threshold)
+		{
+			result.Converged = true;
+			break;
+		}
+		if (omega == T())
+		{
+			break;
+		}
+	}
+	return result;
+}
+
+template<typename T>
+template<typename Matrix, typename Preconditioner>
+SolverResult BiCGSTAB<T>::Solve(const Matrix &matrix, const std::vector<T> &b, std::vector<T> &x, Preconditioner &&preconditioner)
+{
+	if (b.size() != matrix.GetRowCount() || x.size() != matrix.GetColCount())
+	{
+		throw std::invalid_argument("Invalid argument: vector size doesn't match matrix size");
+	}
+	return Solve(matrix, b.data(), x.data(), std::forward<Preconditioner>(preconditioner));
+}
+
+template<typename T>
+const SolverOptions &BiCGSTAB<T>::GetOptions() const
+{
+	return _options;
+}
+
+template<typename T>
+void BiCGSTAB<T>::SetOptions(const SolverOptions &options)
+{
+	_options = options;
+}
+
+template<typename T>
+void BiCGSTAB<T>::Resize(const size_t size)
+{
+	if (_kernels.GetSize() != size)
+	{
+		_kernels.Resize(size);
+		_r.resize(size);
+		_shadow.resize(size);
+		_p.resize(size);
+		_v.resize(size);
+		_s.resize(size);
+		_t.resize(size);
+		_pHat.resize(size);
+		_sHat.resize(size);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,362 @@
+/**
+	Versioned binary snapshot of compressed sparse matrix
+
+	Author: Belousov K.
+	Repository: https://github.com/kombuchamp/SparseMatrices
+*/
+
+#pragma once
+#include <stdexcept>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include "CSRSparseMatrix.h"
+#include "SparseIndex.h"
+
+enum class SnapshotValueType : uint8_t
+{
+	Float32 = 1,
+	Float64 = 2,
+	Int32 = 3,
+	Int64 = 4,
+	UInt32 = 5,
+	UInt64 = 6
+};
+
+enum class SnapshotVerification
+{
+	// Header fields, file size and the first and last row pointers are checked, O(1).
+	// Row pointers in between and column indices are trusted.
+	Header,
+	// Row pointers are checked to be nondecreasing and column indices of every row to be ascending
+	// and below column count as well, reads row pointers and column indices
+	Structure,
+	// Checksum of all arrays is recomputed after the structure checks, reads the whole file
+	Checksum
+};
+
+/**
+ * Snapshot file starts with this 64 byte header, followed by row pointers, column indices and values.
+ * Every array starts at a 64 byte aligned offset and is stored in native byte order,
+ * so a mapped file can be used as matrix arrays directly.
+ */
+struct SnapshotHeader
+{
+	char Magic[8];
+	uint32_t Version;
+	// Written as 0x01020304 in native byte order, reads differently on machine with other endianness
+	uint32_t ByteOrderMark;
+	uint64_t RowCount;
+	uint64_t ColCount;
+	uint64_t NonZeroElementsCount;
+	// Bytes per column index
+	uint8_t IndexWidth;
+	SnapshotValueType ValueType;
+	// Bytes per row pointer
+	uint8_t OffsetWidth;
+	uint8_t Reserved[5];
+	// Checksum of row pointers, column indices and values, padding excluded
+	uint64_t Checksum;
+	uint64_t Reserved2;
+};
+static_assert(sizeof(SnapshotHeader) == 64, "Snapshot header should be 64 bytes long");
+
+/**
+ * Fast 64-bit checksum of byte stream, not cryptographic
+ */
+class SnapshotChecksum
+{
+public:
+	void Update(const void *data, size_t size);
+	[[nodiscard]] uint64_t GetValue() const;
+private:
+	void Mix(uint64_t word);
+	uint64_t _state = 0x9E3779B97F4A7C15ull;
+	uint64_t _length = 0;
+	unsigned char _tail[8] = {};
+	size_t _tailSize = 0;
+};
+
+/**
+ * Offsets of snapshot arrays in file
+ */
+struct SnapshotLayout
+{
+	size_t RowPtrOffset;
+	size_t ColIdxOffset;
+	size_t ValuesOffset;
+	size_t FileSize;
+};
+
+class BinarySnapshot
+{
+public:
+	static constexpr char Magic[8] = { 'S', 'P', 'M', 'X', 'C', 'S', 'R', '\0' };
+	// Version 2 stores column indices of any width separately from row pointers width
+	static constexpr uint32_t Version = 2;
+	static constexpr uint32_t ByteOrderMark = 0x01020304;
+	static constexpr size_t Alignment = 64;
+
+	template<typename T, typename Index>
+	static void Write(std::ostream &os, const CSRSparseMatrix<T, Index> &matrix);
+	template<typename T, typename Index>
+	static void WriteFile(const std::string &path, const CSRSparseMatrix<T, Index> &matrix);
+	template<typename T, typename Index>
+	static SnapshotLayout Validate(const char *data, size_t size, SnapshotVerification verification);
+	template<typename T>
+	[[nodiscard]] static constexpr SnapshotValueType ValueTypeOf();
+	[[nodiscard]] static SnapshotLayout GetLayout(const SnapshotHeader &header, size_t valueSize);
+private:
+	static size_t AlignUp(size_t offset);
+	static void WritePadding(std::ostream &os, size_t &offset);
+};
+
+inline void SnapshotChecksum::Update(const void *data, size_t size)
+{
+	if (size == 0)
+	{
+		return;
+	}
+	const auto *bytes = static_cast<const unsigned char *>(data);
+	_length += size;
+	while (_tailSize != 0 && size != 0)
+	{
+		_tail[_tailSize++] = *bytes++;
+		--size;
+		if (_tailSize == 8)
+		{
+			uint64_t word;
+			std::memcpy(&word, _tail, 8);
+			Mix(word);
+			_tailSize = 0;
+		}
+	}
+	for (; size >= 8; size -= 8, bytes += 8)
+	{
+		uint64_t word;
+		std::memcpy(&word, bytes, 8);
+		Mix(word);
+	}
+	std::memcpy(_tail, bytes, size);
+	_tailSize = size;
+}
+
+inline uint64_t SnapshotChecksum::GetValue() const
+{
+	auto copy = *this;
+	uint64_t word = 0;
+	std::memcpy(&word, copy._tail, copy._tailSize);
+	copy.Mix(word);
+	copy.Mix(copy._length);
+	return copy._state;
+}
+
+inline void SnapshotChecksum::Mix(const uint64_t word)
+{
+	_state = (_state ^ word) * 0xFF51AFD7ED558CCDull;
+	_state ^= _state >> 29;
+}
+
+template<typename T, typename Index>
+void BinarySnapshot::Write(std::ostream &os, const CSRSparseMatrix<T, Index> &matrix)
+{
+	const auto &rowPtr = matrix.GetRowPointers();
+	const auto &colIdx = matrix.GetColIndices();
+	const auto &values = matrix.GetValues();
+
+	SnapshotHeader header = {};
+	std::memcpy(header.Magic, Magic, sizeof(Magic));
+	header.Version = Version;
+	header.ByteOrderMark = ByteOrderMark;
+	header.RowCount = matrix.GetRowCount();
+	header.ColCount = matrix.GetColCount();
+	header.NonZeroElementsCount = values.size();
+	header.IndexWidth = sizeof(Index);
+	header.ValueType = ValueTypeOf<T>();
+	header.OffsetWidth = sizeof(size_t);
+
+	SnapshotChecksum checksum;
+	checksum.Update(rowPtr.data(), rowPtr.size() * sizeof(size_t));
+	checksum.Update(colIdx.data(), colIdx.size() * sizeof(Index));
+	checksum.Update(values.data(), values.size() * sizeof(T));
+	header.Checksum = checksum.GetValue();
+
+	size_t offset = sizeof(header);
+	os.write(reinterpret_cast<const char *>(&header), sizeof(header));
+	WritePadding(os, offset);
+	os.write(reinterpret_cast<const char *>(rowPtr.data()), rowPtr.size() * sizeof(size_t));
+	offset += rowPtr.size() * sizeof(size_t);
+	WritePadding(os, offset);
+	os.write(reinterpret_cast<const char *>(colIdx.data()), colIdx.size() * sizeof(Index));
+	offset += colIdx.size() * sizeof(Index);
+	WritePadding(os, offset);
+	os.write(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(T));
+	if (!os)
+	{
+		throw std::runtime_error("Can't write snapshot");
+	}
+}
+
+template<typename T, typename Index>
+void BinarySnapshot::WriteFile(const std::string &path, const CSRSparseMatrix<T, Index> &matrix)
+{
+	std::ofstream file(path, std::ios::binary);
+	if (!file)
+	{
+		throw std::invalid_argument("Can't open file " + path);
+	}
+	Write(file, matrix);
+}
+
+/**
+ * Checks that mapped data is a snapshot of matrix with values of type T and column indices of type Index
+ * and returns positions of its arrays
+ */
+template<typename T, typename Index>
+SnapshotLayout BinarySnapshot::Validate(const char *data, const size_t size, const SnapshotVerification verification)
+{
+	if (size < sizeof(SnapshotHeader))
+	{
+		throw std::invalid_argument("Snapshot is too short");
+	}
+	SnapshotHeader header;
+	std::memcpy(&header, data, sizeof(header));
+	if (std::memcmp(header.Magic, Magic, sizeof(Magic)) != 0)
+	{
+		throw std::invalid_argument("Data is not a sparse matrix snapshot");
+	}
+	if (header.Version != Version)
+	{
+		throw std::invalid_argument("Unsupported snapshot version");
+	}
+	if (header.ByteOrderMark != ByteOrderMark)
+	{
+		throw std::invalid_argument("Snapshot was written on machine with different byte order");
+	}
+	if (header.IndexWidth != sizeof(Index))
+	{
+		throw std::invalid_argument("Snapshot index width doesn't match");
+	}
+	if (header.OffsetWidth != sizeof(size_t))
+	{
+		throw std::invalid_argument("Snapshot row pointers width doesn't match");
+	}
+	if (header.ValueType != ValueTypeOf<T>())
+	{
+		throw std::invalid_argument("Snapshot value type doesn't match");
+	}
+	if (header.RowCount >= size || header.NonZeroElementsCount >= size)
+	{
+		throw std::invalid_argument("Snapshot size doesn't match its header");
+	}
+	if (header.ColCount > std::numeric_limits<size_t>::max() || !FitsIndex<Index>(header.RowCount, header.ColCount))
+	{
+		throw std::invalid_argument("Snapshot matrix size doesn't fit index type");
+	}
+	const auto layout = GetLayout(header, sizeof(T));
+	if (layout.FileSize != size)
+	{
+		throw std::invalid_argument("Snapshot size doesn't match its header");
+	}
+
+	const auto *rowPtr = data + layout.RowPtrOffset;
+	const auto rowPointerAt = [&](size_t row)
+	{
+		size_t value;
+		std::memcpy(&value, rowPtr + row * sizeof(size_t), sizeof(size_t));
+		return value;
+	};
+	if (rowPointerAt(0) != 0 || rowPointerAt(header.RowCount) != header.NonZeroElementsCount)
+	{
+		throw std::invalid_argument("Snapshot row pointers don't match its header");
+	}
+	if (verification == SnapshotVerification::Header)
+	{
+		return layout;
+	}
+	const auto *colIdx = data + layout.ColIdxOffset;
+	for (size_t row = 0; row < header.RowCount; row++)
+	{
+		const auto begin = rowPointerAt(row);
+		const auto end = rowPointerAt(row + 1);
+		if (end < begin || end > header.NonZeroElementsCount)
+		{
+			throw std::invalid_argument("Snapshot row pointers are not ascending");
+		}
+		for (auto k = begin; k < end; k++)
+		{
+			Index col;
+			std::memcpy(&col, colIdx + k * sizeof(Index), sizeof(Index));
+			if (col >= header.ColCount)
+			{
+				throw std::invalid_argument("Snapshot column index is out of bounds");
+			}
+			if (k > begin)
+			{
+				Index previous;
+				std::memcpy(&previous, colIdx + (k - 1) * sizeof(Index), sizeof(Index));
+				if (previous >= col)
+				{
+					throw std::invalid_argument("Snapshot column indices are not ascending");
+				}
+			}
+		}
+	}
+	if (verification == SnapshotVerification::Checksum)
+	{
+		SnapshotChecksum checksum;
+		checksum.Update(data + layout.RowPtrOffset, (header.RowCount + 1) * sizeof(size_t));
+		checksum.Update(data + layout.ColIdxOffset, header.NonZeroElementsCount * sizeof(Index));
+		checksum.Update(data + layout.ValuesOffset, header.NonZeroElementsCount * sizeof(T));
+		if (checksum.GetValue() != header.Checksum)
+		{
+			throw std::invalid_argument("Snapshot checksum doesn't match");
+		}
+	}
+	return layout;
+}
+
+template<typename T>
+constexpr SnapshotValueType BinarySnapshot::ValueTypeOf()
+{
+	static_assert(std::is_arithmetic<T>::value && (sizeof(T) == 4 || sizeof(T) == 8), "Snapshot supports only 32 and 64-bit numbers");
+	if constexpr (std::is_floating_point<T>::value)
+	{
+		return sizeof(T) == 4 ? SnapshotValueType::Float32 : SnapshotValueType::Float64;
+	}
+	else if constexpr (std::is_signed<T>::value)
+	{
+		return sizeof(T) == 4 ? SnapshotValueType::Int32 : SnapshotValueType::Int64;
+	}
+	else
+	{
+		return sizeof(T) == 4 ? SnapshotValueType::UInt32 : SnapshotValueType::UInt64;
+	}
+}
+
+inline SnapshotLayout BinarySnapshot::GetLayout(const SnapshotHeader &header, const size_t valueSize)
+{
+	SnapshotLayout layout;
+	layout.RowPtrOffset = AlignUp(sizeof(SnapshotHeader));
+	layout.ColIdxOffset = AlignUp(layout.RowPtrOffset + (header.RowCount + 1) * header.OffsetWidth);
+	layout.ValuesOffset = AlignUp(layout.ColIdxOffset + header.NonZeroElementsCount * header.IndexWidth);
+	layout.FileSize = layout.ValuesOffset + header.NonZeroElementsCount * valueSize;
+	return layout;
+}
+
+inline size_t BinarySnapshot::AlignUp(const size_t offset)
+{
+	return (offset + Alignment - 1) / Alignment * Alignment;
+}
+
+inline void BinarySnapshot::WritePadding(std::ostream &os, size_t &offset)
+{
+	static constexpr char zeros[Alignment] = {};
+	const auto aligned = AlignUp(offset);
+	os.write(zeros, aligned - offset);
+	offset = aligned;
+}
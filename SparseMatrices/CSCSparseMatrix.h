@@ -0,0 +1,272 @@
+/**
+	Sparse matrix implementation in compressed sparse column (CSC) format
+
+	Author: Belousov K.
+	Repository: https://github.com/kombuchamp/SparseMatrices
+*/
+
+#pragma once
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <ostream>
+#include "ISparseMatrix.h"
+#include "LLSparseMatrix.h"
+#include "CSRSparseMatrix.h"
+#include "ThreadPool.h"
+
+/**
+ * CSC arrays of matrix A are exactly the CSR arrays of its transpose,
+ * so the matrix is stored as CSR representation of A^T.
+ * This makes conversion between CSR of A^T and CSC of A free in both directions.
+ */
+template<typename T = double, typename Index = size_t>
+class CSCSparseMatrix : public ISparseMatrix<T>
+{
+public:
+	CSCSparseMatrix()
+		: CSCSparseMatrix(0, 0)
+	{
+	}
+	CSCSparseMatrix(const size_t rows, const size_t cols)
+		: _transposed(cols, rows)
+	{
+	}
+	explicit CSCSparseMatrix(const CSRSparseMatrix<T, Index> &other, ThreadPool &pool = ThreadPool::Default());
+	template<typename Allocator, typename OtherIndex>
+	explicit CSCSparseMatrix(const LLSparseMatrix<T, Allocator, OtherIndex> &other);
+	[[nodiscard]] static CSCSparseMatrix<T, Index> FromTransposed(CSRSparseMatrix<T, Index> &&transposed);
+	T ElementAt(int row, int col) const override;
+	void Resize(size_t rows, size_t cols) override;
+	void SetElement(int row, int col, T val) override;
+	void RemoveElement(int row, int col) override;
+	void Print(std::ostream &) const override;
+	void Print(std::ostream &, const PrintOptions &options) const override;
+	void Transpose() override;
+	[[nodiscard]] size_t GetNonZeroElementsCount() const override;
+	[[nodiscard]] size_t GetRowCount() const override;
+	[[nodiscard]] size_t GetColCount() const override;
+	[[nodiscard]] CSRSparseMatrix<T, Index> ToCSRSparseMatrix(ThreadPool &pool = ThreadPool::Default()) const;
+	[[nodiscard]] LLSparseMatrix<T, std::allocator<MatrixNode<T>>, Index> ToLLSparseMatrix() const;
+	[[nodiscard]] CSRSparseMatrix<T, Index> ReleaseTransposed();
+	[[nodiscard]] CSCSparseMatrix<T, Index> Add(const CSCSparseMatrix<T, Index> &other) const;
+	[[nodiscard]] CSCSparseMatrix<T, Index> Subtract(const CSCSparseMatrix<T, Index> &other) const;
+	[[nodiscard]] CSCSparseMatrix<T, Index> ScaledAdd(const T &alpha, const T &beta, const CSCSparseMatrix<T, Index> &other) const;
+	[[nodiscard]] CSCSparseMatrix<T, Index> ParallelScaledAdd(const T &alpha, const T &beta, const CSCSparseMatrix<T, Index> &other,
+		ThreadPool &pool = ThreadPool::Default()) const;
+	void Multiply(const T *x, T *y) const;
+	[[nodiscard]] std::vector<T> Multiply(const std::vector<T> &x) const;
+	void MultiplyTransposed(const T *x, T *y) const;
+	[[nodiscard]] const std::vector<size_t> &GetColPointers() const;
+	[[nodiscard]] const std::vector<Index> &GetRowIndices() const;
+	[[nodiscard]] const std::vector<T> &GetValues() const;
+private:
+	CSRSparseMatrix<T, Index> _transposed;
+};
+
+template<typename T, typename Index>
+CSCSparseMatrix<T, Index>::CSCSparseMatrix(const CSRSparseMatrix<T, Index> &other, ThreadPool &pool)
+	: _transposed(other.Transposed(pool))
+{
+}
+
+template<typename T, typename Index>
+template<typename Allocator, typename OtherIndex>
+CSCSparseMatrix<T, Index>::CSCSparseMatrix(const LLSparseMatrix<T, Allocator, OtherIndex> &other)
+	: _transposed(CSRSparseMatrix<T, Index>(other).Transposed())
+{
+}
+
+template<typename T, typename Index>
+CSCSparseMatrix<T, Index> CSCSparseMatrix<T, Index>::FromTransposed(CSRSparseMatrix<T, Index> &&transposed)
+{
+	CSCSparseMatrix<T, Index> result;
+	result._transposed = std::move(transposed);
+	return result;
+}
+
+template<typename T, typename Index>
+CSRSparseMatrix<T, Index> CSCSparseMatrix<T, Index>::ToCSRSparseMatrix(ThreadPool &pool) const
+{
+	return _transposed.Transposed(pool);
+}
+
+template<typename T, typename Index>
+LLSparseMatrix<T, std::allocator<MatrixNode<T>>, Index> CSCSparseMatrix<T, Index>::ToLLSparseMatrix() const
+{
+	return ToCSRSparseMatrix().ToLLSparseMatrix();
+}
+
+/**
+ * Moves out CSR representation of the transposed matrix, leaving this matrix empty
+ */
+template<typename T, typename Index>
+CSRSparseMatrix<T, Index> CSCSparseMatrix<T, Index>::ReleaseTransposed()
+{
+	auto result = std::move(_transposed);
+	_transposed = CSRSparseMatrix<T, Index>();
+	return result;
+}
+
+template<typename T, typename Index>
+CSCSparseMatrix<T, Index> CSCSparseMatrix<T, Index>::Add(const CSCSparseMatrix<T, Index> &other) const
+{
+	return FromTransposed(_transposed.Add(other._transposed));
+}
+
+template<typename T, typename Index>
+CSCSparseMatrix<T, Index> CSCSparseMatrix<T, Index>::Subtract(const CSCSparseMatrix<T, Index> &other) const
+{
+	return FromTransposed(_transposed.Subtract(other._transposed));
+}
+
+/**
+ * alpha * A + beta * B, merged column by column: (alpha * A + beta * B)^T = alpha * A^T + beta * B^T
+ */
+template<typename T, typename Index>
+CSCSparseMatrix<T, Index> CSCSparseMatrix<T, Index>::ScaledAdd(const T &alpha, const T &beta, const CSCSparseMatrix<T, Index> &other) const
+{
+	return FromTransposed(_transposed.ScaledAdd(alpha, beta, other._transposed));
+}
+
+template<typename T, typename Index>
+CSCSparseMatrix<T, Index> CSCSparseMatrix<T, Index>::ParallelScaledAdd(const T &alpha, const T &beta, const CSCSparseMatrix<T, Index> &other,
+	ThreadPool &pool) const
+{
+	return FromTransposed(_transposed.ParallelScaledAdd(alpha, beta, other._transposed, pool));
+}
+
+/**
+ * y = A * x, x should have GetColCount() elements, y - GetRowCount() elements
+ */
+template<typename T, typename Index>
+void CSCSparseMatrix<T, Index>::Multiply(const T *x, T *y) const
+{
+	_transposed.MultiplyTransposed(x, y);
+}
+
+template<typename T, typename Index>
+std::vector<T> CSCSparseMatrix<T, Index>::Multiply(const std::vector<T> &x) const
+{
+	if (x.size() != GetColCount())
+	{
+		throw std::invalid_argument("Invalid argument: vector size doesn't match matrix column count");
+	}
+	std::vector<T> y(GetRowCount());
+	Multiply(x.data(), y.data());
+	return y;
+}
+
+/**
+ * y = A^T * x, x should have GetRowCount() elements, y - GetColCount() elements
+ */
+template<typename T, typename Index>
+void CSCSparseMatrix<T, Index>::MultiplyTransposed(const T *x, T *y) const
+{
+	_transposed.Multiply(x, y);
+}
+
+template<typename T, typename Index>
+T CSCSparseMatrix<T, Index>::ElementAt(int row, int col) const
+{
+	return _transposed.ElementAt(col, row);
+}
+
+template<typename T, typename Index>
+void CSCSparseMatrix<T, Index>::Resize(const size_t rows, const size_t cols)
+{
+	_transposed.Resize(cols, rows);
+}
+
+template<typename T, typename Index>
+void CSCSparseMatrix<T, Index>::SetElement(int row, int col, T val)
+{
+	_transposed.SetElement(col, row, val);
+}
+
+template<typename T, typename Index>
+void CSCSparseMatrix<T, Index>::RemoveElement(int row, int col)
+{
+	_transposed.RemoveElement(col, row);
+}
+
+template<typename T, typename Index>
+void CSCSparseMatrix<T, Index>::Print(std::ostream &os) const
+{
+	Print(os, PrintOptions());
+}
+
+template<typename T, typename Index>
+void CSCSparseMatrix<T, Index>::Print(std::ostream &os, const PrintOptions &options) const
+{
+	if (options.Mode != PrintMode::Preview)
+	{
+		// Elements are stored by columns, row-major order of the other modes needs transposed copy of O(nonzeros) size,
+		// which they write out anyway
+		ToCSRSparseMatrix().Print(os, options);
+		return;
+	}
+	const auto &colPtr = GetColPointers();
+	const auto &rowIdx = GetRowIndices();
+	const auto &values = GetValues();
+	PrintPreview<T>(os, GetRowCount(), GetColCount(), GetNonZeroElementsCount(), options,
+		[&](size_t windowRows, size_t windowCols, auto &&visit)
+		{
+			for (size_t col = 0; col < windowCols; col++)
+			{
+				for (auto k = colPtr[col]; k < colPtr[col + 1] && rowIdx[k] < windowRows; k++)
+				{
+					visit(rowIdx[k], col, values[k]);
+				}
+			}
+		});
+}
+
+template<typename T, typename Index>
+void CSCSparseMatrix<T, Index>::Transpose()
+{
+	_transposed.Transpose();
+}
+
+template<typename T, typename Index>
+size_t CSCSparseMatrix<T, Index>::GetNonZeroElementsCount() const
+{
+	return _transposed.GetNonZeroElementsCount();
+}
+
+template<typename T, typename Index>
+size_t CSCSparseMatrix<T, Index>::GetRowCount() const
+{
+	return _transposed.GetColCount();
+}
+
+template<typename T, typename Index>
+size_t CSCSparseMatrix<T, Index>::GetColCount() const
+{
+	return _transposed.GetRowCount();
+}
+
+template<typename T, typename Index>
+const std::vector<size_t> &CSCSparseMatrix<T, Index>::GetColPointers() const
+{
+	return _transposed.GetRowPointers();
+}
+
+template<typename T, typename Index>
+const std::vector<Index> &CSCSparseMatrix<T, Index>::GetRowIndices() const
+{
+	return _transposed.GetColIndices();
+}
+
+template<typename T, typename Index>
+const std::vector<T> &CSCSparseMatrix<T, Index>::GetValues() const
+{
+	return _transposed.GetValues();
+}
+
+template<typename T, typename Index>
+std::ostream &operator<<(std::ostream &os, const CSCSparseMatrix<T, Index> &mat)
+{
+	mat.Print(os);
+	return os;
+}
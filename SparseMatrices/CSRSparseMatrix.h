@@ -0,0 +1,841 @@
+/**
+	Sparse matrix implementation in compressed sparse row (CSR) format
+
+	Author: Belousov K.
+	Repository: https://github.com/kombuchamp/SparseMatrices
+*/
+
+#pragma once
+#include <stdexcept>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <vector>
+#include <ostream>
+#include <type_traits>
+#include <variant>
+#include "ISparseMatrix.h"
+#include "LLSparseMatrix.h"
+#include "SparseAccumulator.h"
+#include "SparseIndex.h"
+#include "Triplets.h"
+#include "SpMVKernels.h"
+#include "ThreadPool.h"
+
+/**
+ * Column indices are stored as Index (uint16_t, uint32_t or uint64_t), which should fit
+ * both dimensions so that the matrix can be transposed in place. Row pointers are offsets into
+ * nonzero elements and always stay size_t.
+ */
+template<typename T = double, typename Index = size_t>
+class CSRSparseMatrix : public ISparseMatrix<T>
+{
+public:
+	using MultiplyWorkspace = ProductWorkspace<T>;
+
+	CSRSparseMatrix()
+		: CSRSparseMatrix(0, 0)
+	{
+	}
+	CSRSparseMatrix(const size_t rows, const size_t cols)
+		: _rowCount(rows), _colCount(cols)
+	{
+		static_assert(std::is_default_constructible<T>::value, "Template type T should have default constructor");
+		ThrowIfIndexOverflows<Index>(_rowCount, _colCount);
+		_rowPtr.assign(_rowCount + 1, 0);
+	}
+	template<typename Allocator, typename OtherIndex>
+	explicit CSRSparseMatrix(const LLSparseMatrix<T, Allocator, OtherIndex> &other);
+	template<typename OtherIndex>
+	explicit CSRSparseMatrix(const CSRSparseMatrix<T, OtherIndex> &other);
+	template<typename Iterator>
+	[[nodiscard]] static CSRSparseMatrix<T, Index> FromTriplets(size_t rows, size_t cols, Iterator first, Iterator last,
+		TripletOrder order = TripletOrder::Unsorted, DuplicatePolicy policy = DuplicatePolicy::Sum, ThreadPool &pool = ThreadPool::Default());
+	T ElementAt(int row, int col) const override;
+	void Resize(size_t rows, size_t cols) override;
+	void SetElement(int row, int col, T val) override;
+	void RemoveElement(int row, int col) override;
+	void Print(std::ostream &) const override;
+	void Print(std::ostream &, const PrintOptions &options) const override;
+	void Transpose() override;
+	[[nodiscard]] CSRSparseMatrix<T, Index> Transposed(ThreadPool &pool = ThreadPool::Default()) const;
+	[[nodiscard]] size_t GetNonZeroElementsCount() const override;
+	[[nodiscard]] size_t GetRowCount() const override;
+	[[nodiscard]] size_t GetColCount() const override;
+	[[nodiscard]] LLSparseMatrix<T, std::allocator<MatrixNode<T>>, Index> ToLLSparseMatrix() const;
+	[[nodiscard]] CSRSparseMatrix<T, Index> Add(const CSRSparseMatrix<T, Index> &other) const;
+	[[nodiscard]] CSRSparseMatrix<T, Index> Subtract(const CSRSparseMatrix<T, Index> &other) const;
+	[[nodiscard]] CSRSparseMatrix<T, Index> ScaledAdd(const T &alpha, const T &beta, const CSRSparseMatrix<T, Index> &other) const;
+	[[nodiscard]] CSRSparseMatrix<T, Index> ParallelScaledAdd(const T &alpha, const T &beta, const CSRSparseMatrix<T, Index> &other,
+		ThreadPool &pool = ThreadPool::Default()) const;
+	[[nodiscard]] CSRSparseMatrix<T, Index> Multiply(const CSRSparseMatrix<T, Index> &other) const;
+	[[nodiscard]] CSRSparseMatrix<T, Index> ParallelMultiply(const CSRSparseMatrix<T, Index> &other, ThreadPool &pool = ThreadPool::Default()) const;
+	void Multiply(const T *x, T *y) const;
+	[[nodiscard]] std::vector<T> Multiply(const std::vector<T> &x) const;
+	void ParallelMultiply(const T *x, T *y, ThreadPool &pool = ThreadPool::Default()) const;
+	void MultiplyTransposed(const T *x, T *y) const;
+	void MultiplyDenseBlock(const T *x, size_t vectorCount, T *y) const;
+	void ParallelMultiplyDenseBlock(const T *x, size_t vectorCount, T *y, ThreadPool &pool = ThreadPool::Default()) const;
+	[[nodiscard]] const std::vector<size_t> &GetRowPointers() const;
+	[[nodiscard]] const std::vector<Index> &GetColIndices() const;
+	[[nodiscard]] const std::vector<T> &GetValues() const;
+private:
+	template<typename, typename> friend class CSRSparseMatrix;
+	template<typename, typename> friend class DOKSparseMatrix;
+	template<typename, typename> friend class MappedCSRSparseMatrix;
+	template<typename, typename> friend class AlgebraicMultigrid;
+	friend class MatrixMarket;
+	template<typename U, typename OtherIndex>
+	friend void MultiplyInto(CSRSparseMatrix<U, OtherIndex> &result, const CSRSparseMatrix<U, OtherIndex> &a,
+		const CSRSparseMatrix<U, OtherIndex> &b, ProductWorkspace<U> &workspace);
+	[[nodiscard]] static CSRSparseMatrix<T, Index> FromSortedKeys(size_t rows, size_t cols, const std::vector<KeyedValue<T>> &items);
+	template<typename Emit>
+	void MergeRow(size_t row, const T &alpha, const T &beta, const CSRSparseMatrix<T, Index> &other, Emit &&emit) const;
+	[[nodiscard]] bool InBoundaries(size_t row, size_t col) const;
+	[[nodiscard]] size_t LowerBoundInRow(size_t row, size_t col) const;
+	size_t _rowCount;
+	size_t _colCount;
+	/**
+	 * Elements of row i are stored at positions [_rowPtr[i], _rowPtr[i + 1])
+	 * of _colIdx and _values, sorted by column index
+	 */
+	std::vector<size_t> _rowPtr;
+	std::vector<Index> _colIdx;
+	std::vector<T> _values;
+};
+
+template<typename T>
+using AnyIndexCSRSparseMatrix = std::variant<CSRSparseMatrix<T, uint16_t>, CSRSparseMatrix<T, uint32_t>, CSRSparseMatrix<T, uint64_t>>;
+
+template<typename T, typename Index>
+template<typename Allocator, typename OtherIndex>
+CSRSparseMatrix<T, Index>::CSRSparseMatrix(const LLSparseMatrix<T, Allocator, OtherIndex> &other)
+	: CSRSparseMatrix(other._rowCount, other._colCount)
+{
+	_colIdx.reserve(other._nonZeroElements.size());
+	_values.reserve(other._nonZeroElements.size());
+
+	// Linked list is kept sorted in row-major order, so elements can be appended as is
+	for (auto &elem : other._nonZeroElements)
+	{
+		++_rowPtr[elem.Row + 1];
+		_colIdx.push_back(static_cast<Index>(elem.Col));
+		_values.push_back(elem.Value);
+	}
+	for (size_t i = 0; i < _rowCount; i++)
+	{
+		_rowPtr[i + 1] += _rowPtr[i];
+	}
+}
+
+/**
+ * Copies matrix changing type of column indices, throws if its size doesn't fit new type
+ */
+template<typename T, typename Index>
+template<typename OtherIndex>
+CSRSparseMatrix<T, Index>::CSRSparseMatrix(const CSRSparseMatrix<T, OtherIndex> &other)
+	: CSRSparseMatrix(other._rowCount, other._colCount)
+{
+	_rowPtr = other._rowPtr;
+	_colIdx.assign(other._colIdx.begin(), other._colIdx.end());
+	_values = other._values;
+}
+
+/**
+ * Builds matrix from (row, col, value) triplets, see SortTriplets
+ */
+template<typename T, typename Index>
+template<typename Iterator>
+CSRSparseMatrix<T, Index> CSRSparseMatrix<T, Index>::FromTriplets(const size_t rows, const size_t cols, Iterator first, Iterator last,
+	const TripletOrder order, const DuplicatePolicy policy, ThreadPool &pool)
+{
+	return FromSortedKeys(rows, cols, SortTriplets<T>(rows, cols, first, last, order, policy, pool));
+}
+
+/**
+ * Builds matrix from nonzero elements keyed by LinearPosition, sorted and unique
+ */
+template<typename T, typename Index>
+CSRSparseMatrix<T, Index> CSRSparseMatrix<T, Index>::FromSortedKeys(const size_t rows, const size_t cols, const std::vector<KeyedValue<T>> &items)
+{
+	CSRSparseMatrix<T, Index> result(rows, cols);
+	result._colIdx.resize(items.size());
+	result._values.resize(items.size());
+	for (size_t k = 0; k < items.size(); k++)
+	{
+		++result._rowPtr[items[k].Key / cols + 1];
+		result._colIdx[k] = static_cast<Index>(items[k].Key % cols);
+		result._values[k] = items[k].Value;
+	}
+	for (size_t i = 0; i < rows; i++)
+	{
+		result._rowPtr[i + 1] += result._rowPtr[i];
+	}
+	return result;
+}
+
+template<typename T, typename Index>
+LLSparseMatrix<T, std::allocator<MatrixNode<T>>, Index> CSRSparseMatrix<T, Index>::ToLLSparseMatrix() const
+{
+	LLSparseMatrix<T, std::allocator<MatrixNode<T>>, Index> result(_rowCount, _colCount);
+	for (size_t i = 0; i < _rowCount; i++)
+	{
+		for (auto k = _rowPtr[i]; k < _rowPtr[i + 1]; k++)
+		{
+			result._nonZeroElements.emplace_back(i, _colIdx[k], _values[k]);
+		}
+	}
+	return result;
+}
+
+template<typename T, typename Index>
+void CSRSparseMatrix<T, Index>::Resize(const size_t rows, const size_t cols)
+{
+	if (rows < _rowCount || cols < _colCount)
+	{
+		throw std::invalid_argument("Can't reduce matrix size");
+	}
+	ThrowIfIndexOverflows<Index>(rows, cols);
+	_rowPtr.resize(rows + 1, _rowPtr.back());
+	_rowCount = rows;
+	_colCount = cols;
+}
+
+template<typename T, typename Index>
+T CSRSparseMatrix<T, Index>::ElementAt(int row, int col) const
+{
+	if (!InBoundaries(row, col))
+	{
+		throw std::invalid_argument("Element indices are out of bounds");
+	}
+	const auto pos = LowerBoundInRow(row, col);
+	if (pos != _rowPtr[row + 1] && _colIdx[pos] == static_cast<Index>(col))
+	{
+		return _values[pos];
+	}
+	return T();
+}
+
+template<typename T, typename Index>
+void CSRSparseMatrix<T, Index>::SetElement(int row, int col, T val)
+{
+	if (!InBoundaries(row, col))
+	{
+		throw std::invalid_argument("Element indices are out of bounds");
+	}
+	if (val == T())
+	{
+		RemoveElement(row, col);
+		return;
+	}
+	const auto pos = LowerBoundInRow(row, col);
+	if (pos != _rowPtr[row + 1] && _colIdx[pos] == static_cast<Index>(col))
+	{
+		_values[pos] = val;
+		return;
+	}
+	_colIdx.insert(_colIdx.begin() + pos, static_cast<Index>(col));
+	_values.insert(_values.begin() + pos, val);
+	for (auto i = static_cast<size_t>(row) + 1; i <= _rowCount; i++)
+	{
+		++_rowPtr[i];
+	}
+}
+
+template<typename T, typename Index>
+void CSRSparseMatrix<T, Index>::RemoveElement(int row, int col)
+{
+	if (!InBoundaries(row, col))
+	{
+		throw std::invalid_argument("Element indices are out of bounds");
+	}
+	const auto pos = LowerBoundInRow(row, col);
+	if (pos == _rowPtr[row + 1] || _colIdx[pos] != static_cast<Index>(col))
+	{
+		return;
+	}
+	_colIdx.erase(_colIdx.begin() + pos);
+	_values.erase(_values.begin() + pos);
+	for (auto i = static_cast<size_t>(row) + 1; i <= _rowCount; i++)
+	{
+		--_rowPtr[i];
+	}
+}
+
+template<typename T, typename Index>
+void CSRSparseMatrix<T, Index>::Print(std::ostream &os) const
+{
+	Print(os, PrintOptions());
+}
+
+template<typename T, typename Index>
+void CSRSparseMatrix<T, Index>::Print(std::ostream &os, const PrintOptions &options) const
+{
+	PrintSparse<T>(os, _rowCount, _colCount, _values.size(), options,
+		[&](auto &&visit)
+		{
+			for (size_t i = 0; i < _rowCount; i++)
+			{
+				for (auto k = _rowPtr[i]; k < _rowPtr[i + 1]; k++)
+				{
+					if (!visit(i, _colIdx[k], _values[k]))
+					{
+						return;
+					}
+				}
+			}
+		});
+}
+
+template<typename T, typename Index>
+void CSRSparseMatrix<T, Index>::Transpose()
+{
+	*this = Transposed();
+}
+
+/**
+ * Returns A^T by counting sort of elements by column, O(nnz + cols) work, source is only read.
+ * Rows are split into blocks with equal number of nonzero elements, every block counts its own
+ * column histogram, so column j of block b starts right after column j of blocks 0..b-1
+ * and all blocks scatter in parallel without synchronization. Row indices of every new row come out sorted.
+ * Number of blocks is limited so that histograms take no more memory than the matrix itself.
+ */
+template<typename T, typename Index>
+CSRSparseMatrix<T, Index> CSRSparseMatrix<T, Index>::Transposed(ThreadPool &pool) const
+{
+	constexpr size_t MinBlockNonZeros = 1 << 14;
+	const auto nonZeros = _values.size();
+	const auto blockCount = std::max<size_t>(1, std::min({ pool.GetThreadCount(), nonZeros / MinBlockNonZeros, nonZeros / (_colCount + 1) }));
+	const auto blockBegin = PartitionRowsByNonZeros(_rowPtr.data(), _rowCount, blockCount);
+
+	CSRSparseMatrix<T, Index> result(_colCount, _rowCount);
+	result._colIdx.resize(nonZeros);
+	result._values.resize(nonZeros);
+	std::vector<std::vector<size_t>> next(blockCount);
+	pool.ParallelFor(blockCount,
+		[&](size_t block, size_t)
+		{
+			auto &histogram = next[block];
+			histogram.assign(_colCount, 0);
+			for (auto k = _rowPtr[blockBegin[block]]; k < _rowPtr[blockBegin[block + 1]]; k++)
+			{
+				++histogram[_colIdx[k]];
+			}
+		});
+
+	auto &rowPtr = result._rowPtr;
+	pool.ParallelForRange(_colCount,
+		[&](size_t begin, size_t end, size_t)
+		{
+			for (auto j = begin; j < end; j++)
+			{
+				size_t count = 0;
+				for (auto &histogram : next)
+				{
+					count += histogram[j];
+				}
+				rowPtr[j + 1] = count;
+			}
+		});
+	std::partial_sum(rowPtr.begin(), rowPtr.end(), rowPtr.begin());
+	pool.ParallelForRange(_colCount,
+		[&](size_t begin, size_t end, size_t)
+		{
+			for (auto j = begin; j < end; j++)
+			{
+				auto offset = rowPtr[j];
+				for (auto &histogram : next)
+				{
+					const auto count = histogram[j];
+					histogram[j] = offset;
+					offset += count;
+				}
+			}
+		});
+
+	pool.ParallelFor(blockCount,
+		[&](size_t block, size_t)
+		{
+			auto &blockNext = next[block];
+			for (auto i = blockBegin[block]; i < blockBegin[block + 1]; i++)
+			{
+				for (auto k = _rowPtr[i]; k < _rowPtr[i + 1]; k++)
+				{
+					const auto dest = blockNext[_colIdx[k]]++;
+					result._colIdx[dest] = static_cast<Index>(i);
+					result._values[dest] = _values[k];
+				}
+			}
+		});
+	return result;
+}
+
+template<typename T, typename Index>
+CSRSparseMatrix<T, Index> CSRSparseMatrix<T, Index>::Add(const CSRSparseMatrix<T, Index> &other) const
+{
+	return ScaledAdd(T(1), T(1), other);
+}
+
+template<typename T, typename Index>
+CSRSparseMatrix<T, Index> CSRSparseMatrix<T, Index>::Subtract(const CSRSparseMatrix<T, Index> &other) const
+{
+	return ScaledAdd(T(1), T(-1), other);
+}
+
+/**
+ * alpha * A + beta * B, rows of both matrices are merged by column index in O(nnz(A) + nnz(B)).
+ * Elements that cancel out to zero are not stored.
+ */
+template<typename T, typename Index>
+CSRSparseMatrix<T, Index> CSRSparseMatrix<T, Index>::ScaledAdd(const T &alpha, const T &beta, const CSRSparseMatrix<T, Index> &other) const
+{
+	if (_rowCount != other._rowCount || _colCount != other._colCount)
+	{
+		throw std::invalid_argument("Invalid argument: impossible to add matrices of different sizes");
+	}
+
+	CSRSparseMatrix<T, Index> result(_rowCount, _colCount);
+	result._colIdx.reserve(_values.size() + other._values.size());
+	result._values.reserve(_values.size() + other._values.size());
+	for (size_t i = 0; i < _rowCount; i++)
+	{
+		MergeRow(i, alpha, beta, other,
+			[&](Index j, const T &value)
+			{
+				result._colIdx.push_back(j);
+				result._values.push_back(value);
+			});
+		result._rowPtr[i + 1] = result._values.size();
+	}
+	return result;
+}
+
+/**
+ * Same sum computed in two passes over row ranges: the first one counts nonzeros of every result row,
+ * so result arrays are allocated once with exact size, the second one merges rows again writing them in place.
+ */
+template<typename T, typename Index>
+CSRSparseMatrix<T, Index> CSRSparseMatrix<T, Index>::ParallelScaledAdd(const T &alpha, const T &beta, const CSRSparseMatrix<T, Index> &other,
+	ThreadPool &pool) const
+{
+	if (_rowCount != other._rowCount || _colCount != other._colCount)
+	{
+		throw std::invalid_argument("Invalid argument: impossible to add matrices of different sizes");
+	}
+
+	CSRSparseMatrix<T, Index> result(_rowCount, _colCount);
+	auto &rowPtr = result._rowPtr;
+	pool.ParallelForRange(_rowCount,
+		[&](size_t begin, size_t end, size_t)
+		{
+			for (auto i = begin; i < end; i++)
+			{
+				size_t count = 0;
+				MergeRow(i, alpha, beta, other,
+					[&](Index, const T &)
+					{
+						++count;
+					});
+				rowPtr[i + 1] = count;
+			}
+		}, 256);
+	std::partial_sum(rowPtr.begin(), rowPtr.end(), rowPtr.begin());
+
+	result._colIdx.resize(rowPtr.back());
+	result._values.resize(rowPtr.back());
+	pool.ParallelForRange(_rowCount,
+		[&](size_t begin, size_t end, size_t)
+		{
+			for (auto i = begin; i < end; i++)
+			{
+				auto dest = rowPtr[i];
+				MergeRow(i, alpha, beta, other,
+					[&](Index j, const T &value)
+					{
+						result._colIdx[dest] = j;
+						result._values[dest] = value;
+						++dest;
+					});
+			}
+		}, 256);
+	return result;
+}
+
+template<typename T, typename Index>
+CSRSparseMatrix<T, Index> CSRSparseMatrix<T, Index>::Multiply(const CSRSparseMatrix<T, Index> &other) const
+{
+	CSRSparseMatrix<T, Index> result;
+	MultiplyInto(result, *this, other);
+	return result;
+}
+
+/**
+ * Same product computed in two passes over row blocks:
+ * symbolic pass counts nonzeros of every result row, so result arrays are allocated once with exact size,
+ * numeric pass fills rows in place with thread-local accumulators.
+ * Row blocks are cut to hold equal number of multiplications rather than equal number of rows,
+ * so a few heavy rows of a power-law matrix don't leave the rest of the threads idle.
+ */
+template<typename T, typename Index>
+CSRSparseMatrix<T, Index> CSRSparseMatrix<T, Index>::ParallelMultiply(const CSRSparseMatrix<T, Index> &other, ThreadPool &pool) const
+{
+	if (_colCount != other._rowCount)
+	{
+		throw std::invalid_argument("Invalid argument: impossible to multiply incompatible matrices");
+	}
+
+	CSRSparseMatrix<T, Index> result(_rowCount, other._colCount);
+	if (_rowCount == 0)
+	{
+		return result;
+	}
+
+	// Estimate multiplications per row, then split rows into blocks of equal work
+	std::vector<size_t> flops(_rowCount + 1, 0);
+	pool.ParallelForRange(_rowCount,
+		[&](size_t begin, size_t end, size_t)
+		{
+			for (auto i = begin; i < end; i++)
+			{
+				size_t rowFlops = 1;
+				for (auto k = _rowPtr[i]; k < _rowPtr[i + 1]; k++)
+				{
+					rowFlops += other._rowPtr[_colIdx[k] + 1] - other._rowPtr[_colIdx[k]];
+				}
+				flops[i + 1] = rowFlops;
+			}
+		});
+	std::partial_sum(flops.begin(), flops.end(), flops.begin());
+
+	const auto blockCount = std::min(_rowCount, 8 * pool.GetThreadCount());
+	std::vector<size_t> blockBegin(blockCount + 1, _rowCount);
+	blockBegin[0] = 0;
+	for (size_t b = 1; b < blockCount; b++)
+	{
+		const auto target = flops.back() / blockCount * b;
+		blockBegin[b] = std::lower_bound(flops.begin() + blockBegin[b - 1], flops.end() - 1, target) - flops.begin();
+	}
+
+	// Symbolic pass: number of distinct columns in every result row
+	auto &rowPtr = result._rowPtr;
+	std::vector<std::vector<size_t>> marks(pool.GetThreadCount());
+	pool.ParallelFor(blockCount,
+		[&](size_t block, size_t threadIndex)
+		{
+			auto &mark = marks[threadIndex];
+			if (mark.empty())
+			{
+				mark.assign(other._colCount, _rowCount);
+			}
+			for (auto i = blockBegin[block]; i < blockBegin[block + 1]; i++)
+			{
+				size_t count = 0;
+				for (auto k = _rowPtr[i]; k < _rowPtr[i + 1]; k++)
+				{
+					const auto otherRow = _colIdx[k];
+					for (auto l = other._rowPtr[otherRow]; l < other._rowPtr[otherRow + 1]; l++)
+					{
+						if (mark[other._colIdx[l]] != i)
+						{
+							mark[other._colIdx[l]] = i;
+							++count;
+						}
+					}
+				}
+				rowPtr[i + 1] = count;
+			}
+		});
+	marks.clear();
+	std::partial_sum(rowPtr.begin(), rowPtr.end(), rowPtr.begin());
+
+	// Numeric pass: every row is written into its own preallocated slot.
+	// Entries cancelled out to zero are dropped, so a row may come out shorter than its slot.
+	result._colIdx.resize(rowPtr.back());
+	result._values.resize(rowPtr.back());
+	std::vector<size_t> rowLength(_rowCount);
+	std::vector<std::unique_ptr<SparseAccumulator<T>>> accumulators(pool.GetThreadCount());
+	pool.ParallelFor(blockCount,
+		[&](size_t block, size_t threadIndex)
+		{
+			auto &accumulator = accumulators[threadIndex];
+			if (!accumulator)
+			{
+				accumulator = std::make_unique<SparseAccumulator<T>>(other._colCount);
+			}
+			for (auto i = blockBegin[block]; i < blockBegin[block + 1]; i++)
+			{
+				for (auto k = _rowPtr[i]; k < _rowPtr[i + 1]; k++)
+				{
+					const auto otherRow = _colIdx[k];
+					for (auto l = other._rowPtr[otherRow]; l < other._rowPtr[otherRow + 1]; l++)
+					{
+						accumulator->Accumulate(other._colIdx[l], _values[k] * other._values[l]);
+					}
+				}
+				auto dest = rowPtr[i];
+				accumulator->Flush(
+					[&](auto j, auto &value)
+					{
+						result._colIdx[dest] = static_cast<Index>(j);
+						result._values[dest] = value;
+						++dest;
+					});
+				rowLength[i] = dest - rowPtr[i];
+			}
+		});
+	accumulators.clear();
+
+	// Close gaps left by cancelled entries
+	if (std::accumulate(rowLength.begin(), rowLength.end(), size_t(0)) != rowPtr.back())
+	{
+		size_t dest = 0;
+		for (size_t i = 0; i < _rowCount; i++)
+		{
+			const auto begin = rowPtr[i];
+			rowPtr[i] = dest;
+			for (auto k = begin; k < begin + rowLength[i]; k++, dest++)
+			{
+				result._colIdx[dest] = result._colIdx[k];
+				result._values[dest] = result._values[k];
+			}
+		}
+		rowPtr[_rowCount] = dest;
+		result._colIdx.resize(dest);
+		result._values.resize(dest);
+	}
+	return result;
+}
+
+/**
+ * y = A * x, x should have GetColCount() elements, y - GetRowCount() elements
+ */
+template<typename T, typename Index>
+void CSRSparseMatrix<T, Index>::Multiply(const T *x, T *y) const
+{
+	MultiplyRowsByVector(_rowPtr.data(), _colIdx.data(), _values.data(), x, y, 0, _rowCount);
+}
+
+template<typename T, typename Index>
+std::vector<T> CSRSparseMatrix<T, Index>::Multiply(const std::vector<T> &x) const
+{
+	if (x.size() != _colCount)
+	{
+		throw std::invalid_argument("Invalid argument: vector size doesn't match matrix column count");
+	}
+	std::vector<T> y(_rowCount);
+	Multiply(x.data(), y.data());
+	return y;
+}
+
+/**
+ * Same as Multiply(x, y), rows are split between threads into blocks with equal number of nonzero elements
+ */
+template<typename T, typename Index>
+void CSRSparseMatrix<T, Index>::ParallelMultiply(const T *x, T *y, ThreadPool &pool) const
+{
+	const auto boundaries = PartitionRowsByNonZeros(_rowPtr.data(), _rowCount, 4 * pool.GetThreadCount());
+	pool.ParallelFor(boundaries.size() - 1,
+		[&](size_t block, size_t)
+		{
+			MultiplyRowsByVector(_rowPtr.data(), _colIdx.data(), _values.data(), x, y, boundaries[block], boundaries[block + 1]);
+		});
+}
+
+/**
+ * y = A^T * x, x should have GetRowCount() elements, y - GetColCount() elements
+ */
+template<typename T, typename Index>
+void CSRSparseMatrix<T, Index>::MultiplyTransposed(const T *x, T *y) const
+{
+	MultiplyColumnsByVector(_rowPtr.data(), _colIdx.data(), _values.data(), x, y, _rowCount, _colCount);
+}
+
+/**
+ * Y = A * X for vectorCount vectors at once.
+ * X is GetColCount() x vectorCount, Y is GetRowCount() x vectorCount, both dense and row-major.
+ */
+template<typename T, typename Index>
+void CSRSparseMatrix<T, Index>::MultiplyDenseBlock(const T *x, const size_t vectorCount, T *y) const
+{
+	MultiplyRowsByDenseBlock(_rowPtr.data(), _colIdx.data(), _values.data(), x, vectorCount, y, 0, _rowCount);
+}
+
+template<typename T, typename Index>
+void CSRSparseMatrix<T, Index>::ParallelMultiplyDenseBlock(const T *x, const size_t vectorCount, T *y, ThreadPool &pool) const
+{
+	const auto boundaries = PartitionRowsByNonZeros(_rowPtr.data(), _rowCount, 4 * pool.GetThreadCount());
+	pool.ParallelFor(boundaries.size() - 1,
+		[&](size_t block, size_t)
+		{
+			MultiplyRowsByDenseBlock(_rowPtr.data(), _colIdx.data(), _values.data(), x, vectorCount, y, boundaries[block], boundaries[block + 1]);
+		});
+}
+
+template<typename T, typename Index>
+size_t CSRSparseMatrix<T, Index>::GetNonZeroElementsCount() const
+{
+	return _values.size();
+}
+
+template<typename T, typename Index>
+size_t CSRSparseMatrix<T, Index>::GetRowCount() const
+{
+	return _rowCount;
+}
+
+template<typename T, typename Index>
+size_t CSRSparseMatrix<T, Index>::GetColCount() const
+{
+	return _colCount;
+}
+
+template<typename T, typename Index>
+const std::vector<size_t> &CSRSparseMatrix<T, Index>::GetRowPointers() const
+{
+	return _rowPtr;
+}
+
+template<typename T, typename Index>
+const std::vector<Index> &CSRSparseMatrix<T, Index>::GetColIndices() const
+{
+	return _colIdx;
+}
+
+template<typename T, typename Index>
+const std::vector<T> &CSRSparseMatrix<T, Index>::GetValues() const
+{
+	return _values;
+}
+
+/**
+ * Passes nonzero elements of row of alpha * A + beta * B to emit(col, value) in ascending column order
+ */
+template<typename T, typename Index>
+template<typename Emit>
+void CSRSparseMatrix<T, Index>::MergeRow(const size_t row, const T &alpha, const T &beta, const CSRSparseMatrix<T, Index> &other, Emit &&emit) const
+{
+	auto k = _rowPtr[row];
+	auto l = other._rowPtr[row];
+	const auto end = _rowPtr[row + 1];
+	const auto otherEnd = other._rowPtr[row + 1];
+	while (k < end || l < otherEnd)
+	{
+		Index col;
+		T value;
+		if (l == otherEnd || (k < end && _colIdx[k] < other._colIdx[l]))
+		{
+			col = _colIdx[k];
+			value = alpha * _values[k++];
+		}
+		else if (k == end || other._colIdx[l] < _colIdx[k])
+		{
+			col = other._colIdx[l];
+			value = beta * other._values[l++];
+		}
+		else
+		{
+			col = _colIdx[k];
+			value = alpha * _values[k++] + beta * other._values[l++];
+		}
+		if (value != T())
+		{
+			emit(col, value);
+		}
+	}
+}
+
+template<typename T, typename Index>
+bool CSRSparseMatrix<T, Index>::InBoundaries(const size_t row, const size_t col) const
+{
+	return row < _rowCount && col < _colCount;
+}
+
+template<typename T, typename Index>
+size_t CSRSparseMatrix<T, Index>::LowerBoundInRow(const size_t row, const size_t col) const
+{
+	const auto rowBegin = _colIdx.begin() + _rowPtr[row];
+	const auto rowEnd = _colIdx.begin() + _rowPtr[row + 1];
+	return std::lower_bound(rowBegin, rowEnd, static_cast<Index>(col)) - _colIdx.begin();
+}
+
+template<typename T, typename Index>
+std::ostream &operator<<(std::ostream &os, const CSRSparseMatrix<T, Index> &mat)
+{
+	mat.Print(os);
+	return os;
+}
+
+/**
+ * Copies matrix into CSR with the narrowest index type its size fits
+ */
+template<typename T, typename Index>
+AnyIndexCSRSparseMatrix<T> ToNarrowestIndex(const CSRSparseMatrix<T, Index> &matrix)
+{
+	const auto rows = matrix.GetRowCount();
+	const auto cols = matrix.GetColCount();
+	if (FitsIndex<uint16_t>(rows, cols))
+	{
+		return CSRSparseMatrix<T, uint16_t>(matrix);
+	}
+	if (FitsIndex<uint32_t>(rows, cols))
+	{
+		return CSRSparseMatrix<T, uint32_t>(matrix);
+	}
+	return CSRSparseMatrix<T, uint64_t>(matrix);
+}
+
+
+/**
+ * result = a * b (Gustavson's algorithm): i-th row of result is accumulated
+ * as a sum of rows of b weighted by a[i, k] and appended already sorted.
+ * Arrays of result are overwritten without giving up their capacity,
+ * so in a loop with the same workspace only the first products allocate.
+ */
+template<typename T, typename Index>
+void MultiplyInto(CSRSparseMatrix<T, Index> &result, const CSRSparseMatrix<T, Index> &a, const CSRSparseMatrix<T, Index> &b,
+	ProductWorkspace<T> &workspace)
+{
+	if (a._colCount != b._rowCount)
+	{
+		throw std::invalid_argument("Invalid argument: impossible to multiply incompatible matrices");
+	}
+	if (&result == &a || &result == &b)
+	{
+		result = a.Multiply(b);
+		return;
+	}
+
+	result._rowCount = a._rowCount;
+	result._colCount = b._colCount;
+	result._rowPtr.assign(a._rowCount + 1, 0);
+	result._colIdx.clear();
+	result._values.clear();
+	auto &accumulator = workspace.Accumulator;
+	accumulator.Reserve(b._colCount);
+	for (size_t i = 0; i < a._rowCount; i++)
+	{
+		for (auto k = a._rowPtr[i]; k < a._rowPtr[i + 1]; k++)
+		{
+			const auto bRow = a._colIdx[k];
+			for (auto l = b._rowPtr[bRow]; l < b._rowPtr[bRow + 1]; l++)
+			{
+				accumulator.Accumulate(b._colIdx[l], a._values[k] * b._values[l]);
+			}
+		}
+		accumulator.Flush(
+			[&](auto j, auto &value)
+			{
+				result._colIdx.push_back(static_cast<Index>(j));
+				result._values.push_back(value);
+			});
+		result._rowPtr[i + 1] = result._values.size();
+	}
+}
+
+template<typename T, typename Index>
+void MultiplyInto(CSRSparseMatrix<T, Index> &result, const CSRSparseMatrix<T, Index> &a, const CSRSparseMatrix<T, Index> &b)
+{
+	ProductWorkspace<T> workspace;
+	MultiplyInto(result, a, b, workspace);
+}
\ No newline at end of file
@@ -0,0 +1,155 @@
+/**
+	Preconditioned conjugate gradient solver
+
+	Author: Belousov K.
+	Repository: https://github.com/kombuchamp/SparseMatrices
+*/
+
+#pragma once
+#include <stdexcept>
+#include <cmath>
+#include <utility>
+#include <vector>
+#include "IterativeSolver.h"
+#include "ThreadPool.h"
+#include "VectorKernels.h"
+
+/**
+ * Solves A x = b for symmetric positive definite A. Matrix may be any type with Multiply(x, y),
+ * CSR matrices are multiplied by all threads of the pool together with the dot product that follows.
+ * Every iteration makes one product, one preconditioner application and three passes over vectors:
+ * SpMV fused with p . Ap, update of x and r fused with r . r, and p = z + beta p.
+ * Work vectors are kept between solves, so a solver reused for systems of the same size allocates nothing.
+ */
+template<typename T = double>
+class ConjugateGradient
+{
+public:
+	explicit ConjugateGradient(const SolverOptions &options = SolverOptions(), ThreadPool &pool = ThreadPool::Default())
+		: _options(options), _kernels(pool)
+	{
+	}
+	template<typename Matrix, typename Preconditioner = IdentityPreconditioner>
+	SolverResult Solve(const Matrix &matrix, const T *b, T *x, Preconditioner &&preconditioner = Preconditioner());
+	template<typename Matrix, typename Preconditioner = IdentityPreconditioner>
+	SolverResult Solve(const Matrix &matrix, const std::vector<T> &b, std::vector<T> &x, Preconditioner &&preconditioner = Preconditioner());
+	[[nodiscard]] const SolverOptions &GetOptions() const;
+	void SetOptions(const SolverOptions &options);
+private:
+	void Resize(size_t size);
+	SolverOptions _options;
+	VectorKernels<T> _kernels;
+	std::vector<T> _r;
+	std::vector<T> _z;
+	std::vector<T> _p;
+	std::vector<T> _q;
+};
+
+/**
+ * x holds initial guess on input and solution on output
+ */
+template<typename T>
+template<typename Matrix, typename Preconditioner>
+SolverResult ConjugateGradient<T>::Solve(const Matrix &matrix, const T *b, T *x, Preconditioner &&preconditioner)
+{
+	constexpr auto unpreconditioned = IsIdentityPreconditioner<Preconditioner>();
+	const auto n = GetSystemSize(matrix);
+	Resize(n);
+	SolverResult result;
+	if (_options.RecordResidualHistory)
+	{
+		result.ResidualHistory.reserve(_options.MaxIterations + 1);
+	}
+
+	const auto record = [&](T rr)
+	{
+		result.ResidualNorm = std::sqrt(static_cast<double>(rr));
+		if (_options.RecordResidualHistory)
+		{
+			result.ResidualHistory.push_back(result.ResidualNorm);
+		}
+	};
+	const auto threshold = _options.RelativeTolerance * _kernels.Norm(b);
+
+	auto *r = _r.data();
+	auto *z = unpreconditioned ? r : _z.data();
+	auto *p = _p.data();
+	auto *q = _q.data();
+	_kernels.Multiply(matrix, x, q);
+	auto rr = _kernels.Residual(b, q, r);
+	record(rr);
+	if (result.ResidualNorm <= threshold)
+	{
+		result.Converged = true;
+		return result;
+	}
+	if constexpr (!unpreconditioned)
+	{
+		preconditioner.Apply(r, z);
+	}
+	auto rz = unpreconditioned ? rr : _kernels.Dot(r, z);
+	_kernels.Copy(z, p);
+
+	while (result.Iterations < _options.MaxIterations)
+	{
+		const auto pq = _kernels.MultiplyDot(matrix, p, q);
+		if (!(pq > T()))
+		{
+			// A isn't positive definite on p, or the residual has already vanished
+			break;
+		}
+		const auto alpha = rz / pq;
+		rr = _kernels.UpdateSolution(alpha, p, q, x, r);
+		++result.Iterations;
+		record(rr);
+		if (result.ResidualNorm <= threshold)
+		{
+			result.Converged = true;
+			break;
+		}
+		if constexpr (!unpreconditioned)
+		{
+			preconditioner.Apply(r, z);
+		}
+		const auto rzNext = unpreconditioned ? rr : _kernels.Dot(r, z);
+		_kernels.Xpay(z, rzNext / rz, p);
+		rz = rzNext;
+	}
+	return result;
+}
+
+template<typename T>
+template<typename Matrix, typename Preconditioner>
+SolverResult ConjugateGradient<T>::Solve(const Matrix &matrix, const std::vector<T> &b, std::vector<T> &x, Preconditioner &&preconditioner)
+{
+	if (b.size() != matrix.GetRowCount() || x.size() != matrix.GetColCount())
+	{
+		throw std::invalid_argument("Invalid argument: vector size doesn't match matrix size");
+	}
+	return Solve(matrix, b.data(), x.data(), std::forward<Preconditioner>(preconditioner));
+}
+
+template<typename T>
+const SolverOptions &ConjugateGradient<T>::GetOptions() const
+{
+	return _options;
+}
+
+template<typename T>
+void ConjugateGradient<T>::SetOptions(const SolverOptions &options)
+{
+	_options = options;
+}
+
+template<typename T>
+void ConjugateGradient<T>::Resize(const size_t size)
+{
+	if (_kernels.GetSize() != size)
+	{
+		_kernels.Resize(size);
+		_r.resize(size);
+		_z.resize(size);
+		_p.resize(size);
+		_q.resize(size);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,305 @@
+/**
+	Sparse matrix implementation on open addressing hash table (dictionary of keys)
+
+	Author: Belousov K.
+	Repository: https://github.com/kombuchamp/SparseMatrices
+*/
+
+#pragma once
+#include <stdexcept>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include <ostream>
+#include <type_traits>
+#include "ISparseMatrix.h"
+#include "LLSparseMatrix.h"
+#include "CSRSparseMatrix.h"
+#include "RadixSort.h"
+#include "SparseIndex.h"
+
+/**
+ * Intended as a builder: elements can be set, updated and removed in any order
+ * in amortized O(1), then matrix is exported into sorted storage in one pass
+ */
+template<typename T = double, typename Index = size_t>
+class DOKSparseMatrix : public ISparseMatrix<T>
+{
+public:
+	DOKSparseMatrix()
+		: DOKSparseMatrix(0, 0)
+	{
+	}
+	DOKSparseMatrix(const size_t rows, const size_t cols)
+		: _rowCount(rows), _colCount(cols), _size(0)
+	{
+		static_assert(std::is_default_constructible<T>::value, "Template type T should have default constructor");
+		ThrowIfIndexOverflows<Index>(_rowCount, _colCount);
+	}
+	T ElementAt(int row, int col) const override;
+	void Resize(size_t rows, size_t cols) override;
+	void SetElement(int row, int col, T val) override;
+	void RemoveElement(int row, int col) override;
+	void Print(std::ostream &) const override;
+	void Print(std::ostream &, const PrintOptions &options) const override;
+	void Transpose() override;
+	[[nodiscard]] size_t GetNonZeroElementsCount() const override;
+	[[nodiscard]] size_t GetRowCount() const override;
+	[[nodiscard]] size_t GetColCount() const override;
+	void Reserve(size_t nonZeroElements);
+	[[nodiscard]] CSRSparseMatrix<T, Index> ToCSRSparseMatrix() const;
+	[[nodiscard]] LLSparseMatrix<T, std::allocator<MatrixNode<T>>, Index> ToLLSparseMatrix() const;
+private:
+	struct Slot
+	{
+		Index Row;
+		Index Col;
+		T Value;
+		bool Occupied = false;
+	};
+	[[nodiscard]] bool InBoundaries(size_t row, size_t col) const;
+	[[nodiscard]] size_t FindSlot(size_t row, size_t col) const;
+	[[nodiscard]] size_t HomeSlot(size_t row, size_t col) const;
+	void Rehash(size_t capacity);
+	size_t _rowCount;
+	size_t _colCount;
+	size_t _size;
+	// Capacity is always a power of two, table is kept at most half full
+	std::vector<Slot> _slots;
+};
+
+template<typename T, typename Index>
+void DOKSparseMatrix<T, Index>::Resize(const size_t rows, const size_t cols)
+{
+	if (rows < _rowCount || cols < _colCount)
+	{
+		throw std::invalid_argument("Can't reduce matrix size");
+	}
+	ThrowIfIndexOverflows<Index>(rows, cols);
+	_rowCount = rows;
+	_colCount = cols;
+}
+
+template<typename T, typename Index>
+T DOKSparseMatrix<T, Index>::ElementAt(int row, int col) const
+{
+	if (!InBoundaries(row, col))
+	{
+		throw std::invalid_argument("Element indices are out of bounds");
+	}
+	const auto slot = FindSlot(row, col);
+	return _slots.empty() || !_slots[slot].Occupied ? T() : _slots[slot].Value;
+}
+
+template<typename T, typename Index>
+void DOKSparseMatrix<T, Index>::SetElement(int row, int col, T val)
+{
+	if (!InBoundaries(row, col))
+	{
+		throw std::invalid_argument("Element indices are out of bounds");
+	}
+	if (val == T())
+	{
+		RemoveElement(row, col);
+		return;
+	}
+	if (2 * (_size + 1) > _slots.size())
+	{
+		Rehash(std::max<size_t>(16, 2 * _slots.size()));
+	}
+	auto &slot = _slots[FindSlot(row, col)];
+	if (!slot.Occupied)
+	{
+		slot.Row = static_cast<Index>(row);
+		slot.Col = static_cast<Index>(col);
+		slot.Occupied = true;
+		++_size;
+	}
+	slot.Value = val;
+}
+
+template<typename T, typename Index>
+void DOKSparseMatrix<T, Index>::RemoveElement(int row, int col)
+{
+	if (!InBoundaries(row, col))
+	{
+		throw std::invalid_argument("Element indices are out of bounds");
+	}
+	if (_slots.empty())
+	{
+		return;
+	}
+	auto hole = FindSlot(row, col);
+	if (!_slots[hole].Occupied)
+	{
+		return;
+	}
+
+	// Backward shift deletion: move up elements of the probe chain, so no tombstones are needed
+	const auto mask = _slots.size() - 1;
+	for (auto next = (hole + 1) & mask; _slots[next].Occupied; next = (next + 1) & mask)
+	{
+		const auto home = HomeSlot(_slots[next].Row, _slots[next].Col);
+		if (((next - home) & mask) >= ((next - hole) & mask))
+		{
+			_slots[hole] = _slots[next];
+			hole = next;
+		}
+	}
+	_slots[hole].Occupied = false;
+	--_size;
+}
+
+template<typename T, typename Index>
+void DOKSparseMatrix<T, Index>::Print(std::ostream &os) const
+{
+	Print(os, PrintOptions());
+}
+
+template<typename T, typename Index>
+void DOKSparseMatrix<T, Index>::Print(std::ostream &os, const PrintOptions &options) const
+{
+	if (options.Mode != PrintMode::Preview)
+	{
+		// Hash table has no order, elements are sorted into CSR first
+		ToCSRSparseMatrix().Print(os, options);
+		return;
+	}
+	PrintPreview<T>(os, _rowCount, _colCount, _size, options,
+		[&](size_t windowRows, size_t windowCols, auto &&visit)
+		{
+			for (auto &slot : _slots)
+			{
+				if (slot.Occupied && slot.Row < windowRows && slot.Col < windowCols)
+				{
+					visit(slot.Row, slot.Col, slot.Value);
+				}
+			}
+		});
+}
+
+template<typename T, typename Index>
+void DOKSparseMatrix<T, Index>::Transpose()
+{
+	for (auto &slot : _slots)
+	{
+		std::swap(slot.Row, slot.Col);
+	}
+	std::swap(_rowCount, _colCount);
+	Rehash(_slots.size());
+}
+
+template<typename T, typename Index>
+size_t DOKSparseMatrix<T, Index>::GetNonZeroElementsCount() const
+{
+	return _size;
+}
+
+template<typename T, typename Index>
+size_t DOKSparseMatrix<T, Index>::GetRowCount() const
+{
+	return _rowCount;
+}
+
+template<typename T, typename Index>
+size_t DOKSparseMatrix<T, Index>::GetColCount() const
+{
+	return _colCount;
+}
+
+template<typename T, typename Index>
+void DOKSparseMatrix<T, Index>::Reserve(const size_t nonZeroElements)
+{
+	size_t capacity = 16;
+	while (capacity < 2 * nonZeroElements)
+	{
+		capacity *= 2;
+	}
+	if (capacity > _slots.size())
+	{
+		Rehash(capacity);
+	}
+}
+
+/**
+ * Occupied slots are radix sorted by row-major position, positions in the table are unique
+ */
+template<typename T, typename Index>
+CSRSparseMatrix<T, Index> DOKSparseMatrix<T, Index>::ToCSRSparseMatrix() const
+{
+	std::vector<KeyedValue<T>> items;
+	items.reserve(_size);
+	for (auto &slot : _slots)
+	{
+		if (slot.Occupied)
+		{
+			items.push_back({ LinearPosition(slot.Row, slot.Col, _colCount), slot.Value });
+		}
+	}
+	std::vector<KeyedValue<T>> buffer;
+	ParallelRadixSortByKey(items, buffer, LinearPosition(_rowCount, 0, _colCount));
+	return CSRSparseMatrix<T, Index>::FromSortedKeys(_rowCount, _colCount, items);
+}
+
+template<typename T, typename Index>
+LLSparseMatrix<T, std::allocator<MatrixNode<T>>, Index> DOKSparseMatrix<T, Index>::ToLLSparseMatrix() const
+{
+	return ToCSRSparseMatrix().ToLLSparseMatrix();
+}
+
+template<typename T, typename Index>
+bool DOKSparseMatrix<T, Index>::InBoundaries(const size_t row, const size_t col) const
+{
+	return row < _rowCount && col < _colCount;
+}
+
+/**
+ * Returns slot holding the element or the empty slot where it should be inserted
+ */
+template<typename T, typename Index>
+size_t DOKSparseMatrix<T, Index>::FindSlot(const size_t row, const size_t col) const
+{
+	if (_slots.empty())
+	{
+		return 0;
+	}
+	const auto mask = _slots.size() - 1;
+	auto slot = HomeSlot(row, col);
+	while (_slots[slot].Occupied && (_slots[slot].Row != row || _slots[slot].Col != col))
+	{
+		slot = (slot + 1) & mask;
+	}
+	return slot;
+}
+
+template<typename T, typename Index>
+size_t DOKSparseMatrix<T, Index>::HomeSlot(const size_t row, const size_t col) const
+{
+	// splitmix64 finalizer over both indices
+	uint64_t hash = static_cast<uint64_t>(row) * 0x9E3779B97F4A7C15ull + static_cast<uint64_t>(col);
+	hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ull;
+	hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBull;
+	hash ^= hash >> 31;
+	return static_cast<size_t>(hash) & (_slots.size() - 1);
+}
+
+template<typename T, typename Index>
+void DOKSparseMatrix<T, Index>::Rehash(const size_t capacity)
+{
+	std::vector<Slot> old(capacity);
+	old.swap(_slots);
+	for (auto &slot : old)
+	{
+		if (slot.Occupied)
+		{
+			_slots[FindSlot(slot.Row, slot.Col)] = slot;
+		}
+	}
+}
+
+template<typename T, typename Index>
+std::ostream &operator<<(std::ostream &os, const DOKSparseMatrix<T, Index> &mat)
+{
+	mat.Print(os);
+	return os;
+}
@@ -0,0 +1,270 @@
+/**
+	Restarted GMRES solver for general square systems
+
+	Author: Belousov K.
+	Repository: https://github.com/kombuchamp/SparseMatrices
+*/
+
+#pragma once
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+#include <utility>
+#include <vector>
+#include "IterativeSolver.h"
+#include "ThreadPool.h"
+#include "VectorKernels.h"
+
+/**
+ * GMRES(m): minimizes ||b - A x|| over Krylov subspace of up to m vectors, then restarts from the current solution.
+ * Preconditioner is applied from the right, A M^-1 u = b, x = M^-1 u, so the tracked residual is the residual
+ * of the original system. Basis is orthogonalized by modified Gram-Schmidt, the last projection is fused
+ * with the norm of the new vector. Hessenberg matrix is reduced by Givens rotations as it grows,
+ * so the residual norm is known after every iteration without forming the solution.
+ * Basis, Hessenberg matrix and work vectors are kept between solves.
+ */
+template<typename T = double>
+class GMRES
+{
+public:
+	explicit GMRES(const SolverOptions &options = SolverOptions(), const size_t restartLength = 30, ThreadPool &pool = ThreadPool::Default())
+		: _options(options), _restartLength(restartLength), _kernels(pool)
+	{
+		if (restartLength == 0)
+		{
+			throw std::invalid_argument("Invalid argument: restart length should be positive");
+		}
+	}
+	template<typename Matrix, typename Preconditioner = IdentityPreconditioner>
+	SolverResult Solve(const Matrix &matrix, const T *b, T *x, Preconditioner &&preconditioner = Preconditioner());
+	template<typename Matrix, typename Preconditioner = IdentityPreconditioner>
+	SolverResult Solve(const Matrix &matrix, const std::vector<T> &b, std::vector<T> &x, Preconditioner &&preconditioner = Preconditioner());
+	[[nodiscard]] const SolverOptions &GetOptions() const;
+	void SetOptions(const SolverOptions &options);
+	[[nodiscard]] size_t GetRestartLength() const;
+private:
+	void Resize(size_t size);
+	[[nodiscard]] T *Basis(size_t k);
+	[[nodiscard]] T &Hessenberg(size_t row, size_t col);
+	SolverOptions _options;
+	size_t _restartLength;
+	VectorKernels<T> _kernels;
+	// m + 1 basis vectors of the system size, one after another
+	std::vector<T> _basis;
+	// (m + 1) x m upper Hessenberg matrix, column-major
+	std::vector<T> _hessenberg;
+	std::vector<T> _cos;
+	std::vector<T> _sin;
+	// Right-hand side of the least squares problem, rotated along with the Hessenberg matrix
+	std::vector<T> _g;
+	std::vector<T> _y;
+	std::vector<T> _w;
+	std::vector<T> _z;
+};
+
+/**
+ * x holds initial guess on input and solution on output
+ */
+template<typename T>
+template<typename Matrix, typename Preconditioner>
+SolverResult GMRES<T>::Solve(const Matrix &matrix, const T *b, T *x, Preconditioner &&preconditioner)
+{
+	constexpr auto unpreconditioned = IsIdentityPreconditioner<Preconditioner>();
+	const auto n = GetSystemSize(matrix);
+	Resize(n);
+	SolverResult result;
+	if (_options.RecordResidualHistory)
+	{
+		result.ResidualHistory.reserve(_options.MaxIterations + 1);
+	}
+	const auto record = [&](T norm)
+	{
+		result.ResidualNorm = static_cast<double>(norm);
+		if (_options.RecordResidualHistory)
+		{
+			result.ResidualHistory.push_back(result.ResidualNorm);
+		}
+	};
+	const auto threshold = _options.RelativeTolerance * _kernels.Norm(b);
+	auto *w = _w.data();
+	auto *z = _z.data();
+
+	while (true)
+	{
+		_kernels.Multiply(matrix, x, w);
+		const auto beta = std::sqrt(_kernels.Residual(b, w, Basis(0)));
+		// Residual at restart is computed from scratch, it replaces the estimate of the last iteration
+		if (result.Iterations == 0)
+		{
+			record(beta);
+		}
+		result.ResidualNorm = static_cast<double>(beta);
+		if (result.ResidualNorm <= threshold)
+		{
+			result.Converged = true;
+			break;
+		}
+		if (result.Iterations >= _options.MaxIterations)
+		{
+			break;
+		}
+		_kernels.Scale(T(1) / beta, Basis(0));
+		std::fill(_g.begin(), _g.end(), T());
+		_g[0] = beta;
+
+		// Arnoldi process, k counts columns of the Hessenberg matrix built so far
+		size_t k = 0;
+		auto converged = false;
+		while (k < _restartLength && result.Iterations < _options.MaxIterations)
+		{
+			const T *direction = Basis(k);
+			if constexpr (!unpreconditioned)
+			{
+				preconditioner.Apply(Basis(k), z);
+				direction = z;
+			}
+			auto *next = Basis(k + 1);
+			_kernels.Multiply(matrix, direction, next);
+			for (size_t i = 0; i < k; i++)
+			{
+				Hessenberg(i, k) = _kernels.Dot(next, Basis(i));
+				_kernels.Axpy(-Hessenberg(i, k), Basis(i), next);
+			}
+			const auto hkk = Hessenberg(k, k) = _kernels.Dot(next, Basis(k));
+			const auto *last = Basis(k);
+			const auto norm = std::sqrt(_kernels.Reduce(
+				[&](size_t begin, size_t end)
+				{
+					T sum = T();
+					for (auto i = begin; i < end; i++)
+					{
+						next[i] -= hkk * last[i];
+						sum += next[i] * next[i];
+					}
+					return sum;
+				}));
+			Hessenberg(k + 1, k) = norm;
+
+			for (size_t i = 0; i < k; i++)
+			{
+				const auto upper = Hessenberg(i, k);
+				const auto lower = Hessenberg(i + 1, k);
+				Hessenberg(i, k) = _cos[i] * upper + _sin[i] * lower;
+				Hessenberg(i + 1, k) = -_sin[i] * upper + _cos[i] * lower;
+			}
+			const auto diagonal = Hessenberg(k, k);
+			const auto subdiagonal = Hessenberg(k + 1, k);
+			const auto radius = std::sqrt(diagonal * diagonal + subdiagonal * subdiagonal);
+			_cos[k] = radius != T() ? diagonal / radius : T(1);
+			_sin[k] = radius != T() ? subdiagonal / radius : T();
+			Hessenberg(k, k) = radius;
+			Hessenberg(k + 1, k) = T();
+			_g[k + 1] = -_sin[k] * _g[k];
+			_g[k] = _cos[k] * _g[k];
+
+			++k;
+			++result.Iterations;
+			record(std::abs(_g[k]));
+			if (result.ResidualNorm <= threshold)
+			{
+				converged = true;
+				break;
+			}
+			if (norm == T())
+			{
+				// Krylov subspace is invariant, solution in it is exact, residual is rechecked after restart
+				break;
+			}
+			_kernels.Scale(T(1) / norm, next);
+		}
+
+		// y = H^-1 g, then x += M^-1 V y
+		for (auto i = k; i > 0; i--)
+		{
+			auto sum = _g[i - 1];
+			for (auto j = i; j < k; j++)
+			{
+				sum -= Hessenberg(i - 1, j) * _y[j];
+			}
+			_y[i - 1] = Hessenberg(i - 1, i - 1) != T() ? sum / Hessenberg(i - 1, i - 1) : T();
+		}
+		auto *update = unpreconditioned ? x : w;
+		if constexpr (!unpreconditioned)
+		{
+			_kernels.Fill(T(), w);
+		}
+		for (size_t j = 0; j < k; j++)
+		{
+			_kernels.Axpy(_y[j], Basis(j), update);
+		}
+		if constexpr (!unpreconditioned)
+		{
+			preconditioner.Apply(w, z);
+			_kernels.Axpy(T(1), z, x);
+		}
+		if (converged)
+		{
+			result.Converged = true;
+			break;
+		}
+	}
+	return result;
+}
+
+template<typename T>
+template<typename Matrix, typename Preconditioner>
+SolverResult GMRES<T>::Solve(const Matrix &matrix, const std::vector<T> &b, std::vector<T> &x, Preconditioner &&preconditioner)
+{
+	if (b.size() != matrix.GetRowCount() || x.size() != matrix.GetColCount())
+	{
+		throw std::invalid_argument("Invalid argument: vector size doesn't match matrix size");
+	}
+	return Solve(matrix, b.data(), x.data(), std::forward<Preconditioner>(preconditioner));
+}
+
+template<typename T>
+const SolverOptions &GMRES<T>::GetOptions() const
+{
+	return _options;
+}
+
+template<typename T>
+void GMRES<T>::SetOptions(const SolverOptions &options)
+{
+	_options = options;
+}
+
+template<typename T>
+size_t GMRES<T>::GetRestartLength() const
+{
+	return _restartLength;
+}
+
+template<typename T>
+void GMRES<T>::Resize(const size_t size)
+{
+	if (_kernels.GetSize() != size)
+	{
+		_kernels.Resize(size);
+		_basis.resize((_restartLength + 1) * size);
+		_hessenberg.resize((_restartLength + 1) * _restartLength);
+		_cos.resize(_restartLength);
+		_sin.resize(_restartLength);
+		_g.resize(_restartLength + 1);
+		_y.resize(_restartLength);
+		_w.resize(size);
+		_z.resize(size);
+	}
+}
+
+template<typename T>
+T *GMRES<T>::Basis(const size_t k)
+{
+	return _basis.data() + k * _kernels.GetSize();
+}
+
+template<typename T>
+T &GMRES<T>::Hessenberg(const size_t row, const size_t col)
+{
+	return _hessenberg[col * (_restartLength + 1) + row];
+}
\ No newline at end of file
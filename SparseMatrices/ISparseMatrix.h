@@ -7,6 +7,7 @@
 
 #pragma once
 #include <ostream>
+#include "MatrixPrinter.h"
 
 template<class T>
 class ISparseMatrix
@@ -18,6 +19,7 @@ public:
 	[[nodiscard]] virtual T ElementAt(int row, int col) const = 0;
 	virtual void Resize(const size_t rows, const size_t cols) = 0;
 	virtual void Print(std::ostream &) const = 0;
+	virtual void Print(std::ostream &, const PrintOptions &options) const = 0;
 	virtual void Transpose() = 0;
 	[[nodiscard]] virtual size_t GetNonZeroElementsCount() const = 0;
 	[[nodiscard]] virtual size_t GetRowCount() const = 0;
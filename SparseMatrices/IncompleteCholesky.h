@@ -0,0 +1,232 @@
+/**
+	IC(0) preconditioner
+
+	Author: Belousov K.
+	Repository: https://github.com/kombuchamp/SparseMatrices
+*/
+
+#pragma once
+#include <stdexcept>
+#include <cmath>
+#include <utility>
+#include <vector>
+#include "CSRSparseMatrix.h"
+#include "IterativeSolver.h"
+#include "LevelSchedule.h"
+#include "ThreadPool.h"
+
+/**
+ * Incomplete Cholesky factorization without fill-in of a symmetric positive definite matrix: L takes the places
+ * of the nonzero elements of the lower triangle of A, so M = L L^T matches A on its pattern.
+ * Only the lower triangle of A is read.
+ * Analyze works on the pattern only: extracts the lower triangle, lays out L^T for row-wise backward substitution
+ * and builds level schedules of both. Factorize computes values and may be called again for any matrix
+ * with the same pattern. Factorization and forward substitution run in parallel over levels of L,
+ * backward substitution over levels of L^T. Apply(r, z) computes z = L^-T L^-1 r.
+ */
+template<typename T = double, typename Index = size_t>
+class IncompleteCholesky
+{
+public:
+	explicit IncompleteCholesky(ThreadPool &pool = ThreadPool::Default())
+		: _pool(pool)
+	{
+	}
+	explicit IncompleteCholesky(const CSRSparseMatrix<T, Index> &matrix, ThreadPool &pool = ThreadPool::Default())
+		: _pool(pool)
+	{
+		Analyze(matrix);
+		Factorize(matrix);
+	}
+	void Analyze(const CSRSparseMatrix<T, Index> &matrix);
+	void Factorize(const CSRSparseMatrix<T, Index> &matrix);
+	void Apply(const T *r, T *z) const;
+	[[nodiscard]] size_t GetSize() const;
+	[[nodiscard]] const LevelSchedule &GetLowerSchedule() const;
+	[[nodiscard]] const LevelSchedule &GetUpperSchedule() const;
+private:
+	ThreadPool &_pool;
+	// Pattern of the analyzed matrix, refactorization is allowed only for the same one
+	std::vector<size_t> _matrixRowPtr{ 0 };
+	std::vector<Index> _matrixColIdx;
+	// L in CSR, diagonal element is the last one of every row
+	std::vector<size_t> _rowPtr{ 0 };
+	std::vector<Index> _colIdx;
+	std::vector<T> _values;
+	// Position in the matrix of every element of L
+	std::vector<size_t> _source;
+	// L^T in CSR, diagonal element is the first one of every row
+	std::vector<size_t> _transposedRowPtr{ 0 };
+	std::vector<Index> _transposedColIdx;
+	std::vector<T> _transposedValues;
+	// Position in L of every element of L^T
+	std::vector<size_t> _transposedSource;
+	std::vector<T> _inverseDiagonal;
+	LevelSchedule _lower;
+	LevelSchedule _upper;
+};
+
+template<typename T, typename Index>
+void IncompleteCholesky<T, Index>::Analyze(const CSRSparseMatrix<T, Index> &matrix)
+{
+	const auto n = GetSystemSize(matrix);
+	const auto &matrixRowPtr = matrix.GetRowPointers();
+	const auto &matrixColIdx = matrix.GetColIndices();
+	std::vector<size_t> rowPtr(n + 1, 0);
+	std::vector<Index> colIdx;
+	std::vector<size_t> source;
+	for (size_t i = 0; i < n; i++)
+	{
+		for (auto k = matrixRowPtr[i]; k < matrixRowPtr[i + 1] && matrixColIdx[k] <= i; k++)
+		{
+			colIdx.push_back(matrixColIdx[k]);
+			source.push_back(k);
+		}
+		rowPtr[i + 1] = colIdx.size();
+		if (rowPtr[i + 1] == rowPtr[i] || colIdx.back() != i)
+		{
+			throw std::invalid_argument("Invalid argument: incomplete factorization requires every diagonal element to be stored");
+		}
+	}
+
+	// Counting transpose, rows of L are visited in order, so columns of L^T come out sorted
+	std::vector<size_t> transposedRowPtr(n + 1, 0);
+	for (auto col : colIdx)
+	{
+		++transposedRowPtr[col + 1];
+	}
+	for (size_t i = 0; i < n; i++)
+	{
+		transposedRowPtr[i + 1] += transposedRowPtr[i];
+	}
+	std::vector<Index> transposedColIdx(colIdx.size());
+	std::vector<size_t> transposedSource(colIdx.size());
+	std::vector<size_t> next(transposedRowPtr.begin(), transposedRowPtr.end() - 1);
+	for (size_t i = 0; i < n; i++)
+	{
+		for (auto p = rowPtr[i]; p < rowPtr[i + 1]; p++)
+		{
+			const auto q = next[colIdx[p]]++;
+			transposedColIdx[q] = static_cast<Index>(i);
+			transposedSource[q] = p;
+		}
+	}
+
+	_matrixRowPtr = matrixRowPtr;
+	_matrixColIdx = matrixColIdx;
+	_lower = LevelSchedule::Lower(rowPtr, colIdx);
+	_upper = LevelSchedule::Upper(transposedRowPtr, transposedColIdx);
+	_rowPtr = std::move(rowPtr);
+	_colIdx = std::move(colIdx);
+	_source = std::move(source);
+	_transposedRowPtr = std::move(transposedRowPtr);
+	_transposedColIdx = std::move(transposedColIdx);
+	_transposedSource = std::move(transposedSource);
+	_values.clear();
+	_transposedValues.clear();
+	_inverseDiagonal.assign(n, T());
+}
+
+/**
+ * Row-oriented variant: l_ik = (a_ik - sum l_ij l_kj) / l_kk over j < k present in both rows,
+ * l_ii = sqrt(a_ii - sum l_ij^2). Rows of L^T are filled from L afterwards.
+ */
+template<typename T, typename Index>
+void IncompleteCholesky<T, Index>::Factorize(const CSRSparseMatrix<T, Index> &matrix)
+{
+	if (matrix.GetRowPointers() != _matrixRowPtr || matrix.GetColIndices() != _matrixColIdx)
+	{
+		throw std::invalid_argument("Invalid argument: matrix pattern differs from the analyzed one");
+	}
+	const auto &source = matrix.GetValues();
+	_values.resize(_colIdx.size());
+	_transposedValues.resize(_colIdx.size());
+	_lower.Run(_pool,
+		[&](size_t i)
+		{
+			const auto diagonal = _rowPtr[i + 1] - 1;
+			T squares = T();
+			for (auto p = _rowPtr[i]; p < diagonal; p++)
+			{
+				const size_t k = _colIdx[p];
+				auto sum = source[_source[p]];
+				auto q = _rowPtr[k];
+				auto r = _rowPtr[i];
+				while (q < _rowPtr[k + 1] - 1 && r < p)
+				{
+					if (_colIdx[q] < _colIdx[r])
+					{
+						q++;
+					}
+					else if (_colIdx[r] < _colIdx[q])
+					{
+						r++;
+					}
+					else
+					{
+						sum -= _values[r++] * _values[q++];
+					}
+				}
+				_values[p] = sum * _inverseDiagonal[k];
+				squares += _values[p] * _values[p];
+			}
+			const auto pivot = source[_source[diagonal]] - squares;
+			if (!(pivot > T()))
+			{
+				throw std::invalid_argument("Invalid argument: nonpositive pivot in incomplete Cholesky factorization");
+			}
+			_values[diagonal] = std::sqrt(pivot);
+			_inverseDiagonal[i] = T(1) / _values[diagonal];
+		});
+	_pool.ParallelForRange(_transposedValues.size(),
+		[&](size_t begin, size_t end, size_t)
+		{
+			for (auto q = begin; q < end; q++)
+			{
+				_transposedValues[q] = _values[_transposedSource[q]];
+			}
+		}, 1 << 14);
+}
+
+template<typename T, typename Index>
+void IncompleteCholesky<T, Index>::Apply(const T *r, T *z) const
+{
+	_lower.Run(_pool,
+		[&](size_t i)
+		{
+			auto sum = r[i];
+			for (auto p = _rowPtr[i]; p + 1 < _rowPtr[i + 1]; p++)
+			{
+				sum -= _values[p] * z[_colIdx[p]];
+			}
+			z[i] = sum * _inverseDiagonal[i];
+		});
+	_upper.Run(_pool,
+		[&](size_t i)
+		{
+			auto sum = z[i];
+			for (auto q = _transposedRowPtr[i] + 1; q < _transposedRowPtr[i + 1]; q++)
+			{
+				sum -= _transposedValues[q] * z[_transposedColIdx[q]];
+			}
+			z[i] = sum * _inverseDiagonal[i];
+		});
+}
+
+template<typename T, typename Index>
+size_t IncompleteCholesky<T, Index>::GetSize() const
+{
+	return _rowPtr.size() - 1;
+}
+
+template<typename T, typename Index>
+const LevelSchedule &IncompleteCholesky<T, Index>::GetLowerSchedule() const
+{
+	return _lower;
+}
+
+template<typename T, typename Index>
+const LevelSchedule &IncompleteCholesky<T, Index>::GetUpperSchedule() const
+{
+	return _upper;
+}
\ No newline at end of file
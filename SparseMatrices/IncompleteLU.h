@@ -0,0 +1,179 @@
+/**
+	ILU(0) preconditioner
+
+	Author: Belousov K.
+	Repository: https://github.com/kombuchamp/SparseMatrices
+*/
+
+#pragma once
+#include <stdexcept>
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include "CSRSparseMatrix.h"
+#include "IterativeSolver.h"
+#include "LevelSchedule.h"
+#include "ThreadPool.h"
+
+/**
+ * Incomplete LU factorization without fill-in: L (unit diagonal, not stored) and U take the places
+ * of the nonzero elements of A, so M = L U matches A on its pattern.
+ * Analyze works on the pattern only: copies it, finds diagonal positions and builds level schedules
+ * of both triangles. Factorize computes values and may be called again for any matrix with the same pattern.
+ * Row i of the factorization needs only rows of its strictly lower part, so factorization runs
+ * in parallel over levels of the lower schedule, as does forward substitution; backward substitution
+ * uses the upper schedule. Apply(r, z) computes z = U^-1 L^-1 r, so the object is a preconditioner of the solvers.
+ */
+template<typename T = double, typename Index = size_t>
+class IncompleteLU
+{
+public:
+	explicit IncompleteLU(ThreadPool &pool = ThreadPool::Default())
+		: _pool(pool)
+	{
+	}
+	explicit IncompleteLU(const CSRSparseMatrix<T, Index> &matrix, ThreadPool &pool = ThreadPool::Default())
+		: _pool(pool)
+	{
+		Analyze(matrix);
+		Factorize(matrix);
+	}
+	void Analyze(const CSRSparseMatrix<T, Index> &matrix);
+	void Factorize(const CSRSparseMatrix<T, Index> &matrix);
+	void Apply(const T *r, T *z) const;
+	[[nodiscard]] size_t GetSize() const;
+	[[nodiscard]] const LevelSchedule &GetLowerSchedule() const;
+	[[nodiscard]] const LevelSchedule &GetUpperSchedule() const;
+private:
+	ThreadPool &_pool;
+	std::vector<size_t> _rowPtr{ 0 };
+	std::vector<Index> _colIdx;
+	// Position of the diagonal element of every row
+	std::vector<size_t> _diagonal;
+	// Multipliers of L below the diagonal, U on and above it
+	std::vector<T> _values;
+	std::vector<T> _inverseDiagonal;
+	LevelSchedule _lower;
+	LevelSchedule _upper;
+};
+
+template<typename T, typename Index>
+void IncompleteLU<T, Index>::Analyze(const CSRSparseMatrix<T, Index> &matrix)
+{
+	const auto n = GetSystemSize(matrix);
+	const auto &rowPtr = matrix.GetRowPointers();
+	const auto &colIdx = matrix.GetColIndices();
+	std::vector<size_t> diagonal(n);
+	for (size_t i = 0; i < n; i++)
+	{
+		auto k = rowPtr[i];
+		while (k < rowPtr[i + 1] && colIdx[k] < i)
+		{
+			k++;
+		}
+		if (k == rowPtr[i + 1] || colIdx[k] != i)
+		{
+			throw std::invalid_argument("Invalid argument: incomplete factorization requires every diagonal element to be stored");
+		}
+		diagonal[i] = k;
+	}
+	_rowPtr = rowPtr;
+	_colIdx = colIdx;
+	_diagonal = std::move(diagonal);
+	_values.clear();
+	_inverseDiagonal.assign(n, T());
+	_lower = LevelSchedule::Lower(_rowPtr, _colIdx);
+	_upper = LevelSchedule::Upper(_rowPtr, _colIdx);
+}
+
+/**
+ * IKJ variant: row i is reduced by every already factorized row k of its lower part,
+ * only at positions present in both rows, which are found by merging sorted column indices
+ */
+template<typename T, typename Index>
+void IncompleteLU<T, Index>::Factorize(const CSRSparseMatrix<T, Index> &matrix)
+{
+	if (matrix.GetRowPointers() != _rowPtr || matrix.GetColIndices() != _colIdx)
+	{
+		throw std::invalid_argument("Invalid argument: matrix pattern differs from the analyzed one");
+	}
+	const auto &source = matrix.GetValues();
+	_values.resize(source.size());
+	_lower.Run(_pool,
+		[&](size_t i)
+		{
+			const auto rowEnd = _rowPtr[i + 1];
+			std::copy(source.begin() + _rowPtr[i], source.begin() + rowEnd, _values.begin() + _rowPtr[i]);
+			for (auto p = _rowPtr[i]; p < _diagonal[i]; p++)
+			{
+				const size_t k = _colIdx[p];
+				const auto multiplier = _values[p] *= _inverseDiagonal[k];
+				auto q = _diagonal[k] + 1;
+				auto r = p + 1;
+				while (q < _rowPtr[k + 1] && r < rowEnd)
+				{
+					if (_colIdx[q] < _colIdx[r])
+					{
+						q++;
+					}
+					else if (_colIdx[r] < _colIdx[q])
+					{
+						r++;
+					}
+					else
+					{
+						_values[r++] -= multiplier * _values[q++];
+					}
+				}
+			}
+			const auto pivot = _values[_diagonal[i]];
+			if (pivot == T())
+			{
+				throw std::invalid_argument("Invalid argument: zero pivot in incomplete factorization");
+			}
+			_inverseDiagonal[i] = T(1) / pivot;
+		});
+}
+
+template<typename T, typename Index>
+void IncompleteLU<T, Index>::Apply(const T *r, T *z) const
+{
+	_lower.Run(_pool,
+		[&](size_t i)
+		{
+			auto sum = r[i];
+			for (auto p = _rowPtr[i]; p < _diagonal[i]; p++)
+			{
+				sum -= _values[p] * z[_colIdx[p]];
+			}
+			z[i] = sum;
+		});
+	_upper.Run(_pool,
+		[&](size_t i)
+		{
+			auto sum = z[i];
+			for (auto p = _diagonal[i] + 1; p < _rowPtr[i + 1]; p++)
+			{
+				sum -= _values[p] * z[_colIdx[p]];
+			}
+			z[i] = sum * _inverseDiagonal[i];
+		});
+}
+
+template<typename T, typename Index>
+size_t IncompleteLU<T, Index>::GetSize() const
+{
+	return _rowPtr.size() - 1;
+}
+
+template<typename T, typename Index>
+const LevelSchedule &IncompleteLU<T, Index>::GetLowerSchedule() const
+{
+	return _lower;
+}
+
+template<typename T, typename Index>
+const LevelSchedule &IncompleteLU<T, Index>::GetUpperSchedule() const
+{
+	return _upper;
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+/**
+	Common types of iterative linear solvers
+
+	Author: Belousov K.
+	Repository: https://github.com/kombuchamp/SparseMatrices
+*/
+
+#pragma once
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+struct SolverOptions
+{
+	size_t MaxIterations = 1000;
+	// Solver stops when ||b - A x|| <= RelativeTolerance * ||b||
+	double RelativeTolerance = 1e-8;
+	bool RecordResidualHistory = true;
+};
+
+struct SolverResult
+{
+	bool Converged = false;
+	size_t Iterations = 0;
+	// Norm of the last residual, as tracked by the solver
+	double ResidualNorm = 0;
+	// Residual norm before the first iteration and after every iteration, if recorded
+	std::vector<double> ResidualHistory;
+};
+
+/**
+ * Solvers take preconditioner M as any object with Apply(r, z) computing z = M^-1 r for vectors of system size.
+ * IdentityPreconditioner means no preconditioning, solvers skip the step without copying vectors.
+ */
+struct IdentityPreconditioner
+{
+};
+
+template<typename Preconditioner>
+constexpr bool IsIdentityPreconditioner()
+{
+	return std::is_same<std::decay_t<Preconditioner>, IdentityPreconditioner>::value;
+}
+
+/**
+ * Checks that matrix is square and returns its size
+ */
+template<typename Matrix>
+size_t GetSystemSize(const Matrix &matrix)
+{
+	if (matrix.GetRowCount() != matrix.GetColCount())
+	{
+		throw std::invalid_argument("Invalid argument: system matrix should be square");
+	}
+	return matrix.GetRowCount();
+}
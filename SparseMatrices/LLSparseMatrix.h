@@ -8,57 +8,106 @@
 #pragma once
 #include <exception>
 #include <algorithm>
-#include <map>
+#include <cstdint>
 #include <list>
+#include <memory>
+#include <vector>
 #include <utility>
 #include <type_traits>
 #include "ISparseMatrix.h"
+#include "MatrixPrinter.h"
 #include "MatrixNode.h"
+#include "SparseAccumulator.h"
+#include "SparseIndex.h"
+#include "RadixSort.h"
+#include "ThreadPool.h"
+#include "Triplets.h"
 
-template<typename T = double>
+/**
+ * Allocator is used for list nodes, NodePoolAllocator<MatrixNode<T>> takes them from slabs instead of the global heap.
+ * Index is the type of row and column indices stored in every node, uint16_t or uint32_t make nodes of small matrices smaller.
+ */
+template<typename T = double, typename Allocator = std::allocator<MatrixNode<T>>, typename Index = size_t>
 class LLSparseMatrix
 {
+	using Node = MatrixNode<T, Index>;
+	using NodeAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
 public:
+	using MultiplyWorkspace = ProductWorkspace<T, typename std::list<Node, NodeAllocator>::const_iterator>;
+
 	LLSparseMatrix()
 		: LLSparseMatrix(0, 0)
 	{
 	}
-	LLSparseMatrix(const int rows, const int cols)
-		: _rowCount(rows), _colCount(cols)
+	LLSparseMatrix(const size_t rows, const size_t cols, const Allocator &allocator = Allocator())
+		: _rowCount(rows), _colCount(cols), _nonZeroElements(NodeAllocator(allocator))
 	{
 		static_assert(std::is_default_constructible<T>::value, "Template type T should have default constructor");
+		ThrowIfIndexOverflows<Index>(_rowCount, _colCount);
 	}
+	template<typename Iterator>
+	[[nodiscard]] static LLSparseMatrix<T, Allocator, Index> FromTriplets(size_t rows, size_t cols, Iterator first, Iterator last,
+		TripletOrder order = TripletOrder::Unsorted, DuplicatePolicy policy = DuplicatePolicy::Sum, const Allocator &allocator = Allocator(),
+		ThreadPool &pool = ThreadPool::Default());
 	T ElementAt(int row, int col) const;
 	void Resize(size_t rows, size_t cols);
 	void SetElement(int row, int col, T val);
 	void RemoveElement(int row, int col);
 	void Print(std::ostream &) const;
+	void Print(std::ostream &, const PrintOptions &options) const;
 	void Transpose();
 	[[nodiscard]] size_t GetNonZeroElementsCount() const;
 	[[nodiscard]] size_t GetRowCount() const;
 	[[nodiscard]] size_t GetColCount() const;
-	LLSparseMatrix<T> Multiply(LLSparseMatrix<T>& other);
+	[[nodiscard]] LLSparseMatrix<T, Allocator, Index> Add(const LLSparseMatrix<T, Allocator, Index> &other) const;
+	[[nodiscard]] LLSparseMatrix<T, Allocator, Index> Subtract(const LLSparseMatrix<T, Allocator, Index> &other) const;
+	[[nodiscard]] LLSparseMatrix<T, Allocator, Index> ScaledAdd(const T &alpha, const T &beta, const LLSparseMatrix<T, Allocator, Index> &other) const;
+	[[nodiscard]] LLSparseMatrix<T, Allocator, Index> Multiply(const LLSparseMatrix<T, Allocator, Index> &other) const;
+	[[nodiscard]] Allocator GetAllocator() const;
 private:
+	template<typename, typename> friend class CSRSparseMatrix;
+	template<typename, typename> friend class RowIndexedLLSparseMatrix;
+	template<typename U, typename OtherAllocator, typename OtherIndex>
+	friend void MultiplyInto(LLSparseMatrix<U, OtherAllocator, OtherIndex> &result, const LLSparseMatrix<U, OtherAllocator, OtherIndex> &a,
+		const LLSparseMatrix<U, OtherAllocator, OtherIndex> &b, typename LLSparseMatrix<U, OtherAllocator, OtherIndex>::MultiplyWorkspace &workspace);
 	[[nodiscard]] bool InBoundaries(size_t row, size_t col) const;
-	[[nodiscard]] int GetPosition(size_t row, size_t col) const;
+	[[nodiscard]] uint64_t GetPosition(size_t row, size_t col) const;
 	size_t _rowCount;
 	size_t _colCount;
-	std::list<MatrixNode<T>> _nonZeroElements;
+	std::list<Node, NodeAllocator> _nonZeroElements;
 };
 
-template<typename T>
-void LLSparseMatrix<T>::Resize(const size_t rows, const size_t cols)
+/**
+ * Builds matrix from (row, col, value) triplets in O(nnz) for sorted input and a few radix sort passes otherwise,
+ * instead of O(nnz) per SetElement call. Zero results are not stored.
+ */
+template<typename T, typename Allocator, typename Index>
+template<typename Iterator>
+LLSparseMatrix<T, Allocator, Index> LLSparseMatrix<T, Allocator, Index>::FromTriplets(const size_t rows, const size_t cols,
+	Iterator first, Iterator last, const TripletOrder order, const DuplicatePolicy policy, const Allocator &allocator, ThreadPool &pool)
+{
+	LLSparseMatrix result(rows, cols, allocator);
+	for (auto &item : SortTriplets<T>(rows, cols, first, last, order, policy, pool))
+	{
+		result._nonZeroElements.emplace_back(item.Key / cols, item.Key % cols, item.Value);
+	}
+	return result;
+}
+
+template<typename T, typename Allocator, typename Index>
+void LLSparseMatrix<T, Allocator, Index>::Resize(const size_t rows, const size_t cols)
 {
 	if (rows < _rowCount || cols < _colCount)
 	{
 		throw std::invalid_argument("Can't reduce matrix size");
 	}
+	ThrowIfIndexOverflows<Index>(rows, cols);
 	_rowCount = rows;
 	_colCount = cols;
 }
 
-template<typename T>
-T LLSparseMatrix<T>::ElementAt(int row, int col) const
+template<typename T, typename Allocator, typename Index>
+T LLSparseMatrix<T, Allocator, Index>::ElementAt(int row, int col) const
 {
 	if (!InBoundaries(row, col))
 	{
@@ -74,8 +123,8 @@ T LLSparseMatrix<T>::ElementAt(int row, int col) const
 	return T();
 }
 
-template<typename T>
-void LLSparseMatrix<T>::SetElement(int row, int col, T val)
+template<typename T, typename Allocator, typename Index>
+void LLSparseMatrix<T, Allocator, Index>::SetElement(int row, int col, T val)
 {
 	if (!InBoundaries(row, col))
 	{
@@ -87,7 +136,7 @@ void LLSparseMatrix<T>::SetElement(int row, int col, T val)
 	}
 	if (_nonZeroElements.empty())
 	{
-		_nonZeroElements.emplace_back(MatrixNode(row, col, val));
+		_nonZeroElements.emplace_back(Node(row, col, val));
 		return;
 	}
 	const auto newElementPosition = GetPosition(row, col);
@@ -101,15 +150,15 @@ void LLSparseMatrix<T>::SetElement(int row, int col, T val)
 		}
 		if (newElementPosition < currentElementPosition)
 		{
-			_nonZeroElements.insert(elemIt, MatrixNode(row, col, val));
+			_nonZeroElements.insert(elemIt, Node(row, col, val));
 			return;
 		}
 	}
-	_nonZeroElements.emplace_back(MatrixNode(row, col, val));
+	_nonZeroElements.emplace_back(Node(row, col, val));
 }
 
-template<typename T>
-void LLSparseMatrix<T>::RemoveElement(int row, int col)
+template<typename T, typename Allocator, typename Index>
+void LLSparseMatrix<T, Allocator, Index>::RemoveElement(int row, int col)
 {
 	if (!InBoundaries(row, col))
 	{
@@ -124,142 +173,245 @@ void LLSparseMatrix<T>::RemoveElement(int row, int col)
 }
 
 
-template<typename T>
-void LLSparseMatrix<T>::Print(std::ostream &os) const
+template<typename T, typename Allocator, typename Index>
+void LLSparseMatrix<T, Allocator, Index>::Print(std::ostream &os) const
 {
-	auto it = _nonZeroElements.begin();
-	for (size_t i = 0; i < _rowCount; i++)
-	{
-		for (size_t j = 0; j < _colCount; j++)
+	Print(os, PrintOptions());
+}
+
+template<typename T, typename Allocator, typename Index>
+void LLSparseMatrix<T, Allocator, Index>::Print(std::ostream &os, const PrintOptions &options) const
+{
+	PrintSparse<T>(os, _rowCount, _colCount, _nonZeroElements.size(), options,
+		[&](auto &&visit)
 		{
-			if (it != _nonZeroElements.end() && it->Row == i && it->Col == j)
-			{
-				os << it->Value << " ";
-				++it;
-			}
-			else
+			for (auto &elem : _nonZeroElements)
 			{
-				os << T() << " ";
+				if (!visit(elem.Row, elem.Col, elem.Value))
+				{
+					return;
+				}
 			}
-		}
-		os << std::endl;
-	}
+		});
 }
 
-template<typename T>
-size_t LLSparseMatrix<T>::GetNonZeroElementsCount() const
+template<typename T, typename Allocator, typename Index>
+size_t LLSparseMatrix<T, Allocator, Index>::GetNonZeroElementsCount() const
 {
 	return _nonZeroElements.size();
 }
 
-template<typename T>
-size_t LLSparseMatrix<T>::GetRowCount() const
+template<typename T, typename Allocator, typename Index>
+size_t LLSparseMatrix<T, Allocator, Index>::GetRowCount() const
 {
 	return _rowCount;
 }
 
-template<typename T>
-size_t LLSparseMatrix<T>::GetColCount() const
+template<typename T, typename Allocator, typename Index>
+size_t LLSparseMatrix<T, Allocator, Index>::GetColCount() const
 {
 	return _colCount;
 }
 
 
-template<typename T>
-void LLSparseMatrix<T>::Transpose()
+/**
+ * Nodes are radix sorted by their new positions and relinked in that order, nothing is allocated for nodes
+ */
+template<typename T, typename Allocator, typename Index>
+void LLSparseMatrix<T, Allocator, Index>::Transpose()
 {
-	for (auto &elem : _nonZeroElements)
+	std::swap(_rowCount, _colCount);
+	std::vector<KeyedValue<typename std::list<Node, NodeAllocator>::iterator>> order;
+	order.reserve(_nonZeroElements.size());
+	for (auto it = _nonZeroElements.begin(); it != _nonZeroElements.end(); ++it)
 	{
-		std::swap(elem.Row, elem.Col);
+		std::swap(it->Row, it->Col);
+		order.push_back({ GetPosition(it->Row, it->Col), it });
+	}
+	decltype(order) buffer;
+	ParallelRadixSortByKey(order, buffer, GetPosition(_rowCount, 0));
+	for (auto &item : order)
+	{
+		_nonZeroElements.splice(_nonZeroElements.end(), _nonZeroElements, item.Value);
 	}
-	std::swap(_rowCount, _colCount);
-	_nonZeroElements.sort(
-		[this](auto &first, auto &second)
-		{
-			return GetPosition(first.Row, first.Col) < GetPosition(second.Row, second.Col);
-		});
 }
 
-template<typename T>
-LLSparseMatrix<T> LLSparseMatrix<T>::Multiply(LLSparseMatrix<T>& other)
+template<typename T, typename Allocator, typename Index>
+LLSparseMatrix<T, Allocator, Index> LLSparseMatrix<T, Allocator, Index>::Add(const LLSparseMatrix<T, Allocator, Index> &other) const
 {
-	if (this->_colCount != other._rowCount)
-	{
-		throw std::invalid_argument("Invalid argument: impossible to multiply incompatible matrices");
-	}
+	return ScaledAdd(T(1), T(1), other);
+}
+
+template<typename T, typename Allocator, typename Index>
+LLSparseMatrix<T, Allocator, Index> LLSparseMatrix<T, Allocator, Index>::Subtract(const LLSparseMatrix<T, Allocator, Index> &other) const
+{
+	return ScaledAdd(T(1), T(-1), other);
+}
 
-	LLSparseMatrix result(this->_rowCount, other._colCount);
-	if (this->_nonZeroElements.empty() || other._nonZeroElements.empty())
+/**
+ * alpha * A + beta * B. Both lists are sorted in row-major order, so they are merged in one pass
+ * in O(nnz(A) + nnz(B)) and the result is appended already sorted. Elements that cancel out to zero are not stored.
+ */
+template<typename T, typename Allocator, typename Index>
+LLSparseMatrix<T, Allocator, Index> LLSparseMatrix<T, Allocator, Index>::ScaledAdd(const T &alpha, const T &beta,
+	const LLSparseMatrix<T, Allocator, Index> &other) const
+{
+	if (_rowCount != other._rowCount || _colCount != other._colCount)
 	{
-		return result;
+		throw std::invalid_argument("Invalid argument: impossible to add matrices of different sizes");
 	}
-	auto thisIt = this->_nonZeroElements.begin();
-	auto otherIt = other._nonZeroElements.begin();
-	std::map<std::pair<int, int>, T> idxValMap;
-
-	// Multiplication loop
-	/**
-	 * Iterate through first matrix elements A[i, j].
-	 * Multiply each one by every element in j-th Row of other matrix.
-	 * Accumulate multiplication result in idxValMap
-	 * where key is pair of indices of element in resulting matrix.
-	 * This algorithm allows us to avoid matrix transposition or picking out column during multiplication
-	 */
-
-	while (thisIt != this->_nonZeroElements.end())
-	{
-		otherIt = other._nonZeroElements.begin();
 
-		// Find corresponding row
-		if (thisIt->Col != otherIt->Row)
+	LLSparseMatrix result(_rowCount, _colCount,
+		Allocator(std::allocator_traits<NodeAllocator>::select_on_container_copy_construction(_nonZeroElements.get_allocator())));
+	auto it = _nonZeroElements.cbegin();
+	auto otherIt = other._nonZeroElements.cbegin();
+	const auto end = _nonZeroElements.cend();
+	const auto otherEnd = other._nonZeroElements.cend();
+	while (it != end || otherIt != otherEnd)
+	{
+		const auto position = it != end ? GetPosition(it->Row, it->Col) : UINT64_MAX;
+		const auto otherPosition = otherIt != otherEnd ? GetPosition(otherIt->Row, otherIt->Col) : UINT64_MAX;
+		const auto &source = position <= otherPosition ? *it : *otherIt;
+		T value;
+		if (position < otherPosition)
 		{
-			while (otherIt != other._nonZeroElements.end() && thisIt->Col != otherIt->Row)
-			{
-				++otherIt;
-			}
-			if (otherIt == other._nonZeroElements.end())
-			{
-				++thisIt;
-				continue;
-			}
+			value = alpha * (it++)->Value;
 		}
-
-		// Calculate partial sums
-		while (otherIt != other._nonZeroElements.end() && thisIt->Col == otherIt->Row)
+		else if (otherPosition < position)
 		{
-			int i = thisIt->Row;
-			int j = otherIt->Col;
-			idxValMap[std::pair<int, int>(i, j)] += thisIt->Value * otherIt->Value;
-
-			++otherIt;
+			value = beta * (otherIt++)->Value;
+		}
+		else
+		{
+			value = alpha * (it++)->Value + beta * (otherIt++)->Value;
+		}
+		if (value != T())
+		{
+			result._nonZeroElements.emplace_back(source.Row, source.Col, value);
 		}
-		++thisIt;
 	}
+	return result;
+}
 
-	for (auto item : idxValMap)
-	{
-		auto [indices, value] = item;
-		auto [i, j] = indices;
-		result.SetElement(i, j, value);
-	}
+/**
+ * Result gets a fresh allocator derived from this matrix's one, as a copy of the matrix would
+ */
+template<typename T, typename Allocator, typename Index>
+LLSparseMatrix<T, Allocator, Index> LLSparseMatrix<T, Allocator, Index>::Multiply(const LLSparseMatrix<T, Allocator, Index> &other) const
+{
+	LLSparseMatrix result(0, 0,
+		Allocator(std::allocator_traits<NodeAllocator>::select_on_container_copy_construction(_nonZeroElements.get_allocator())));
+	MultiplyInto(result, *this, other);
 	return result;
 }
 
-template<typename T>
-bool LLSparseMatrix<T>::InBoundaries(const size_t row, const size_t col) const
+template<typename T, typename Allocator, typename Index>
+Allocator LLSparseMatrix<T, Allocator, Index>::GetAllocator() const
+{
+	return Allocator(_nonZeroElements.get_allocator());
+}
+
+template<typename T, typename Allocator, typename Index>
+bool LLSparseMatrix<T, Allocator, Index>::InBoundaries(const size_t row, const size_t col) const
 {
 	return (row < _rowCount && row >= 0) && (col < _colCount && col >= 0);
 }
 
-template<typename T>
-int LLSparseMatrix<T>::GetPosition(const size_t row, const size_t col) const
+template<typename T, typename Allocator, typename Index>
+uint64_t LLSparseMatrix<T, Allocator, Index>::GetPosition(const size_t row, const size_t col) const
 {
-	return _colCount * row + col;
+	return LinearPosition(row, col, _colCount);
 }
 
-template<typename T>
-std::ostream &operator<<(std::ostream &os, LLSparseMatrix<T> &mat)
+template<typename T, typename Allocator, typename Index>
+std::ostream &operator<<(std::ostream &os, const LLSparseMatrix<T, Allocator, Index> &mat)
 {
 	mat.Print(os);
 	return os;
 }
+
+
+/**
+ * result = a * b, row-wise (Gustavson's algorithm):
+ * i-th row of result is a sum of rows of b, k-th row taken with weight a[i, k].
+ * Beginnings of rows of b are indexed once, so each a[i, k] costs O(nnz in k-th row of b).
+ * Row is accumulated in SparseAccumulator and written to the result already sorted,
+ * so the result list is built in O(nnz) without searching for insertion points.
+ * Nodes already in result are overwritten in place and only the surplus is allocated or freed,
+ * so repeated products of the same pattern with the same workspace don't touch the heap.
+ */
+template<typename T, typename Allocator, typename Index>
+void MultiplyInto(LLSparseMatrix<T, Allocator, Index> &result, const LLSparseMatrix<T, Allocator, Index> &a,
+	const LLSparseMatrix<T, Allocator, Index> &b, typename LLSparseMatrix<T, Allocator, Index>::MultiplyWorkspace &workspace)
+{
+	if (a._colCount != b._rowCount)
+	{
+		throw std::invalid_argument("Invalid argument: impossible to multiply incompatible matrices");
+	}
+	if (&result == &a || &result == &b)
+	{
+		result = a.Multiply(b);
+		return;
+	}
+
+	result._rowCount = a._rowCount;
+	result._colCount = b._colCount;
+	auto &rowBegin = workspace.RowBegin;
+	const auto bEnd = b._nonZeroElements.cend();
+	rowBegin.assign(b._rowCount + 1, bEnd);
+	for (auto it = b._nonZeroElements.cbegin(); it != bEnd; ++it)
+	{
+		if (rowBegin[it->Row] == bEnd)
+		{
+			rowBegin[it->Row] = it;
+		}
+	}
+	for (auto i = b._rowCount; i > 0; i--)
+	{
+		if (rowBegin[i - 1] == bEnd)
+		{
+			rowBegin[i - 1] = rowBegin[i];
+		}
+	}
+
+	auto &accumulator = workspace.Accumulator;
+	accumulator.Reserve(b._colCount);
+	auto &nodes = result._nonZeroElements;
+	auto out = nodes.begin();
+	auto aIt = a._nonZeroElements.cbegin();
+	while (aIt != a._nonZeroElements.cend())
+	{
+		const auto i = aIt->Row;
+		for (; aIt != a._nonZeroElements.cend() && aIt->Row == i; ++aIt)
+		{
+			for (auto bIt = rowBegin[aIt->Col]; bIt != rowBegin[aIt->Col + 1]; ++bIt)
+			{
+				accumulator.Accumulate(bIt->Col, aIt->Value * bIt->Value);
+			}
+		}
+		accumulator.Flush(
+			[&](auto j, auto &value)
+			{
+				if (out != nodes.end())
+				{
+					out->Row = i;
+					out->Col = static_cast<Index>(j);
+					out->Value = value;
+					++out;
+				}
+				else
+				{
+					nodes.emplace_back(i, j, value);
+				}
+			});
+	}
+	nodes.erase(out, nodes.end());
+}
+
+template<typename T, typename Allocator, typename Index>
+void MultiplyInto(LLSparseMatrix<T, Allocator, Index> &result, const LLSparseMatrix<T, Allocator, Index> &a,
+	const LLSparseMatrix<T, Allocator, Index> &b)
+{
+	typename LLSparseMatrix<T, Allocator, Index>::MultiplyWorkspace workspace;
+	MultiplyInto(result, a, b, workspace);
+}
\ No newline at end of file
@@ -0,0 +1,170 @@
+/**
+	Level scheduling of sparse triangular solves
+
+	Author: Belousov K.
+	Repository: https://github.com/kombuchamp/SparseMatrices
+*/
+
+#pragma once
+#include <algorithm>
+#include <vector>
+#include "ThreadPool.h"
+
+/**
+ * Rows of a triangular CSR pattern grouped into levels: a row depends only on rows of earlier levels,
+ * so rows of one level may be processed concurrently. Levels are computed once from the pattern
+ * and reused by every solve and refactorization with it.
+ * Lower schedule follows the strictly lower part of the pattern (entries with col < row),
+ * upper schedule follows the strictly upper part (col > row), entries of the other part are ignored,
+ * so one pattern with both triangles gives both schedules.
+ */
+class LevelSchedule
+{
+public:
+	LevelSchedule() = default;
+	template<typename Index>
+	[[nodiscard]] static LevelSchedule Lower(const std::vector<size_t> &rowPtr, const std::vector<Index> &colIdx);
+	template<typename Index>
+	[[nodiscard]] static LevelSchedule Upper(const std::vector<size_t> &rowPtr, const std::vector<Index> &colIdx);
+	/**
+	 * Groups rows by levels assigned by the caller, levels[i] < levelCount is the level of row i
+	 */
+	[[nodiscard]] static LevelSchedule FromLevels(const std::vector<size_t> &levels, size_t levelCount);
+	[[nodiscard]] size_t GetRowCount() const;
+	[[nodiscard]] size_t GetLevelCount() const;
+	/**
+	 * Rows of level l are GetRows()[GetLevelPointers()[l] .. GetLevelPointers()[l + 1]), in ascending order
+	 */
+	[[nodiscard]] const std::vector<size_t> &GetLevelPointers() const;
+	[[nodiscard]] const std::vector<size_t> &GetRows() const;
+	/**
+	 * Calls body(row) for every row, level after level. Rows of wide levels are split between threads of the pool,
+	 * narrow levels are processed by the calling thread.
+	 */
+	template<typename Body>
+	void Run(ThreadPool &pool, Body &&body) const;
+	/**
+	 * Calls body(row) for every row of one level
+	 */
+	template<typename Body>
+	void RunLevel(ThreadPool &pool, size_t level, Body &&body) const;
+private:
+	// Levels with fewer rows per thread aren't worth waking the pool
+	static constexpr size_t MinRowsPerTask = 128;
+	std::vector<size_t> _levelPtr{ 0 };
+	std::vector<size_t> _rows;
+};
+
+template<typename Index>
+LevelSchedule LevelSchedule::Lower(const std::vector<size_t> &rowPtr, const std::vector<Index> &colIdx)
+{
+	const auto rowCount = rowPtr.size() - 1;
+	std::vector<size_t> levels(rowCount);
+	size_t levelCount = 0;
+	for (size_t i = 0; i < rowCount; i++)
+	{
+		size_t level = 0;
+		for (auto k = rowPtr[i]; k < rowPtr[i + 1] && colIdx[k] < i; k++)
+		{
+			level = std::max(level, levels[colIdx[k]] + 1);
+		}
+		levels[i] = level;
+		levelCount = std::max(levelCount, level + 1);
+	}
+	return FromLevels(levels, levelCount);
+}
+
+template<typename Index>
+LevelSchedule LevelSchedule::Upper(const std::vector<size_t> &rowPtr, const std::vector<Index> &colIdx)
+{
+	const auto rowCount = rowPtr.size() - 1;
+	std::vector<size_t> levels(rowCount);
+	size_t levelCount = 0;
+	for (auto i = rowCount; i > 0; i--)
+	{
+		size_t level = 0;
+		for (auto k = rowPtr[i]; k > rowPtr[i - 1] && colIdx[k - 1] > i - 1; k--)
+		{
+			level = std::max(level, levels[colIdx[k - 1]] + 1);
+		}
+		levels[i - 1] = level;
+		levelCount = std::max(levelCount, level + 1);
+	}
+	return FromLevels(levels, levelCount);
+}
+
+/**
+ * Counting sort of rows by level, rows stay ascending within a level
+ */
+inline LevelSchedule LevelSchedule::FromLevels(const std::vector<size_t> &levels, const size_t levelCount)
+{
+	LevelSchedule schedule;
+	schedule._levelPtr.assign(levelCount + 1, 0);
+	for (auto level : levels)
+	{
+		++schedule._levelPtr[level + 1];
+	}
+	for (size_t l = 0; l < levelCount; l++)
+	{
+		schedule._levelPtr[l + 1] += schedule._levelPtr[l];
+	}
+	schedule._rows.resize(levels.size());
+	std::vector<size_t> next(schedule._levelPtr.begin(), schedule._levelPtr.end() - 1);
+	for (size_t i = 0; i < levels.size(); i++)
+	{
+		schedule._rows[next[levels[i]]++] = i;
+	}
+	return schedule;
+}
+
+inline size_t LevelSchedule::GetRowCount() const
+{
+	return _rows.size();
+}
+
+inline size_t LevelSchedule::GetLevelCount() const
+{
+	return _levelPtr.size() - 1;
+}
+
+inline const std::vector<size_t> &LevelSchedule::GetLevelPointers() const
+{
+	return _levelPtr;
+}
+
+inline const std::vector<size_t> &LevelSchedule::GetRows() const
+{
+	return _rows;
+}
+
+template<typename Body>
+void LevelSchedule::Run(ThreadPool &pool, Body &&body) const
+{
+	for (size_t l = 0; l + 1 < _levelPtr.size(); l++)
+	{
+		RunLevel(pool, l, body);
+	}
+}
+
+template<typename Body>
+void LevelSchedule::RunLevel(ThreadPool &pool, const size_t level, Body &&body) const
+{
+	const auto *rows = _rows.data() + _levelPtr[level];
+	const auto count = _levelPtr[level + 1] - _levelPtr[level];
+	if (count < 2 * MinRowsPerTask)
+	{
+		for (size_t k = 0; k < count; k++)
+		{
+			body(rows[k]);
+		}
+		return;
+	}
+	pool.ParallelForRange(count,
+		[&](size_t begin, size_t end, size_t)
+		{
+			for (auto k = begin; k < end; k++)
+			{
+				body(rows[k]);
+			}
+		}, MinRowsPerTask);
+}
\ No newline at end of file
@@ -0,0 +1,175 @@
+/**
+	Read-only CSR matrix backed by memory mapped binary snapshot
+
+	Author: Belousov K.
+	Repository: https://github.com/kombuchamp/SparseMatrices
+*/
+
+#pragma once
+#include <stdexcept>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "BinarySnapshot.h"
+#include "CSRSparseMatrix.h"
+#include "MemoryMappedFile.h"
+#include "SpMVKernels.h"
+#include "ThreadPool.h"
+
+/**
+ * Opens snapshot written by BinarySnapshot::WriteFile without reading or copying its arrays:
+ * row pointers, column indices and values point straight into the mapped file
+ * and pages are loaded by the OS when products touch them.
+ * Opening costs a few system calls regardless of matrix size, unless structure or checksum verification is requested.
+ * Header verification trusts row pointers between the first and the last one and column indices,
+ * so files from untrusted sources should be opened with Structure verification.
+ */
+template<typename T = double, typename Index = size_t>
+class MappedCSRSparseMatrix
+{
+public:
+	explicit MappedCSRSparseMatrix(const std::string &path, SnapshotVerification verification = SnapshotVerification::Header);
+	[[nodiscard]] T ElementAt(int row, int col) const;
+	[[nodiscard]] size_t GetNonZeroElementsCount() const;
+	[[nodiscard]] size_t GetRowCount() const;
+	[[nodiscard]] size_t GetColCount() const;
+	void Multiply(const T *x, T *y) const;
+	[[nodiscard]] std::vector<T> Multiply(const std::vector<T> &x) const;
+	void ParallelMultiply(const T *x, T *y, ThreadPool &pool = ThreadPool::Default()) const;
+	void MultiplyTransposed(const T *x, T *y) const;
+	void MultiplyDenseBlock(const T *x, size_t vectorCount, T *y) const;
+	[[nodiscard]] CSRSparseMatrix<T, Index> ToCSRSparseMatrix() const;
+	[[nodiscard]] const size_t *GetRowPointers() const;
+	[[nodiscard]] const Index *GetColIndices() const;
+	[[nodiscard]] const T *GetValues() const;
+private:
+	MemoryMappedFile _file;
+	size_t _rowCount;
+	size_t _colCount;
+	size_t _nonZeroElementsCount;
+	const size_t *_rowPtr;
+	const Index *_colIdx;
+	const T *_values;
+};
+
+template<typename T, typename Index>
+MappedCSRSparseMatrix<T, Index>::MappedCSRSparseMatrix(const std::string &path, const SnapshotVerification verification)
+	: _file(path)
+{
+	const auto *data = _file.GetData();
+	const auto layout = BinarySnapshot::Validate<T, Index>(data, _file.GetSize(), verification);
+	SnapshotHeader header;
+	std::memcpy(&header, data, sizeof(header));
+	_rowCount = header.RowCount;
+	_colCount = header.ColCount;
+	_nonZeroElementsCount = header.NonZeroElementsCount;
+	_rowPtr = reinterpret_cast<const size_t *>(data + layout.RowPtrOffset);
+	_colIdx = reinterpret_cast<const Index *>(data + layout.ColIdxOffset);
+	_values = reinterpret_cast<const T *>(data + layout.ValuesOffset);
+}
+
+template<typename T, typename Index>
+T MappedCSRSparseMatrix<T, Index>::ElementAt(int row, int col) const
+{
+	if (row < 0 || col < 0 || static_cast<size_t>(row) >= _rowCount || static_cast<size_t>(col) >= _colCount)
+	{
+		throw std::invalid_argument("Element indices are out of bounds");
+	}
+	const auto *rowEnd = _colIdx + _rowPtr[row + 1];
+	const auto *pos = std::lower_bound(_colIdx + _rowPtr[row], rowEnd, static_cast<Index>(col));
+	if (pos != rowEnd && *pos == static_cast<Index>(col))
+	{
+		return _values[pos - _colIdx];
+	}
+	return T();
+}
+
+template<typename T, typename Index>
+size_t MappedCSRSparseMatrix<T, Index>::GetNonZeroElementsCount() const
+{
+	return _nonZeroElementsCount;
+}
+
+template<typename T, typename Index>
+size_t MappedCSRSparseMatrix<T, Index>::GetRowCount() const
+{
+	return _rowCount;
+}
+
+template<typename T, typename Index>
+size_t MappedCSRSparseMatrix<T, Index>::GetColCount() const
+{
+	return _colCount;
+}
+
+template<typename T, typename Index>
+void MappedCSRSparseMatrix<T, Index>::Multiply(const T *x, T *y) const
+{
+	MultiplyRowsByVector(_rowPtr, _colIdx, _values, x, y, 0, _rowCount);
+}
+
+template<typename T, typename Index>
+std::vector<T> MappedCSRSparseMatrix<T, Index>::Multiply(const std::vector<T> &x) const
+{
+	if (x.size() != _colCount)
+	{
+		throw std::invalid_argument("Invalid argument: vector size doesn't match matrix column count");
+	}
+	std::vector<T> y(_rowCount);
+	Multiply(x.data(), y.data());
+	return y;
+}
+
+template<typename T, typename Index>
+void MappedCSRSparseMatrix<T, Index>::ParallelMultiply(const T *x, T *y, ThreadPool &pool) const
+{
+	const auto boundaries = PartitionRowsByNonZeros(_rowPtr, _rowCount, 4 * pool.GetThreadCount());
+	pool.ParallelFor(boundaries.size() - 1,
+		[&](size_t block, size_t)
+		{
+			MultiplyRowsByVector(_rowPtr, _colIdx, _values, x, y, boundaries[block], boundaries[block + 1]);
+		});
+}
+
+template<typename T, typename Index>
+void MappedCSRSparseMatrix<T, Index>::MultiplyTransposed(const T *x, T *y) const
+{
+	MultiplyColumnsByVector(_rowPtr, _colIdx, _values, x, y, _rowCount, _colCount);
+}
+
+template<typename T, typename Index>
+void MappedCSRSparseMatrix<T, Index>::MultiplyDenseBlock(const T *x, const size_t vectorCount, T *y) const
+{
+	MultiplyRowsByDenseBlock(_rowPtr, _colIdx, _values, x, vectorCount, y, 0, _rowCount);
+}
+
+/**
+ * Copies mapped arrays into ordinary modifiable matrix
+ */
+template<typename T, typename Index>
+CSRSparseMatrix<T, Index> MappedCSRSparseMatrix<T, Index>::ToCSRSparseMatrix() const
+{
+	CSRSparseMatrix<T, Index> result(_rowCount, _colCount);
+	result._rowPtr.assign(_rowPtr, _rowPtr + _rowCount + 1);
+	result._colIdx.assign(_colIdx, _colIdx + _nonZeroElementsCount);
+	result._values.assign(_values, _values + _nonZeroElementsCount);
+	return result;
+}
+
+template<typename T, typename Index>
+const size_t *MappedCSRSparseMatrix<T, Index>::GetRowPointers() const
+{
+	return _rowPtr;
+}
+
+template<typename T, typename Index>
+const Index *MappedCSRSparseMatrix<T, Index>::GetColIndices() const
+{
+	return _colIdx;
+}
+
+template<typename T, typename Index>
+const T *MappedCSRSparseMatrix<T, Index>::GetValues() const
+{
+	return _values;
+}
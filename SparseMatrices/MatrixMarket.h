@@ -0,0 +1,734 @@
+/**
+	Matrix Market (.mtx) reader and writer
+
+	Author: Belousov K.
+	Repository: https://github.com/kombuchamp/SparseMatrices
+*/
+
+#pragma once
+#include <stdexcept>
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "CSRSparseMatrix.h"
+#include "MemoryMappedFile.h"
+#include "ThreadPool.h"
+#include "Triplets.h"
+
+enum class MatrixMarketFormat
+{
+	Coordinate,
+	Array
+};
+
+enum class MatrixMarketField
+{
+	Real,
+	Integer,
+	Pattern
+};
+
+enum class MatrixMarketSymmetry
+{
+	General,
+	Symmetric,
+	SkewSymmetric
+};
+
+struct MatrixMarketHeader
+{
+	MatrixMarketFormat Format = MatrixMarketFormat::Coordinate;
+	MatrixMarketField Field = MatrixMarketField::Real;
+	MatrixMarketSymmetry Symmetry = MatrixMarketSymmetry::General;
+	size_t RowCount = 0;
+	size_t ColCount = 0;
+	// Number of stored entries: nonzeros for coordinate format, values for array format
+	size_t EntryCount = 0;
+};
+
+/**
+ * Reads and writes real, integer and pattern matrices in coordinate and array formats
+ * with general, symmetric and skew-symmetric storage. Complex and hermitian matrices are not supported.
+ * Numbers are parsed with std::from_chars, which doesn't depend on locale.
+ * Stream is read in large blocks and matrix is built straight into CSR arrays,
+ * duplicate entries are summed up, explicit zeros are dropped.
+ */
+class MatrixMarket
+{
+public:
+	template<typename T>
+	[[nodiscard]] static CSRSparseMatrix<T> Read(std::istream &is);
+	template<typename T>
+	[[nodiscard]] static CSRSparseMatrix<T> ReadFile(const std::string &path);
+	template<typename T>
+	[[nodiscard]] static CSRSparseMatrix<T> ReadFileParallel(const std::string &path, ThreadPool &pool = ThreadPool::Default());
+	template<typename T, typename Index>
+	static void Write(std::ostream &os, const CSRSparseMatrix<T, Index> &mat,
+		MatrixMarketFormat format = MatrixMarketFormat::Coordinate,
+		MatrixMarketSymmetry symmetry = MatrixMarketSymmetry::General,
+		MatrixMarketField field = DefaultField<T>());
+	template<typename T, typename Index>
+	static void WriteFile(const std::string &path, const CSRSparseMatrix<T, Index> &mat,
+		MatrixMarketFormat format = MatrixMarketFormat::Coordinate,
+		MatrixMarketSymmetry symmetry = MatrixMarketSymmetry::General,
+		MatrixMarketField field = DefaultField<T>());
+	template<typename T>
+	[[nodiscard]] static constexpr MatrixMarketField DefaultField()
+	{
+		return std::is_integral<T>::value ? MatrixMarketField::Integer : MatrixMarketField::Real;
+	}
+private:
+	/**
+	 * Splits stream into lines without copying them into separate strings
+	 */
+	class LineReader
+	{
+	public:
+		explicit LineReader(std::istream &is, const size_t blockSize = 1 << 20)
+			: _is(is), _buffer(blockSize), _begin(0), _end(0)
+		{
+		}
+		bool Next(std::string_view &line)
+		{
+			while (true)
+			{
+				const auto *begin = _buffer.data() + _begin;
+				const auto *newLine = static_cast<const char *>(std::memchr(begin, '\n', _end - _begin));
+				if (newLine != nullptr)
+				{
+					line = TrimCarriageReturn(std::string_view(begin, newLine - begin));
+					_begin = newLine - _buffer.data() + 1;
+					return true;
+				}
+				if (!_is)
+				{
+					if (_begin == _end)
+					{
+						return false;
+					}
+					line = TrimCarriageReturn(std::string_view(begin, _end - _begin));
+					_begin = _end;
+					return true;
+				}
+				// Move incomplete line to the front and read next block after it
+				std::copy(_buffer.begin() + _begin, _buffer.begin() + _end, _buffer.begin());
+				_end -= _begin;
+				_begin = 0;
+				if (_end == _buffer.size())
+				{
+					_buffer.resize(2 * _buffer.size());
+				}
+				_is.read(_buffer.data() + _end, _buffer.size() - _end);
+				_end += static_cast<size_t>(_is.gcount());
+			}
+		}
+	private:
+		static std::string_view TrimCarriageReturn(std::string_view line)
+		{
+			return !line.empty() && line.back() == '\r' ? line.substr(0, line.size() - 1) : line;
+		}
+		std::istream &_is;
+		std::vector<char> _buffer;
+		size_t _begin;
+		size_t _end;
+	};
+
+	template<typename T>
+	using Triplets = std::vector<Triplet<T>>;
+
+	// Position of the next value in array format
+	struct ArrayCursor
+	{
+		size_t Row = 0;
+		size_t Col = 0;
+	};
+
+	static MatrixMarketHeader ParseBanner(std::string_view line);
+	template<typename T>
+	static void ThrowIfFieldDoesNotFit(const MatrixMarketHeader &header);
+	static void ParseSizeLine(std::string_view line, MatrixMarketHeader &header);
+	template<typename T, typename Index>
+	static bool MatchesSymmetry(const CSRSparseMatrix<T, Index> &mat, MatrixMarketSymmetry symmetry, MatrixMarketField field);
+	template<typename T>
+	static void ParseEntry(std::string_view line, const MatrixMarketHeader &header, ArrayCursor &cursor, Triplets<T> &triplets);
+	template<typename T>
+	static void AddEntry(const MatrixMarketHeader &header, size_t row, size_t col, T value, Triplets<T> &triplets);
+	template<typename T>
+	static CSRSparseMatrix<T> BuildCSRParallel(const MatrixMarketHeader &header, std::vector<Triplets<T>> &chunks, ThreadPool &pool);
+	static std::string_view NextLine(const char *data, size_t size, size_t &pos);
+	static bool IsBlank(std::string_view line);
+	static const char *SkipSpaces(const char *p, const char *end);
+	template<typename Number>
+	static const char *ParseNumber(const char *p, const char *end, Number &value);
+	template<typename Number>
+	static void WriteNumber(std::ostream &os, const Number &value);
+};
+
+template<typename T>
+CSRSparseMatrix<T> MatrixMarket::Read(std::istream &is)
+{
+	LineReader reader(is);
+	std::string_view line;
+	if (!reader.Next(line))
+	{
+		throw std::invalid_argument("Matrix Market stream is empty");
+	}
+	auto header = ParseBanner(line);
+	ThrowIfFieldDoesNotFit<T>(header);
+
+	do
+	{
+		if (!reader.Next(line))
+		{
+			throw std::invalid_argument("Matrix Market size line is missing");
+		}
+	} while (IsBlank(line) || line.front() == '%');
+	ParseSizeLine(line, header);
+
+	Triplets<T> triplets;
+	const auto expectedNonZeros = header.Symmetry == MatrixMarketSymmetry::General ? header.EntryCount : 2 * header.EntryCount;
+	triplets.reserve(expectedNonZeros);
+
+	size_t entryIndex = 0;
+	ArrayCursor cursor;
+	cursor.Row = header.Symmetry == MatrixMarketSymmetry::SkewSymmetric ? 1 : 0;
+	while (reader.Next(line))
+	{
+		if (IsBlank(line) || line.front() == '%')
+		{
+			continue;
+		}
+		if (entryIndex == header.EntryCount)
+		{
+			throw std::invalid_argument("Matrix Market stream has more entries than declared");
+		}
+		ParseEntry(line, header, cursor, triplets);
+		++entryIndex;
+	}
+	if (entryIndex != header.EntryCount)
+	{
+		throw std::invalid_argument("Matrix Market stream has less entries than declared");
+	}
+	return CSRSparseMatrix<T>::FromTriplets(header.RowCount, header.ColCount, triplets.begin(), triplets.end());
+}
+
+template<typename T>
+CSRSparseMatrix<T> MatrixMarket::ReadFile(const std::string &path)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file)
+	{
+		throw std::invalid_argument("Can't open file " + path);
+	}
+	return Read<T>(file);
+}
+
+/**
+ * Maps the file into memory and parses coordinate entries by several threads at once.
+ * File body is split into chunks at line boundaries, every chunk is parsed into its own triplets,
+ * then all triplets are radix sorted by position in parallel.
+ * Array format has implicit positions of values, so it is parsed by one thread.
+ */
+template<typename T>
+CSRSparseMatrix<T> MatrixMarket::ReadFileParallel(const std::string &path, ThreadPool &pool)
+{
+	MemoryMappedFile file(path);
+	const auto *data = file.GetData();
+	const auto size = file.GetSize();
+
+	size_t pos = 0;
+	if (size == 0)
+	{
+		throw std::invalid_argument("Matrix Market stream is empty");
+	}
+	auto header = ParseBanner(NextLine(data, size, pos));
+	ThrowIfFieldDoesNotFit<T>(header);
+	std::string_view line;
+	do
+	{
+		if (pos == size)
+		{
+			throw std::invalid_argument("Matrix Market size line is missing");
+		}
+		line = NextLine(data, size, pos);
+	} while (IsBlank(line) || line.front() == '%');
+	ParseSizeLine(line, header);
+
+	const auto chunkCount = header.Format == MatrixMarketFormat::Coordinate
+		? std::max<size_t>(1, std::min(4 * pool.GetThreadCount(), (size - pos) / (1 << 16)))
+		: 1;
+	std::vector<size_t> chunkBegin(chunkCount + 1, size);
+	chunkBegin[0] = pos;
+	for (size_t c = 1; c < chunkCount; c++)
+	{
+		auto begin = std::max(chunkBegin[c - 1], pos + (size - pos) / chunkCount * c);
+		while (begin < size && data[begin - 1] != '\n')
+		{
+			++begin;
+		}
+		chunkBegin[c] = begin;
+	}
+
+	std::vector<Triplets<T>> chunks(chunkCount);
+	std::vector<size_t> entryCounts(chunkCount, 0);
+	pool.ParallelFor(chunkCount,
+		[&](size_t c, size_t)
+		{
+			ArrayCursor cursor;
+			cursor.Row = header.Symmetry == MatrixMarketSymmetry::SkewSymmetric ? 1 : 0;
+			auto linePos = chunkBegin[c];
+			while (linePos < chunkBegin[c + 1])
+			{
+				const auto entry = NextLine(data, chunkBegin[c + 1], linePos);
+				if (IsBlank(entry) || entry.front() == '%')
+				{
+					continue;
+				}
+				if (header.Format == MatrixMarketFormat::Array && entryCounts[c] == header.EntryCount)
+				{
+					throw std::invalid_argument("Matrix Market stream has more entries than declared");
+				}
+				ParseEntry(entry, header, cursor, chunks[c]);
+				++entryCounts[c];
+			}
+		});
+
+	size_t entryCount = 0;
+	for (auto count : entryCounts)
+	{
+		entryCount += count;
+	}
+	if (entryCount > header.EntryCount)
+	{
+		throw std::invalid_argument("Matrix Market stream has more entries than declared");
+	}
+	if (entryCount < header.EntryCount)
+	{
+		throw std::invalid_argument("Matrix Market stream has less entries than declared");
+	}
+	return BuildCSRParallel(header, chunks, pool);
+}
+
+template<typename T, typename Index>
+void MatrixMarket::Write(std::ostream &os, const CSRSparseMatrix<T, Index> &mat,
+	const MatrixMarketFormat format, const MatrixMarketSymmetry symmetry, const MatrixMarketField field)
+{
+	if (format == MatrixMarketFormat::Array && field == MatrixMarketField::Pattern)
+	{
+		throw std::invalid_argument("Pattern matrices can only be written in coordinate format");
+	}
+	if (symmetry != MatrixMarketSymmetry::General && mat.GetRowCount() != mat.GetColCount())
+	{
+		throw std::invalid_argument("Only square matrices can be written as symmetric");
+	}
+	if (field == MatrixMarketField::Integer && !std::is_integral<T>::value)
+	{
+		throw std::invalid_argument("Matrix with floating point values can't be written as integer");
+	}
+	if (symmetry != MatrixMarketSymmetry::General && !MatchesSymmetry(mat, symmetry, field))
+	{
+		throw std::invalid_argument("Matrix doesn't have the symmetry it is written with");
+	}
+	const char *formatName = format == MatrixMarketFormat::Coordinate ? "coordinate" : "array";
+	const char *fieldName = field == MatrixMarketField::Real ? "real" : field == MatrixMarketField::Integer ? "integer" : "pattern";
+	const char *symmetryName = symmetry == MatrixMarketSymmetry::General ? "general"
+		: symmetry == MatrixMarketSymmetry::Symmetric ? "symmetric" : "skew-symmetric";
+	os << "%%MatrixMarket matrix " << formatName << " " << fieldName << " " << symmetryName << "\n";
+
+	const auto &rowPtr = mat.GetRowPointers();
+	const auto &colIdx = mat.GetColIndices();
+	const auto &values = mat.GetValues();
+	// Symmetric matrices store lower triangle only, skew-symmetric ones don't store the diagonal either
+	const auto stored = [symmetry](size_t row, size_t col)
+	{
+		return symmetry == MatrixMarketSymmetry::General
+			|| (symmetry == MatrixMarketSymmetry::Symmetric && row >= col)
+			|| (symmetry == MatrixMarketSymmetry::SkewSymmetric && row > col);
+	};
+
+	if (format == MatrixMarketFormat::Coordinate)
+	{
+		size_t entryCount = 0;
+		for (size_t i = 0; i < mat.GetRowCount(); i++)
+		{
+			for (auto k = rowPtr[i]; k < rowPtr[i + 1]; k++)
+			{
+				entryCount += stored(i, colIdx[k]) ? 1 : 0;
+			}
+		}
+		os << mat.GetRowCount() << " " << mat.GetColCount() << " " << entryCount << "\n";
+		for (size_t i = 0; i < mat.GetRowCount(); i++)
+		{
+			for (auto k = rowPtr[i]; k < rowPtr[i + 1]; k++)
+			{
+				if (!stored(i, colIdx[k]))
+				{
+					continue;
+				}
+				WriteNumber(os, i + 1);
+				os.put(' ');
+				WriteNumber(os, static_cast<size_t>(colIdx[k]) + 1);
+				if (field != MatrixMarketField::Pattern)
+				{
+					os.put(' ');
+					WriteNumber(os, values[k]);
+				}
+				os.put('\n');
+			}
+		}
+		return;
+	}
+
+	os << mat.GetRowCount() << " " << mat.GetColCount() << "\n";
+	for (size_t j = 0; j < mat.GetColCount(); j++)
+	{
+		for (size_t i = 0; i < mat.GetRowCount(); i++)
+		{
+			if (stored(i, j))
+			{
+				WriteNumber(os, mat.ElementAt(i, j));
+				os.put('\n');
+			}
+		}
+	}
+}
+
+/**
+ * Symmetric and skew-symmetric files store one triangle, so A should equal A^T or -A^T for the other one
+ * not to be lost. Pattern matrices are compared by pattern only.
+ */
+template<typename T, typename Index>
+bool MatrixMarket::MatchesSymmetry(const CSRSparseMatrix<T, Index> &mat, const MatrixMarketSymmetry symmetry, const MatrixMarketField field)
+{
+	const auto transposed = mat.Transposed();
+	if (transposed.GetRowPointers() != mat.GetRowPointers() || transposed.GetColIndices() != mat.GetColIndices())
+	{
+		return false;
+	}
+	const auto &values = mat.GetValues();
+	const auto &transposedValues = transposed.GetValues();
+	const auto skew = symmetry == MatrixMarketSymmetry::SkewSymmetric;
+	const auto &rowPtr = mat.GetRowPointers();
+	const auto &colIdx = mat.GetColIndices();
+	for (size_t i = 0; i < mat.GetRowCount(); i++)
+	{
+		for (auto k = rowPtr[i]; k < rowPtr[i + 1]; k++)
+		{
+			if (skew && colIdx[k] == i)
+			{
+				return false;
+			}
+			if (field != MatrixMarketField::Pattern && values[k] != (skew ? -transposedValues[k] : transposedValues[k]))
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+template<typename T, typename Index>
+void MatrixMarket::WriteFile(const std::string &path, const CSRSparseMatrix<T, Index> &mat,
+	const MatrixMarketFormat format, const MatrixMarketSymmetry symmetry, const MatrixMarketField field)
+{
+	std::ofstream file(path, std::ios::binary);
+	if (!file)
+	{
+		throw std::invalid_argument("Can't open file " + path);
+	}
+	Write(file, mat, format, symmetry, field);
+}
+
+inline MatrixMarketHeader MatrixMarket::ParseBanner(std::string_view line)
+{
+	std::vector<std::string> words;
+	for (size_t pos = 0; pos < line.size();)
+	{
+		const auto begin = line.find_first_not_of(" \t", pos);
+		if (begin == std::string_view::npos)
+		{
+			break;
+		}
+		const auto end = std::min(line.find_first_of(" \t", begin), line.size());
+		std::string word(line.substr(begin, end - begin));
+		std::transform(word.begin(), word.end(), word.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+		words.push_back(word);
+		pos = end;
+	}
+	if (words.size() != 5 || words[0] != "%%matrixmarket" || words[1] != "matrix")
+	{
+		throw std::invalid_argument("Invalid Matrix Market banner");
+	}
+
+	MatrixMarketHeader header;
+	if (words[2] == "coordinate")
+	{
+		header.Format = MatrixMarketFormat::Coordinate;
+	}
+	else if (words[2] == "array")
+	{
+		header.Format = MatrixMarketFormat::Array;
+	}
+	else
+	{
+		throw std::invalid_argument("Unsupported Matrix Market format: " + words[2]);
+	}
+
+	if (words[3] == "real" || words[3] == "double")
+	{
+		header.Field = MatrixMarketField::Real;
+	}
+	else if (words[3] == "integer")
+	{
+		header.Field = MatrixMarketField::Integer;
+	}
+	else if (words[3] == "pattern" && header.Format == MatrixMarketFormat::Coordinate)
+	{
+		header.Field = MatrixMarketField::Pattern;
+	}
+	else
+	{
+		throw std::invalid_argument("Unsupported Matrix Market field: " + words[3]);
+	}
+
+	if (words[4] == "general")
+	{
+		header.Symmetry = MatrixMarketSymmetry::General;
+	}
+	else if (words[4] == "symmetric")
+	{
+		header.Symmetry = MatrixMarketSymmetry::Symmetric;
+	}
+	else if (words[4] == "skew-symmetric")
+	{
+		header.Symmetry = MatrixMarketSymmetry::SkewSymmetric;
+	}
+	else
+	{
+		throw std::invalid_argument("Unsupported Matrix Market symmetry: " + words[4]);
+	}
+	return header;
+}
+
+/**
+ * Real values can't be read into an integer matrix without losing their fractional part
+ */
+template<typename T>
+void MatrixMarket::ThrowIfFieldDoesNotFit(const MatrixMarketHeader &header)
+{
+	if (std::is_integral<T>::value && header.Field == MatrixMarketField::Real)
+	{
+		throw std::invalid_argument("Real Matrix Market matrix can't be read into integer matrix");
+	}
+}
+
+inline void MatrixMarket::ParseSizeLine(std::string_view line, MatrixMarketHeader &header)
+{
+	const auto *p = line.data();
+	const auto *end = line.data() + line.size();
+	p = ParseNumber(p, end, header.RowCount);
+	p = ParseNumber(p, end, header.ColCount);
+	if (header.Format == MatrixMarketFormat::Coordinate)
+	{
+		ParseNumber(p, end, header.EntryCount);
+		return;
+	}
+
+	const auto n = header.RowCount;
+	switch (header.Symmetry)
+	{
+	case MatrixMarketSymmetry::General:
+		header.EntryCount = header.RowCount * header.ColCount;
+		break;
+	case MatrixMarketSymmetry::Symmetric:
+		header.EntryCount = n * (n + 1) / 2;
+		break;
+	case MatrixMarketSymmetry::SkewSymmetric:
+		header.EntryCount = n * (n - (n > 0 ? 1 : 0)) / 2;
+		break;
+	}
+	if (header.Symmetry != MatrixMarketSymmetry::General && header.RowCount != header.ColCount)
+	{
+		throw std::invalid_argument("Symmetric Matrix Market matrix should be square");
+	}
+}
+
+template<typename T>
+void MatrixMarket::ParseEntry(std::string_view line, const MatrixMarketHeader &header, ArrayCursor &cursor, Triplets<T> &triplets)
+{
+	const auto *p = line.data();
+	const auto *end = line.data() + line.size();
+	T value = T(1);
+
+	if (header.Format == MatrixMarketFormat::Coordinate)
+	{
+		size_t row;
+		size_t col;
+		p = ParseNumber(p, end, row);
+		p = ParseNumber(p, end, col);
+		if (row == 0 || col == 0 || row > header.RowCount || col > header.ColCount)
+		{
+			throw std::invalid_argument("Matrix Market entry indices are out of bounds");
+		}
+		if (header.Field != MatrixMarketField::Pattern)
+		{
+			ParseNumber(p, end, value);
+		}
+		AddEntry(header, row - 1, col - 1, value, triplets);
+		return;
+	}
+
+	// Array format lists values column by column, symmetric matrices list lower triangle only
+	ParseNumber(p, end, value);
+	AddEntry(header, cursor.Row, cursor.Col, value, triplets);
+	if (++cursor.Row == header.RowCount)
+	{
+		++cursor.Col;
+		cursor.Row = 0;
+		if (header.Symmetry != MatrixMarketSymmetry::General)
+		{
+			cursor.Row = cursor.Col + (header.Symmetry == MatrixMarketSymmetry::SkewSymmetric ? 1 : 0);
+		}
+	}
+}
+
+template<typename T>
+void MatrixMarket::AddEntry(const MatrixMarketHeader &header, const size_t row, const size_t col, T value, Triplets<T> &triplets)
+{
+	if (value == T())
+	{
+		return;
+	}
+	if (header.Symmetry != MatrixMarketSymmetry::General && row < col)
+	{
+		throw std::invalid_argument("Symmetric Matrix Market matrix should list lower triangle only");
+	}
+	if (header.Symmetry == MatrixMarketSymmetry::SkewSymmetric && row == col)
+	{
+		throw std::invalid_argument("Skew-symmetric Matrix Market matrix can't have diagonal entries");
+	}
+	triplets.push_back(Triplet<T>{ row, col, value });
+	if (header.Symmetry != MatrixMarketSymmetry::General && row != col)
+	{
+		if constexpr (std::is_unsigned<T>::value)
+		{
+			if (header.Symmetry == MatrixMarketSymmetry::SkewSymmetric)
+			{
+				throw std::invalid_argument("Skew-symmetric matrix can't be read into unsigned type");
+			}
+			triplets.push_back(Triplet<T>{ col, row, value });
+		}
+		else
+		{
+			triplets.push_back(Triplet<T>{ col, row, header.Symmetry == MatrixMarketSymmetry::SkewSymmetric ? -value : value });
+		}
+	}
+}
+
+/**
+ * Builds CSR from triplets split into several chunks, duplicates are summed up.
+ * Chunks are turned into keyed values in parallel and released on the way,
+ * then sorted by parallel radix sort on row-major position.
+ */
+template<typename T>
+CSRSparseMatrix<T> MatrixMarket::BuildCSRParallel(const MatrixMarketHeader &header, std::vector<Triplets<T>> &chunks, ThreadPool &pool)
+{
+	std::vector<size_t> chunkOffset(chunks.size() + 1, 0);
+	for (size_t c = 0; c < chunks.size(); c++)
+	{
+		chunkOffset[c + 1] = chunkOffset[c] + chunks[c].size();
+	}
+	std::vector<KeyedValue<T>> items(chunkOffset.back());
+	pool.ParallelFor(chunks.size(),
+		[&](size_t c, size_t)
+		{
+			auto *dest = items.data() + chunkOffset[c];
+			for (auto &triplet : chunks[c])
+			{
+				*dest++ = KeyedValue<T>{ LinearPosition(triplet.Row, triplet.Col, header.ColCount), triplet.Value };
+			}
+			Triplets<T>().swap(chunks[c]);
+		});
+	SortAndMergeByKey(items, LinearPosition(header.RowCount, 0, header.ColCount), TripletOrder::Unsorted, DuplicatePolicy::Sum, pool);
+	return CSRSparseMatrix<T>::FromSortedKeys(header.RowCount, header.ColCount, items);
+}
+
+/**
+ * Returns line starting at pos and moves pos past its end of line
+ */
+inline std::string_view MatrixMarket::NextLine(const char *data, const size_t size, size_t &pos)
+{
+	const auto *begin = data + pos;
+	const auto *newLine = static_cast<const char *>(std::memchr(begin, '\n', size - pos));
+	const auto *end = newLine != nullptr ? newLine : data + size;
+	pos = newLine != nullptr ? newLine - data + 1 : size;
+	if (end != begin && *(end - 1) == '\r')
+	{
+		--end;
+	}
+	return std::string_view(begin, end - begin);
+}
+
+inline bool MatrixMarket::IsBlank(std::string_view line)
+{
+	return line.find_first_not_of(" \t") == std::string_view::npos;
+}
+
+inline const char *MatrixMarket::SkipSpaces(const char *p, const char *end)
+{
+	while (p != end && (*p == ' ' || *p == '\t'))
+	{
+		++p;
+	}
+	return p;
+}
+
+template<typename Number>
+const char *MatrixMarket::ParseNumber(const char *p, const char *end, Number &value)
+{
+	p = SkipSpaces(p, end);
+	if (p != end && *p == '+')
+	{
+		++p;
+	}
+	std::from_chars_result result{};
+	if constexpr (std::is_integral<Number>::value || std::is_floating_point<Number>::value)
+	{
+		result = std::from_chars(p, end, value);
+	}
+	else
+	{
+		double parsed;
+		result = std::from_chars(p, end, parsed);
+		value = Number(parsed);
+	}
+	// Number should take the whole token, so "1.75" isn't read as 1 by an integer parser
+	if (result.ec != std::errc() || (result.ptr != end && *result.ptr != ' ' && *result.ptr != '\t'))
+	{
+		throw std::invalid_argument("Invalid number in Matrix Market stream: " + std::string(p, end));
+	}
+	return result.ptr;
+}
+
+template<typename Number>
+void MatrixMarket::WriteNumber(std::ostream &os, const Number &value)
+{
+	if constexpr (std::is_integral<Number>::value || std::is_floating_point<Number>::value)
+	{
+		char buffer[64];
+		const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+		os.write(buffer, result.ptr - buffer);
+	}
+	else
+	{
+		os << value;
+	}
+}
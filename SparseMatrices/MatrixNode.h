@@ -1,13 +1,15 @@
 #pragma once
 
-template<typename T>
+#include <cstddef>
+
+template<typename T, typename Index = size_t>
 struct MatrixNode
 {
 	MatrixNode(const size_t row, const size_t col, T const &val)
-		: Row(row), Col(col), Value(val)
+		: Row(static_cast<Index>(row)), Col(static_cast<Index>(col)), Value(val)
 	{
 	}
-	size_t Row;
-	size_t Col;
+	Index Row;
+	Index Col;
 	T Value;
 };
\ No newline at end of file
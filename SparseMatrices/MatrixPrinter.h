@@ -0,0 +1,151 @@
+/**
+	Text output of sparse matrices
+
+	Author: Belousov K.
+	Repository: https://github.com/kombuchamp/SparseMatrices
+*/
+
+#pragma once
+#include <algorithm>
+#include <ostream>
+#include <vector>
+
+enum class PrintMode
+{
+	// Every element including zeros, rows * cols writes
+	Dense,
+	// Dense top-left window, whole matrix if it fits
+	Preview,
+	// "rows cols nonzeros" line, then "row col value" line per nonzero element
+	Coordinate,
+	// "row: col:value col:value ..." line per nonempty row
+	CompactRows
+};
+
+struct PrintOptions
+{
+	PrintMode Mode = PrintMode::Preview;
+	size_t PreviewRows = 16;
+	size_t PreviewCols = 16;
+};
+
+/**
+ * Writes matrix in the requested mode touching only nonzero elements (and the preview window).
+ * forEachNonZero(visit) should call visit(row, col, value) for nonzero elements in row-major order
+ * and stop as soon as visit returns false. Indices are zero-based.
+ */
+template<typename T, typename ForEachNonZero>
+void PrintSparse(std::ostream &os, const size_t rowCount, const size_t colCount, const size_t nonZeroElementsCount,
+	const PrintOptions &options, ForEachNonZero &&forEachNonZero)
+{
+	switch (options.Mode)
+	{
+	case PrintMode::Coordinate:
+		os << rowCount << " " << colCount << " " << nonZeroElementsCount << "\n";
+		forEachNonZero([&](size_t row, size_t col, const T &value)
+			{
+				os << row << " " << col << " " << value << "\n";
+				return true;
+			});
+		return;
+	case PrintMode::CompactRows:
+	{
+		auto first = true;
+		size_t currentRow = 0;
+		forEachNonZero([&](size_t row, size_t col, const T &value)
+			{
+				if (first || row != currentRow)
+				{
+					os << (first ? "" : "\n") << row << ":";
+					first = false;
+					currentRow = row;
+				}
+				os << " " << col << ":" << value;
+				return true;
+			});
+		if (!first)
+		{
+			os << "\n";
+		}
+		return;
+	}
+	default:
+		break;
+	}
+
+	const auto dense = options.Mode == PrintMode::Dense;
+	const auto windowRows = dense ? rowCount : std::min(rowCount, options.PreviewRows);
+	const auto windowCols = dense ? colCount : std::min(colCount, options.PreviewCols);
+	const auto truncated = windowRows < rowCount || windowCols < colCount;
+	if (truncated)
+	{
+		os << rowCount << " x " << colCount << ", " << nonZeroElementsCount << " nonzero elements\n";
+	}
+
+	std::vector<T> line(windowCols, T());
+	size_t printedRows = 0;
+	const auto flushRow = [&]()
+	{
+		for (auto &value : line)
+		{
+			os << value << " ";
+			value = T();
+		}
+		os << (windowCols < colCount ? "...\n" : "\n");
+		++printedRows;
+	};
+	forEachNonZero([&](size_t row, size_t col, const T &value)
+		{
+			if (row >= windowRows)
+			{
+				return false;
+			}
+			while (printedRows < row)
+			{
+				flushRow();
+			}
+			if (col < windowCols)
+			{
+				line[col] = value;
+			}
+			return true;
+		});
+	while (printedRows < windowRows)
+	{
+		flushRow();
+	}
+	if (windowRows < rowCount)
+	{
+		os << "...\n";
+	}
+}
+
+/**
+ * Preview mode for storage that can't list elements in row-major order without sorting them.
+ * forEachInWindow(windowRows, windowCols, visit) should call visit(row, col, value) for nonzero elements
+ * with row < windowRows and col < windowCols, in any order; they are gathered into a dense window
+ * and printed as PrintSparse does, so only the window is touched, not the whole matrix.
+ */
+template<typename T, typename ForEachInWindow>
+void PrintPreview(std::ostream &os, const size_t rowCount, const size_t colCount, const size_t nonZeroElementsCount,
+	const PrintOptions &options, ForEachInWindow &&forEachInWindow)
+{
+	const auto windowRows = std::min(rowCount, options.PreviewRows);
+	const auto windowCols = std::min(colCount, options.PreviewCols);
+	std::vector<T> window(windowRows * windowCols, T());
+	forEachInWindow(windowRows, windowCols, [&](size_t row, size_t col, const T &value)
+		{
+			window[row * windowCols + col] = value;
+		});
+	PrintSparse<T>(os, rowCount, colCount, nonZeroElementsCount, options,
+		[&](auto &&visit)
+		{
+			for (size_t i = 0; i < window.size(); i++)
+			{
+				if (window[i] != T() && !visit(i / windowCols, i % windowCols, window[i]))
+				{
+					return;
+				}
+			}
+		});
+}
@@ -0,0 +1,161 @@
+/**
+	Read-only memory mapped file
+
+	Author: Belousov K.
+	Repository: https://github.com/kombuchamp/SparseMatrices
+*/
+
+#pragma once
+#include <stdexcept>
+#include <string>
+#include <utility>
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * Maps the whole file into memory for reading. Pages are loaded by the OS on first access,
+ * so parts of the file can be processed by different threads without any copying.
+ */
+class MemoryMappedFile
+{
+public:
+	explicit MemoryMappedFile(const std::string &path)
+	{
+#if defined(_WIN32)
+		_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (_file == INVALID_HANDLE_VALUE)
+		{
+			throw std::invalid_argument("Can't open file " + path);
+		}
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(_file, &size))
+		{
+			Close();
+			throw std::runtime_error("Can't get size of file " + path);
+		}
+		_size = static_cast<size_t>(size.QuadPart);
+		if (_size == 0)
+		{
+			return;
+		}
+		_mapping = CreateFileMappingA(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (_mapping == nullptr)
+		{
+			Close();
+			throw std::runtime_error("Can't map file " + path);
+		}
+		_data = static_cast<const char *>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+		if (_data == nullptr)
+		{
+			Close();
+			throw std::runtime_error("Can't map file " + path);
+		}
+#else
+		_file = open(path.c_str(), O_RDONLY);
+		if (_file < 0)
+		{
+			throw std::invalid_argument("Can't open file " + path);
+		}
+		struct stat status;
+		if (fstat(_file, &status) != 0)
+		{
+			Close();
+			throw std::runtime_error("Can't get size of file " + path);
+		}
+		_size = static_cast<size_t>(status.st_size);
+		if (_size == 0)
+		{
+			return;
+		}
+		void *data = mmap(nullptr, _size, PROT_READ, MAP_SHARED, _file, 0);
+		if (data == MAP_FAILED)
+		{
+			Close();
+			throw std::runtime_error("Can't map file " + path);
+		}
+		_data = static_cast<const char *>(data);
+		madvise(data, _size, MADV_SEQUENTIAL);
+#endif
+	}
+	MemoryMappedFile(MemoryMappedFile &&other) noexcept
+	{
+		Swap(other);
+	}
+	MemoryMappedFile &operator=(MemoryMappedFile &&other) noexcept
+	{
+		Swap(other);
+		return *this;
+	}
+	MemoryMappedFile(const MemoryMappedFile &) = delete;
+	MemoryMappedFile &operator=(const MemoryMappedFile &) = delete;
+	~MemoryMappedFile()
+	{
+		Close();
+	}
+	[[nodiscard]] const char *GetData() const
+	{
+		return _data;
+	}
+	[[nodiscard]] size_t GetSize() const
+	{
+		return _size;
+	}
+private:
+	void Swap(MemoryMappedFile &other) noexcept
+	{
+		std::swap(_data, other._data);
+		std::swap(_size, other._size);
+		std::swap(_file, other._file);
+#if defined(_WIN32)
+		std::swap(_mapping, other._mapping);
+#endif
+	}
+	void Close()
+	{
+#if defined(_WIN32)
+		if (_data != nullptr)
+		{
+			UnmapViewOfFile(_data);
+		}
+		if (_mapping != nullptr)
+		{
+			CloseHandle(_mapping);
+		}
+		if (_file != INVALID_HANDLE_VALUE)
+		{
+			CloseHandle(_file);
+		}
+		_mapping = nullptr;
+		_file = INVALID_HANDLE_VALUE;
+#else
+		if (_data != nullptr)
+		{
+			munmap(const_cast<char *>(_data), _size);
+		}
+		if (_file >= 0)
+		{
+			close(_file);
+		}
+		_file = -1;
+#endif
+		_data = nullptr;
+		_size = 0;
+	}
+	const char *_data = nullptr;
+	size_t _size = 0;
+#if defined(_WIN32)
+	HANDLE _file = INVALID_HANDLE_VALUE;
+	HANDLE _mapping = nullptr;
+#else
+	int _file = -1;
+#endif
+};
@@ -0,0 +1,202 @@
+/**
+	Slab allocator for linked list nodes
+
+	Author: Belousov K.
+	Repository: https://github.com/kombuchamp/SparseMatrices
+*/
+
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Hands out fixed-size blocks carved from large slabs.
+ * Block size is the requested size rounded up to the requested alignment only (and to fit a free list link),
+ * so 24 and 40 byte list nodes take exactly 24 and 40 bytes of a slab.
+ * Freed blocks go to a free list of their size and are reused by next allocations,
+ * all slabs are returned to the system at once when the pool is destroyed.
+ * Slabs grow geometrically, so small matrices stay small and big ones need few system allocations.
+ * Pool is not thread-safe.
+ */
+class NodePool
+{
+public:
+	NodePool() = default;
+	NodePool(const NodePool &) = delete;
+	NodePool &operator=(const NodePool &) = delete;
+	~NodePool();
+	// alignment should be a power of two not greater than alignof(std::max_align_t)
+	[[nodiscard]] void *Allocate(size_t size, size_t alignment);
+	void Deallocate(void *block, size_t size, size_t alignment) noexcept;
+	[[nodiscard]] size_t GetReservedBytes() const;
+private:
+	static constexpr size_t FirstSlabBlockCount = 64;
+	static constexpr size_t MaxSlabBlockCount = 64 * 1024;
+	struct FreeBlock
+	{
+		FreeBlock *Next;
+	};
+	struct SizeClass
+	{
+		size_t BlockSize;
+		size_t NextSlabBlockCount = FirstSlabBlockCount;
+		FreeBlock *FreeList = nullptr;
+		char *Cursor = nullptr;
+		char *End = nullptr;
+	};
+	[[nodiscard]] static size_t RoundUp(size_t size, size_t alignment);
+	[[nodiscard]] SizeClass &GetSizeClass(size_t blockSize);
+	std::vector<SizeClass> _sizeClasses;
+	std::vector<std::pair<void *, size_t>> _slabs;
+	size_t _reservedBytes = 0;
+};
+
+/**
+ * Standard allocator over shared NodePool. Single objects (list nodes) come from the pool,
+ * arrays fall back to the global operator new.
+ * Rebound copies share the pool, copies of a container get their own pool,
+ * so independent matrices can be used from different threads.
+ */
+template<typename T>
+class NodePoolAllocator
+{
+public:
+	using value_type = T;
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::true_type;
+	using is_always_equal = std::false_type;
+
+	NodePoolAllocator()
+		: _pool(std::make_shared<NodePool>())
+	{
+	}
+	explicit NodePoolAllocator(std::shared_ptr<NodePool> pool)
+		: _pool(std::move(pool))
+	{
+	}
+	// Declared explicitly to suppress implicit move, moved-from allocator should stay usable
+	NodePoolAllocator(const NodePoolAllocator &) noexcept = default;
+	NodePoolAllocator &operator=(const NodePoolAllocator &) noexcept = default;
+	template<typename U>
+	NodePoolAllocator(const NodePoolAllocator<U> &other) noexcept
+		: _pool(other._pool)
+	{
+	}
+	[[nodiscard]] T *allocate(size_t n)
+	{
+		if (n == 1)
+		{
+			return static_cast<T *>(_pool->Allocate(sizeof(T), alignof(T)));
+		}
+		return std::allocator<T>().allocate(n);
+	}
+	void deallocate(T *p, size_t n) noexcept
+	{
+		if (n == 1)
+		{
+			_pool->Deallocate(p, sizeof(T), alignof(T));
+			return;
+		}
+		std::allocator<T>().deallocate(p, n);
+	}
+	[[nodiscard]] NodePoolAllocator select_on_container_copy_construction() const
+	{
+		return NodePoolAllocator();
+	}
+	[[nodiscard]] const std::shared_ptr<NodePool> &GetPool() const
+	{
+		return _pool;
+	}
+	template<typename U>
+	bool operator==(const NodePoolAllocator<U> &other) const
+	{
+		return _pool == other._pool;
+	}
+	template<typename U>
+	bool operator!=(const NodePoolAllocator<U> &other) const
+	{
+		return _pool != other._pool;
+	}
+private:
+	template<typename> friend class NodePoolAllocator;
+	static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned types are not supported by NodePoolAllocator");
+	std::shared_ptr<NodePool> _pool;
+};
+
+inline NodePool::~NodePool()
+{
+	for (auto &slab : _slabs)
+	{
+		::operator delete(slab.first, slab.second);
+	}
+}
+
+inline void *NodePool::Allocate(const size_t size, const size_t alignment)
+{
+	auto &sizeClass = GetSizeClass(RoundUp(size, alignment));
+	if (sizeClass.FreeList != nullptr)
+	{
+		auto *block = sizeClass.FreeList;
+		sizeClass.FreeList = block->Next;
+		return block;
+	}
+	if (sizeClass.Cursor == sizeClass.End)
+	{
+		const auto slabSize = sizeClass.BlockSize * sizeClass.NextSlabBlockCount;
+		_slabs.reserve(_slabs.size() + 1);
+		auto *slab = static_cast<char *>(::operator new(slabSize));
+		_slabs.emplace_back(slab, slabSize);
+		_reservedBytes += slabSize;
+		sizeClass.Cursor = slab;
+		sizeClass.End = slab + slabSize;
+		sizeClass.NextSlabBlockCount = std::min(2 * sizeClass.NextSlabBlockCount, MaxSlabBlockCount);
+	}
+	auto *block = sizeClass.Cursor;
+	sizeClass.Cursor += sizeClass.BlockSize;
+	return block;
+}
+
+inline void NodePool::Deallocate(void *block, const size_t size, const size_t alignment) noexcept
+{
+	// Size class exists, since block was allocated from it
+	auto &sizeClass = GetSizeClass(RoundUp(size, alignment));
+	auto *freeBlock = static_cast<FreeBlock *>(block);
+	freeBlock->Next = sizeClass.FreeList;
+	sizeClass.FreeList = freeBlock;
+}
+
+inline size_t NodePool::GetReservedBytes() const
+{
+	return _reservedBytes;
+}
+
+/**
+ * Slabs are aligned for any type and block size is a multiple of the alignment,
+ * so every block of a slab is aligned as well. Requests of different alignments
+ * that round up to the same size share one size class.
+ */
+inline size_t NodePool::RoundUp(const size_t size, const size_t alignment)
+{
+	const auto granularity = std::max(alignment, alignof(FreeBlock));
+	return (std::max(size, sizeof(FreeBlock)) + granularity - 1) / granularity * granularity;
+}
+
+/**
+ * Containers allocate one or two kinds of nodes, so linear search is enough
+ */
+inline NodePool::SizeClass &NodePool::GetSizeClass(const size_t blockSize)
+{
+	for (auto &sizeClass : _sizeClasses)
+	{
+		if (sizeClass.BlockSize == blockSize)
+		{
+			return sizeClass;
+		}
+	}
+	_sizeClasses.push_back(SizeClass{ blockSize });
+	return _sizeClasses.back();
+}
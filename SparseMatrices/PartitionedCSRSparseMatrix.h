@@ -0,0 +1,157 @@
+/**
+	Read-only CSR matrix split between pinned threads for NUMA-local products
+
+	Author: Belousov K.
+	Repository: https://github.com/kombuchamp/SparseMatrices
+*/
+
+#pragma once
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "CSRSparseMatrix.h"
+#include "SpMVKernels.h"
+#include "ThreadPool.h"
+
+/**
+ * Matrix rows are split into one partition per thread with equal number of nonzero elements.
+ * Every partition owns its copy of row pointers, column indices and values, which are allocated
+ * and filled by the pinned thread that later multiplies it. With first-touch page placement
+ * the memory of each partition ends up on the NUMA node of its thread, so matrix-vector products
+ * stream matrix data from local memory on every socket.
+ */
+template<typename T = double, typename Index = size_t>
+class PartitionedCSRSparseMatrix
+{
+public:
+	explicit PartitionedCSRSparseMatrix(const CSRSparseMatrix<T, Index> &source, size_t partitionCount = std::thread::hardware_concurrency());
+	PartitionedCSRSparseMatrix(const PartitionedCSRSparseMatrix &) = delete;
+	PartitionedCSRSparseMatrix &operator=(const PartitionedCSRSparseMatrix &) = delete;
+	void Multiply(const T *x, T *y) const;
+	[[nodiscard]] std::vector<T> Multiply(const std::vector<T> &x) const;
+	void FirstTouch(T *y) const;
+	[[nodiscard]] size_t GetNonZeroElementsCount() const;
+	[[nodiscard]] size_t GetRowCount() const;
+	[[nodiscard]] size_t GetColCount() const;
+	[[nodiscard]] size_t GetPartitionCount() const;
+	[[nodiscard]] size_t GetPartitionFirstRow(size_t partition) const;
+private:
+	struct Partition
+	{
+		size_t RowBegin;
+		size_t RowEnd;
+		// Row pointers are local: first row of partition starts at 0
+		std::vector<size_t> RowPtr;
+		std::vector<Index> ColIdx;
+		std::vector<T> Values;
+	};
+	size_t _rowCount;
+	size_t _colCount;
+	size_t _nonZeroElementsCount;
+	std::vector<Partition> _partitions;
+	mutable ThreadPool _pool;
+};
+
+template<typename T, typename Index>
+PartitionedCSRSparseMatrix<T, Index>::PartitionedCSRSparseMatrix(const CSRSparseMatrix<T, Index> &source, const size_t partitionCount)
+	: _rowCount(source.GetRowCount()), _colCount(source.GetColCount()), _nonZeroElementsCount(source.GetNonZeroElementsCount()),
+	_partitions(std::max<size_t>(1, partitionCount)), _pool(_partitions.size(), ThreadPinning::PinToCores)
+{
+	const auto &rowPtr = source.GetRowPointers();
+	const auto &colIdx = source.GetColIndices();
+	const auto &values = source.GetValues();
+	const auto boundaries = PartitionRowsByNonZeros(rowPtr.data(), _rowCount, _partitions.size());
+
+	_pool.RunOnEachThread(
+		[&](size_t threadIndex)
+		{
+			// Vectors are constructed here, so their pages are first touched by the owning thread
+			auto &partition = _partitions[threadIndex];
+			partition.RowBegin = boundaries[threadIndex];
+			partition.RowEnd = boundaries[threadIndex + 1];
+			const auto first = rowPtr[partition.RowBegin];
+			const auto last = rowPtr[partition.RowEnd];
+
+			partition.RowPtr.reserve(partition.RowEnd - partition.RowBegin + 1);
+			for (auto i = partition.RowBegin; i <= partition.RowEnd; i++)
+			{
+				partition.RowPtr.push_back(rowPtr[i] - first);
+			}
+			partition.ColIdx.assign(colIdx.begin() + first, colIdx.begin() + last);
+			partition.Values.assign(values.begin() + first, values.begin() + last);
+		});
+}
+
+/**
+ * y = A * x, every thread writes its own slice of y
+ */
+template<typename T, typename Index>
+void PartitionedCSRSparseMatrix<T, Index>::Multiply(const T *x, T *y) const
+{
+	_pool.RunOnEachThread(
+		[&](size_t threadIndex)
+		{
+			auto &partition = _partitions[threadIndex];
+			MultiplyRowsByVector(partition.RowPtr.data(), partition.ColIdx.data(), partition.Values.data(),
+				x, y + partition.RowBegin, 0, partition.RowEnd - partition.RowBegin);
+		});
+}
+
+template<typename T, typename Index>
+std::vector<T> PartitionedCSRSparseMatrix<T, Index>::Multiply(const std::vector<T> &x) const
+{
+	if (x.size() != _colCount)
+	{
+		throw std::invalid_argument("Invalid argument: vector size doesn't match matrix column count");
+	}
+	std::vector<T> y(_rowCount);
+	Multiply(x.data(), y.data());
+	return y;
+}
+
+/**
+ * Fills freshly allocated, not yet touched result vector with zeros partition by partition,
+ * so that each slice of y is placed next to the thread writing it.
+ * Allocate y with new T[GetRowCount()] or similar, std::vector<T>(n) touches all pages on construction.
+ */
+template<typename T, typename Index>
+void PartitionedCSRSparseMatrix<T, Index>::FirstTouch(T *y) const
+{
+	_pool.RunOnEachThread(
+		[&](size_t threadIndex)
+		{
+			auto &partition = _partitions[threadIndex];
+			std::fill(y + partition.RowBegin, y + partition.RowEnd, T());
+		});
+}
+
+template<typename T, typename Index>
+size_t PartitionedCSRSparseMatrix<T, Index>::GetNonZeroElementsCount() const
+{
+	return _nonZeroElementsCount;
+}
+
+template<typename T, typename Index>
+size_t PartitionedCSRSparseMatrix<T, Index>::GetRowCount() const
+{
+	return _rowCount;
+}
+
+template<typename T, typename Index>
+size_t PartitionedCSRSparseMatrix<T, Index>::GetColCount() const
+{
+	return _colCount;
+}
+
+template<typename T, typename Index>
+size_t PartitionedCSRSparseMatrix<T, Index>::GetPartitionCount() const
+{
+	return _partitions.size();
+}
+
+template<typename T, typename Index>
+size_t PartitionedCSRSparseMatrix<T, Index>::GetPartitionFirstRow(const size_t partition) const
+{
+	return _partitions[partition].RowBegin;
+}
@@ -0,0 +1,137 @@
+/**
+	Radix sort of records by 64-bit key
+
+	Author: Belousov K.
+	Repository: https://github.com/kombuchamp/SparseMatrices
+*/
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "ThreadPool.h"
+
+template<typename T>
+struct KeyedValue
+{
+	uint64_t Key;
+	T Value;
+};
+
+namespace RadixSortDetail
+{
+	constexpr unsigned DigitBits = 8;
+	constexpr size_t BucketCount = size_t(1) << DigitBits;
+	// Smaller inputs are sorted by the calling thread
+	constexpr size_t MinParallelSize = size_t(1) << 16;
+}
+
+/**
+ * Stable LSD radix sort of records by their Key member, 8 bits per pass.
+ * Digits above maxKey aren't looked at, passes where all keys share a digit are skipped,
+ * so keys that fit 24 bits take at most 3 passes.
+ * buffer is scratch space, sorted records end up in items.
+ */
+template<typename Item>
+void RadixSortByKey(std::vector<Item> &items, std::vector<Item> &buffer, const uint64_t maxKey)
+{
+	if (items.empty())
+	{
+		return;
+	}
+	using namespace RadixSortDetail;
+	buffer.resize(items.size());
+	size_t offsets[BucketCount];
+	for (unsigned shift = 0; shift < 64 && (maxKey >> shift) != 0; shift += DigitBits)
+	{
+		std::fill(offsets, offsets + BucketCount, 0);
+		for (auto &item : items)
+		{
+			++offsets[(item.Key >> shift) & (BucketCount - 1)];
+		}
+		if (offsets[(items.front().Key >> shift) & (BucketCount - 1)] == items.size())
+		{
+			continue;
+		}
+		size_t sum = 0;
+		for (auto &offset : offsets)
+		{
+			const auto count = offset;
+			offset = sum;
+			sum += count;
+		}
+		for (auto &item : items)
+		{
+			buffer[offsets[(item.Key >> shift) & (BucketCount - 1)]++] = item;
+		}
+		items.swap(buffer);
+	}
+}
+
+/**
+ * Same sort with every pass split between threads of the pool.
+ * Items are cut into contiguous blocks, each block builds its own histogram of the digit,
+ * then offsets are laid out bucket by bucket in block order, so every block scatters
+ * into its own disjoint slots and the sort stays stable.
+ */
+template<typename Item>
+void ParallelRadixSortByKey(std::vector<Item> &items, std::vector<Item> &buffer, const uint64_t maxKey, ThreadPool &pool = ThreadPool::Default())
+{
+	using namespace RadixSortDetail;
+	const auto count = items.size();
+	const auto blockCount = std::min(4 * pool.GetThreadCount(), count / (MinParallelSize / 4));
+	if (count < MinParallelSize || blockCount < 2)
+	{
+		RadixSortByKey(items, buffer, maxKey);
+		return;
+	}
+	buffer.resize(count);
+	const auto blockSize = (count + blockCount - 1) / blockCount;
+	std::vector<std::array<size_t, BucketCount>> offsets(blockCount);
+	for (unsigned shift = 0; shift < 64 && (maxKey >> shift) != 0; shift += DigitBits)
+	{
+		pool.ParallelFor(blockCount,
+			[&](size_t block, size_t)
+			{
+				auto &histogram = offsets[block];
+				histogram.fill(0);
+				const auto end = std::min(count, (block + 1) * blockSize);
+				for (auto k = block * blockSize; k < end; k++)
+				{
+					++histogram[(items[k].Key >> shift) & (BucketCount - 1)];
+				}
+			});
+		const auto firstBucket = (items.front().Key >> shift) & (BucketCount - 1);
+		size_t firstBucketSize = 0;
+		for (auto &histogram : offsets)
+		{
+			firstBucketSize += histogram[firstBucket];
+		}
+		if (firstBucketSize == count)
+		{
+			continue;
+		}
+		size_t sum = 0;
+		for (size_t bucket = 0; bucket < BucketCount; bucket++)
+		{
+			for (auto &histogram : offsets)
+			{
+				const auto blockBucketSize = histogram[bucket];
+				histogram[bucket] = sum;
+				sum += blockBucketSize;
+			}
+		}
+		pool.ParallelFor(blockCount,
+			[&](size_t block, size_t)
+			{
+				auto &next = offsets[block];
+				const auto end = std::min(count, (block + 1) * blockSize);
+				for (auto k = block * blockSize; k < end; k++)
+				{
+					buffer[next[(items[k].Key >> shift) & (BucketCount - 1)]++] = items[k];
+				}
+			});
+		items.swap(buffer);
+	}
+}
\ No newline at end of file
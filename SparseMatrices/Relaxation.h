@@ -0,0 +1,293 @@
+/**
+	Jacobi, Gauss-Seidel and SOR relaxation sweeps
+
+	Author: Belousov K.
+	Repository: https://github.com/kombuchamp/SparseMatrices
+*/
+
+#pragma once
+#include <stdexcept>
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include "CSRSparseMatrix.h"
+#include "IterativeSolver.h"
+#include "LevelSchedule.h"
+#include "SpMVKernels.h"
+#include "ThreadPool.h"
+
+enum class SweepDirection
+{
+	Forward,
+	Backward,
+	// Forward sweep followed by backward one, keeps the smoother symmetric for symmetric matrices
+	Symmetric
+};
+
+/**
+ * Relaxation sweeps for A x = b, each improving x in place: Jacobi, Gauss-Seidel and SOR in natural row order,
+ * and multicolor Gauss-Seidel and SOR. Multicolor sweeps visit rows color by color, rows of one color
+ * don't reference each other in either direction, so they are relaxed by all threads of the pool at once.
+ * Sweep order differs from the natural one, so multicolor and natural sweeps give different iterates,
+ * but multicolor results don't depend on thread count.
+ * Diagonal positions, inverse diagonal, coloring and the Jacobi work vector are prepared by the constructor,
+ * sweeps don't allocate. Relaxation holds a reference, so the matrix should outlive it;
+ * after values of the matrix change without changing its pattern, UpdateValues re-reads the diagonal.
+ */
+template<typename T = double, typename Index = size_t>
+class Relaxation
+{
+public:
+	explicit Relaxation(const CSRSparseMatrix<T, Index> &matrix, ThreadPool &pool = ThreadPool::Default());
+	void UpdateValues();
+	// x += weight * D^-1 (b - A x), all rows at once
+	void Jacobi(const T *b, T *x, size_t sweeps = 1, T weight = T(1));
+	void GaussSeidel(const T *b, T *x, size_t sweeps = 1, SweepDirection direction = SweepDirection::Forward);
+	void SOR(const T *b, T *x, T omega, size_t sweeps = 1, SweepDirection direction = SweepDirection::Forward);
+	void MulticolorGaussSeidel(const T *b, T *x, size_t sweeps = 1, SweepDirection direction = SweepDirection::Forward);
+	void MulticolorSOR(const T *b, T *x, T omega, size_t sweeps = 1, SweepDirection direction = SweepDirection::Forward);
+	[[nodiscard]] const CSRSparseMatrix<T, Index> &GetMatrix() const;
+	[[nodiscard]] size_t GetColorCount() const;
+	/**
+	 * Rows grouped by color, level l of the schedule holds rows of color l
+	 */
+	[[nodiscard]] const LevelSchedule &GetColoring() const;
+private:
+	// x[i] += omega * (b[i] - A[i] . x) / A[i][i]
+	void RelaxRow(size_t row, const T *b, T *x, T omega) const;
+	void ColorSweep(size_t color, const T *b, T *x, T omega);
+	const CSRSparseMatrix<T, Index> &_matrix;
+	ThreadPool &_pool;
+	std::vector<size_t> _diagonal;
+	std::vector<T> _inverseDiagonal;
+	LevelSchedule _coloring;
+	// Row ranges of about the same number of nonzero elements for Jacobi sweeps
+	std::vector<size_t> _blocks;
+	std::vector<T> _work;
+};
+
+/**
+ * Greedy coloring in row order over the symmetrized pattern: a row takes the smallest color
+ * not taken by any row it references or that references it
+ */
+template<typename T, typename Index>
+Relaxation<T, Index>::Relaxation(const CSRSparseMatrix<T, Index> &matrix, ThreadPool &pool)
+	: _matrix(matrix), _pool(pool)
+{
+	const auto n = GetSystemSize(matrix);
+	const auto &rowPtr = matrix.GetRowPointers();
+	const auto &colIdx = matrix.GetColIndices();
+	_diagonal.resize(n);
+	for (size_t i = 0; i < n; i++)
+	{
+		const auto position = std::lower_bound(colIdx.begin() + rowPtr[i], colIdx.begin() + rowPtr[i + 1], i);
+		if (position == colIdx.begin() + rowPtr[i + 1] || *position != i)
+		{
+			throw std::invalid_argument("Invalid argument: relaxation requires every diagonal element to be stored");
+		}
+		_diagonal[i] = position - colIdx.begin();
+	}
+	UpdateValues();
+
+	std::vector<size_t> transposedRowPtr(n + 1, 0);
+	for (auto col : colIdx)
+	{
+		++transposedRowPtr[col + 1];
+	}
+	for (size_t i = 0; i < n; i++)
+	{
+		transposedRowPtr[i + 1] += transposedRowPtr[i];
+	}
+	std::vector<size_t> transposedColIdx(colIdx.size());
+	std::vector<size_t> next(transposedRowPtr.begin(), transposedRowPtr.end() - 1);
+	for (size_t i = 0; i < n; i++)
+	{
+		for (auto p = rowPtr[i]; p < rowPtr[i + 1]; p++)
+		{
+			transposedColIdx[next[colIdx[p]]++] = i;
+		}
+	}
+
+	std::vector<size_t> colors(n);
+	// forbidden[c] == i + 1 while color c is taken by a neighbour of row i
+	std::vector<size_t> forbidden;
+	size_t colorCount = 0;
+	for (size_t i = 0; i < n; i++)
+	{
+		const auto forbid = [&](size_t neighbour)
+		{
+			if (neighbour < i)
+			{
+				forbidden[colors[neighbour]] = i + 1;
+			}
+		};
+		for (auto p = rowPtr[i]; p < rowPtr[i + 1]; p++)
+		{
+			forbid(colIdx[p]);
+		}
+		for (auto p = transposedRowPtr[i]; p < transposedRowPtr[i + 1]; p++)
+		{
+			forbid(transposedColIdx[p]);
+		}
+		size_t color = 0;
+		while (color < colorCount && forbidden[color] == i + 1)
+		{
+			color++;
+		}
+		if (color == colorCount)
+		{
+			forbidden.push_back(0);
+			++colorCount;
+		}
+		colors[i] = color;
+	}
+	_coloring = LevelSchedule::FromLevels(colors, colorCount);
+
+	_blocks = PartitionRowsByNonZeros(rowPtr.data(), n, 4 * pool.GetThreadCount());
+	_work.resize(n);
+}
+
+template<typename T, typename Index>
+void Relaxation<T, Index>::UpdateValues()
+{
+	const auto &values = _matrix.GetValues();
+	_inverseDiagonal.resize(_diagonal.size());
+	for (size_t i = 0; i < _diagonal.size(); i++)
+	{
+		const auto diagonal = values[_diagonal[i]];
+		if (diagonal == T())
+		{
+			throw std::invalid_argument("Invalid argument: relaxation requires nonzero diagonal");
+		}
+		_inverseDiagonal[i] = T(1) / diagonal;
+	}
+}
+
+template<typename T, typename Index>
+void Relaxation<T, Index>::RelaxRow(const size_t row, const T *b, T *x, const T omega) const
+{
+	const auto &rowPtr = _matrix.GetRowPointers();
+	const auto begin = rowPtr[row];
+	const auto ax = SparseDot(_matrix.GetColIndices().data() + begin, _matrix.GetValues().data() + begin, rowPtr[row + 1] - begin, x);
+	x[row] += omega * (b[row] - ax) * _inverseDiagonal[row];
+}
+
+/**
+ * Sweeps alternate between x and the work vector, so the last one is copied back only for odd sweep count
+ */
+template<typename T, typename Index>
+void Relaxation<T, Index>::Jacobi(const T *b, T *x, const size_t sweeps, const T weight)
+{
+	const auto *rowPtr = _matrix.GetRowPointers().data();
+	const auto *colIdx = _matrix.GetColIndices().data();
+	const auto *values = _matrix.GetValues().data();
+	T *source = x;
+	T *target = _work.data();
+	for (size_t sweep = 0; sweep < sweeps; sweep++)
+	{
+		_pool.ParallelFor(_blocks.size() - 1,
+			[&](size_t block, size_t)
+			{
+				for (auto i = _blocks[block]; i < _blocks[block + 1]; i++)
+				{
+					const auto ax = SparseDot(colIdx + rowPtr[i], values + rowPtr[i], rowPtr[i + 1] - rowPtr[i], source);
+					target[i] = source[i] + weight * (b[i] - ax) * _inverseDiagonal[i];
+				}
+			});
+		std::swap(source, target);
+	}
+	if (sweeps % 2 == 1)
+	{
+		_pool.ParallelForRange(_work.size(),
+			[&](size_t begin, size_t end, size_t)
+			{
+				std::copy(_work.begin() + begin, _work.begin() + end, x + begin);
+			});
+	}
+}
+
+template<typename T, typename Index>
+void Relaxation<T, Index>::GaussSeidel(const T *b, T *x, const size_t sweeps, const SweepDirection direction)
+{
+	SOR(b, x, T(1), sweeps, direction);
+}
+
+template<typename T, typename Index>
+void Relaxation<T, Index>::SOR(const T *b, T *x, const T omega, const size_t sweeps, const SweepDirection direction)
+{
+	const auto n = _diagonal.size();
+	for (size_t sweep = 0; sweep < sweeps; sweep++)
+	{
+		if (direction != SweepDirection::Backward)
+		{
+			for (size_t i = 0; i < n; i++)
+			{
+				RelaxRow(i, b, x, omega);
+			}
+		}
+		if (direction != SweepDirection::Forward)
+		{
+			for (auto i = n; i > 0; i--)
+			{
+				RelaxRow(i - 1, b, x, omega);
+			}
+		}
+	}
+}
+
+template<typename T, typename Index>
+void Relaxation<T, Index>::MulticolorGaussSeidel(const T *b, T *x, const size_t sweeps, const SweepDirection direction)
+{
+	MulticolorSOR(b, x, T(1), sweeps, direction);
+}
+
+template<typename T, typename Index>
+void Relaxation<T, Index>::MulticolorSOR(const T *b, T *x, const T omega, const size_t sweeps, const SweepDirection direction)
+{
+	const auto colorCount = GetColorCount();
+	for (size_t sweep = 0; sweep < sweeps; sweep++)
+	{
+		if (direction != SweepDirection::Backward)
+		{
+			for (size_t color = 0; color < colorCount; color++)
+			{
+				ColorSweep(color, b, x, omega);
+			}
+		}
+		if (direction != SweepDirection::Forward)
+		{
+			for (auto color = colorCount; color > 0; color--)
+			{
+				ColorSweep(color - 1, b, x, omega);
+			}
+		}
+	}
+}
+
+template<typename T, typename Index>
+void Relaxation<T, Index>::ColorSweep(const size_t color, const T *b, T *x, const T omega)
+{
+	_coloring.RunLevel(_pool, color,
+		[&](size_t i)
+		{
+			RelaxRow(i, b, x, omega);
+		});
+}
+
+template<typename T, typename Index>
+const CSRSparseMatrix<T, Index> &Relaxation<T, Index>::GetMatrix() const
+{
+	return _matrix;
+}
+
+template<typename T, typename Index>
+size_t Relaxation<T, Index>::GetColorCount() const
+{
+	return _coloring.GetLevelCount();
+}
+
+template<typename T, typename Index>
+const LevelSchedule &Relaxation<T, Index>::GetColoring() const
+{
+	return _coloring;
+}
\ No newline at end of file
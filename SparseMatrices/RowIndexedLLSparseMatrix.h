@@ -0,0 +1,329 @@
+/**
+	Sparse matrix implementation on per-row linked lists
+
+	Author: Belousov K.
+	Repository: https://github.com/kombuchamp/SparseMatrices
+*/
+
+#pragma once
+#include <stdexcept>
+#include <algorithm>
+#include <iterator>
+#include <list>
+#include <vector>
+#include <utility>
+#include <ostream>
+#include <type_traits>
+#include "ISparseMatrix.h"
+#include "LLSparseMatrix.h"
+#include "MatrixNode.h"
+#include "SparseIndex.h"
+
+/**
+ * Same as LLSparseMatrix, but nodes of every row are kept together and sorted by column,
+ * and the first node and length of every row are stored, so point operations scan only one row instead of the whole matrix.
+ * All nodes share one list, so an empty row costs only its range and no allocation.
+ */
+template<typename T = double, typename Index = size_t>
+class RowIndexedLLSparseMatrix : public ISparseMatrix<T>
+{
+public:
+	RowIndexedLLSparseMatrix()
+		: RowIndexedLLSparseMatrix(0, 0)
+	{
+	}
+	RowIndexedLLSparseMatrix(const size_t rows, const size_t cols)
+		: _rowCount(rows), _colCount(cols), _nonZeroElementsCount(0)
+	{
+		static_assert(std::is_default_constructible<T>::value, "Template type T should have default constructor");
+		ThrowIfIndexOverflows<Index>(_rowCount, _colCount);
+		_rows.resize(_rowCount);
+	}
+	RowIndexedLLSparseMatrix(const RowIndexedLLSparseMatrix &other);
+	RowIndexedLLSparseMatrix(RowIndexedLLSparseMatrix &&other) = default;
+	RowIndexedLLSparseMatrix &operator=(RowIndexedLLSparseMatrix other);
+	template<typename Allocator, typename OtherIndex>
+	explicit RowIndexedLLSparseMatrix(const LLSparseMatrix<T, Allocator, OtherIndex> &other);
+	T ElementAt(int row, int col) const override;
+	void Resize(size_t rows, size_t cols) override;
+	void SetElement(int row, int col, T val) override;
+	void RemoveElement(int row, int col) override;
+	void Print(std::ostream &) const override;
+	void Print(std::ostream &, const PrintOptions &options) const override;
+	void Transpose() override;
+	[[nodiscard]] size_t GetNonZeroElementsCount() const override;
+	[[nodiscard]] size_t GetRowCount() const override;
+	[[nodiscard]] size_t GetColCount() const override;
+	[[nodiscard]] LLSparseMatrix<T, std::allocator<MatrixNode<T>>, Index> ToLLSparseMatrix() const;
+private:
+	using NodeList = std::list<MatrixNode<T, Index>>;
+	using NodeIterator = typename NodeList::iterator;
+	// Rows follow each other in the list in no particular order, First is meaningless for an empty row
+	struct RowRange
+	{
+		NodeIterator First;
+		size_t Size = 0;
+	};
+	// Appends a node to the end of the list, the row should be empty or the last one in the list
+	void Append(size_t row, size_t col, const T &val);
+	template<typename Visitor>
+	void VisitElements(Visitor &&visit) const;
+	[[nodiscard]] bool InBoundaries(size_t row, size_t col) const;
+	size_t _rowCount;
+	size_t _colCount;
+	size_t _nonZeroElementsCount;
+	NodeList _nodes;
+	std::vector<RowRange> _rows;
+};
+
+template<typename T, typename Index>
+RowIndexedLLSparseMatrix<T, Index>::RowIndexedLLSparseMatrix(const RowIndexedLLSparseMatrix &other)
+	: RowIndexedLLSparseMatrix(other._rowCount, other._colCount)
+{
+	other.VisitElements(
+		[&](const MatrixNode<T, Index> &elem)
+		{
+			Append(elem.Row, elem.Col, elem.Value);
+			return true;
+		});
+}
+
+template<typename T, typename Index>
+RowIndexedLLSparseMatrix<T, Index> &RowIndexedLLSparseMatrix<T, Index>::operator=(RowIndexedLLSparseMatrix other)
+{
+	// Iterators stay valid when lists are swapped, so ranges move along with their nodes
+	std::swap(_rowCount, other._rowCount);
+	std::swap(_colCount, other._colCount);
+	std::swap(_nonZeroElementsCount, other._nonZeroElementsCount);
+	_nodes.swap(other._nodes);
+	_rows.swap(other._rows);
+	return *this;
+}
+
+template<typename T, typename Index>
+template<typename Allocator, typename OtherIndex>
+RowIndexedLLSparseMatrix<T, Index>::RowIndexedLLSparseMatrix(const LLSparseMatrix<T, Allocator, OtherIndex> &other)
+	: RowIndexedLLSparseMatrix(other._rowCount, other._colCount)
+{
+	for (auto &elem : other._nonZeroElements)
+	{
+		Append(elem.Row, elem.Col, elem.Value);
+	}
+}
+
+template<typename T, typename Index>
+void RowIndexedLLSparseMatrix<T, Index>::Append(const size_t row, const size_t col, const T &val)
+{
+	_nodes.emplace_back(row, col, val);
+	auto &range = _rows[row];
+	if (range.Size++ == 0)
+	{
+		range.First = std::prev(_nodes.end());
+	}
+	++_nonZeroElementsCount;
+}
+
+/**
+ * Calls visit(node) for every node in row-major order until it returns false
+ */
+template<typename T, typename Index>
+template<typename Visitor>
+void RowIndexedLLSparseMatrix<T, Index>::VisitElements(Visitor &&visit) const
+{
+	for (auto &range : _rows)
+	{
+		auto elemIt = range.First;
+		for (size_t k = 0; k < range.Size; k++, ++elemIt)
+		{
+			if (!visit(*elemIt))
+			{
+				return;
+			}
+		}
+	}
+}
+
+template<typename T, typename Index>
+LLSparseMatrix<T, std::allocator<MatrixNode<T>>, Index> RowIndexedLLSparseMatrix<T, Index>::ToLLSparseMatrix() const
+{
+	LLSparseMatrix<T, std::allocator<MatrixNode<T>>, Index> result(_rowCount, _colCount);
+	VisitElements(
+		[&](const MatrixNode<T, Index> &elem)
+		{
+			result._nonZeroElements.push_back(elem);
+			return true;
+		});
+	return result;
+}
+
+template<typename T, typename Index>
+void RowIndexedLLSparseMatrix<T, Index>::Resize(const size_t rows, const size_t cols)
+{
+	if (rows < _rowCount || cols < _colCount)
+	{
+		throw std::invalid_argument("Can't reduce matrix size");
+	}
+	ThrowIfIndexOverflows<Index>(rows, cols);
+	_rows.resize(rows);
+	_rowCount = rows;
+	_colCount = cols;
+}
+
+template<typename T, typename Index>
+T RowIndexedLLSparseMatrix<T, Index>::ElementAt(int row, int col) const
+{
+	if (!InBoundaries(row, col))
+	{
+		throw std::invalid_argument("Element indices are out of bounds");
+	}
+	const auto &range = _rows[row];
+	auto elemIt = range.First;
+	for (size_t k = 0; k < range.Size && elemIt->Col <= static_cast<Index>(col); k++, ++elemIt)
+	{
+		if (elemIt->Col == static_cast<Index>(col))
+		{
+			return elemIt->Value;
+		}
+	}
+	return T();
+}
+
+template<typename T, typename Index>
+void RowIndexedLLSparseMatrix<T, Index>::SetElement(int row, int col, T val)
+{
+	if (!InBoundaries(row, col))
+	{
+		throw std::invalid_argument("Element indices are out of bounds");
+	}
+	if (val == T())
+	{
+		RemoveElement(row, col);
+		return;
+	}
+	auto &range = _rows[row];
+	auto elemIt = range.First;
+	size_t k = 0;
+	while (k < range.Size && elemIt->Col < static_cast<Index>(col))
+	{
+		++elemIt;
+		++k;
+	}
+	if (k < range.Size && elemIt->Col == static_cast<Index>(col))
+	{
+		elemIt->Value = val;
+		return;
+	}
+	// The first node of an empty row goes to the end of the list, any other one next to its row neighbours
+	const auto inserted = _nodes.emplace(range.Size == 0 ? _nodes.end() : elemIt, row, col, val);
+	if (k == 0)
+	{
+		range.First = inserted;
+	}
+	++range.Size;
+	++_nonZeroElementsCount;
+}
+
+template<typename T, typename Index>
+void RowIndexedLLSparseMatrix<T, Index>::RemoveElement(int row, int col)
+{
+	if (!InBoundaries(row, col))
+	{
+		throw std::invalid_argument("Element indices are out of bounds");
+	}
+	auto &range = _rows[row];
+	auto elemIt = range.First;
+	for (size_t k = 0; k < range.Size && elemIt->Col <= static_cast<Index>(col); k++, ++elemIt)
+	{
+		if (elemIt->Col == static_cast<Index>(col))
+		{
+			if (k == 0)
+			{
+				range.First = std::next(elemIt);
+			}
+			_nodes.erase(elemIt);
+			--range.Size;
+			--_nonZeroElementsCount;
+			return;
+		}
+	}
+}
+
+template<typename T, typename Index>
+void RowIndexedLLSparseMatrix<T, Index>::Print(std::ostream &os) const
+{
+	Print(os, PrintOptions());
+}
+
+template<typename T, typename Index>
+void RowIndexedLLSparseMatrix<T, Index>::Print(std::ostream &os, const PrintOptions &options) const
+{
+	PrintSparse<T>(os, _rowCount, _colCount, _nonZeroElementsCount, options,
+		[&](auto &&visit)
+		{
+			VisitElements(
+				[&](const MatrixNode<T, Index> &elem)
+				{
+					return visit(elem.Row, elem.Col, elem.Value);
+				});
+		});
+}
+
+template<typename T, typename Index>
+void RowIndexedLLSparseMatrix<T, Index>::Transpose()
+{
+	// Nodes are relinked into rows of transposed matrix without reallocation.
+	// Source rows are visited in ascending order, so every new row stays sorted.
+	NodeList nodes;
+	std::vector<RowRange> rows(_colCount);
+	std::vector<NodeIterator> last(_colCount);
+	for (auto &range : _rows)
+	{
+		auto elemIt = range.First;
+		for (size_t k = 0; k < range.Size; k++)
+		{
+			const auto node = elemIt++;
+			std::swap(node->Row, node->Col);
+			auto &destination = rows[node->Row];
+			nodes.splice(destination.Size == 0 ? nodes.end() : std::next(last[node->Row]), _nodes, node);
+			if (destination.Size++ == 0)
+			{
+				destination.First = node;
+			}
+			last[node->Row] = node;
+		}
+	}
+	_nodes.swap(nodes);
+	_rows.swap(rows);
+	std::swap(_rowCount, _colCount);
+}
+
+template<typename T, typename Index>
+size_t RowIndexedLLSparseMatrix<T, Index>::GetNonZeroElementsCount() const
+{
+	return _nonZeroElementsCount;
+}
+
+template<typename T, typename Index>
+size_t RowIndexedLLSparseMatrix<T, Index>::GetRowCount() const
+{
+	return _rowCount;
+}
+
+template<typename T, typename Index>
+size_t RowIndexedLLSparseMatrix<T, Index>::GetColCount() const
+{
+	return _colCount;
+}
+
+template<typename T, typename Index>
+bool RowIndexedLLSparseMatrix<T, Index>::InBoundaries(const size_t row, const size_t col) const
+{
+	return row < _rowCount && col < _colCount;
+}
+
+template<typename T, typename Index>
+std::ostream &operator<<(std::ostream &os, const RowIndexedLLSparseMatrix<T, Index> &mat)
+{
+	mat.Print(os);
+	return os;
+}
@@ -0,0 +1,262 @@
+/**
+	Sparse matrix - dense vector product kernels
+
+	Author: Belousov K.
+	Repository: https://github.com/kombuchamp/SparseMatrices
+*/
+
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+/**
+ * Dot product of a sparse row with a dense vector: sum of values[k] * x[indices[k]].
+ * float and double rows are gathered with AVX-512 or AVX2 when the compiler targets them
+ * (/arch:AVX2, /arch:AVX512, -mavx2 -mfma, -mavx512f), any other case falls back to scalar loop.
+ * 16, 32 and 64-bit unsigned indices are zero-extended to 64 bits before gathering,
+ * so narrow indices save memory traffic without limiting matrix size.
+ */
+template<typename T, typename Index>
+T SparseDot(const Index *indices, const T *values, const size_t count, const T *x)
+{
+	T sum = T();
+	for (size_t k = 0; k < count; k++)
+	{
+		sum += values[k] * x[indices[k]];
+	}
+	return sum;
+}
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#if defined(__FMA__) || defined(_MSC_VER)
+#define SPARSE_MATRICES_FMADD_PD(a, b, c) _mm256_fmadd_pd(a, b, c)
+#define SPARSE_MATRICES_FMADD_PS(a, b, c) _mm256_fmadd_ps(a, b, c)
+#else
+#define SPARSE_MATRICES_FMADD_PD(a, b, c) _mm256_add_pd(_mm256_mul_pd(a, b), c)
+#define SPARSE_MATRICES_FMADD_PS(a, b, c) _mm256_add_ps(_mm256_mul_ps(a, b), c)
+#endif
+
+template<typename Index>
+constexpr bool IsGatherableIndex()
+{
+	return std::is_unsigned<Index>::value && (sizeof(Index) == 2 || sizeof(Index) == 4 || sizeof(Index) == 8);
+}
+
+/**
+ * Loads 4 indices zero-extended to 64-bit lanes
+ */
+template<typename Index>
+__m256i LoadIndices4(const Index *indices)
+{
+	if constexpr (sizeof(Index) == 8)
+	{
+		return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(indices));
+	}
+	else if constexpr (sizeof(Index) == 4)
+	{
+		return _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i *>(indices)));
+	}
+	else
+	{
+		return _mm256_cvtepu16_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(indices)));
+	}
+}
+
+#if defined(__AVX512F__)
+/**
+ * Loads 8 indices zero-extended to 64-bit lanes
+ */
+template<typename Index>
+__m512i LoadIndices8(const Index *indices)
+{
+	if constexpr (sizeof(Index) == 8)
+	{
+		return _mm512_loadu_si512(reinterpret_cast<const void *>(indices));
+	}
+	else if constexpr (sizeof(Index) == 4)
+	{
+		return _mm512_cvtepu32_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(indices)));
+	}
+	else
+	{
+		return _mm512_cvtepu16_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i *>(indices)));
+	}
+}
+#endif
+
+template<typename Index>
+double SparseDot(const Index *indices, const double *values, const size_t count, const double *x)
+{
+	if constexpr (!IsGatherableIndex<Index>())
+	{
+		double sum = 0;
+		for (size_t k = 0; k < count; k++)
+		{
+			sum += values[k] * x[indices[k]];
+		}
+		return sum;
+	}
+	else
+	{
+		size_t k = 0;
+		double sum = 0;
+#if defined(__AVX512F__)
+		__m512d acc512 = _mm512_setzero_pd();
+		for (; k + 8 <= count; k += 8)
+		{
+			const __m512d gathered = _mm512_i64gather_pd(LoadIndices8(indices + k), x, sizeof(double));
+			acc512 = _mm512_fmadd_pd(_mm512_loadu_pd(values + k), gathered, acc512);
+		}
+		sum += _mm512_reduce_add_pd(acc512);
+#endif
+		__m256d acc = _mm256_setzero_pd();
+		for (; k + 4 <= count; k += 4)
+		{
+			const __m256d gathered = _mm256_i64gather_pd(x, LoadIndices4(indices + k), sizeof(double));
+			acc = SPARSE_MATRICES_FMADD_PD(_mm256_loadu_pd(values + k), gathered, acc);
+		}
+		const __m128d halves = _mm_add_pd(_mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1));
+		sum += _mm_cvtsd_f64(_mm_add_sd(halves, _mm_unpackhi_pd(halves, halves)));
+		for (; k < count; k++)
+		{
+			sum += values[k] * x[indices[k]];
+		}
+		return sum;
+	}
+}
+
+template<typename Index>
+float SparseDot(const Index *indices, const float *values, const size_t count, const float *x)
+{
+	if constexpr (!IsGatherableIndex<Index>())
+	{
+		float sum = 0;
+		for (size_t k = 0; k < count; k++)
+		{
+			sum += values[k] * x[indices[k]];
+		}
+		return sum;
+	}
+	else
+	{
+		size_t k = 0;
+		float sum = 0;
+#if defined(__AVX512F__)
+		__m512 acc512 = _mm512_setzero_ps();
+		for (; k + 16 <= count; k += 16)
+		{
+			const __m512 gathered = _mm512_castpd_ps(_mm512_insertf64x4(
+				_mm512_castps_pd(_mm512_castps256_ps512(_mm512_i64gather_ps(LoadIndices8(indices + k), x, sizeof(float)))),
+				_mm256_castps_pd(_mm512_i64gather_ps(LoadIndices8(indices + k + 8), x, sizeof(float))), 1));
+			acc512 = _mm512_fmadd_ps(_mm512_loadu_ps(values + k), gathered, acc512);
+		}
+		sum += _mm512_reduce_add_ps(acc512);
+#endif
+		__m256 acc = _mm256_setzero_ps();
+		for (; k + 8 <= count; k += 8)
+		{
+			const __m256 gathered = _mm256_insertf128_ps(
+				_mm256_castps128_ps256(_mm256_i64gather_ps(x, LoadIndices4(indices + k), sizeof(float))),
+				_mm256_i64gather_ps(x, LoadIndices4(indices + k + 4), sizeof(float)), 1);
+			acc = SPARSE_MATRICES_FMADD_PS(_mm256_loadu_ps(values + k), gathered, acc);
+		}
+		__m128 quarters = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+		quarters = _mm_add_ps(quarters, _mm_movehl_ps(quarters, quarters));
+		sum += _mm_cvtss_f32(_mm_add_ss(quarters, _mm_shuffle_ps(quarters, quarters, 1)));
+		for (; k < count; k++)
+		{
+			sum += values[k] * x[indices[k]];
+		}
+		return sum;
+	}
+}
+
+#undef SPARSE_MATRICES_FMADD_PD
+#undef SPARSE_MATRICES_FMADD_PS
+#endif
+
+/**
+ * y[i] = A[i, :] * x for rows i in [rowBegin, rowEnd) of CSR arrays
+ */
+template<typename T, typename Index>
+void MultiplyRowsByVector(const size_t *rowPtr, const Index *colIdx, const T *values,
+	const T *x, T *y, const size_t rowBegin, const size_t rowEnd)
+{
+	for (auto i = rowBegin; i < rowEnd; i++)
+	{
+		y[i] = SparseDot(colIdx + rowPtr[i], values + rowPtr[i], rowPtr[i + 1] - rowPtr[i], x);
+	}
+}
+
+/**
+ * Y[i, :] = A[i, :] * X for rows i in [rowBegin, rowEnd) of CSR arrays.
+ * X and Y are dense row-major blocks of vectorCount columns.
+ * Every nonzero element is loaded once and applied to a whole contiguous row of X,
+ * the inner loop has no indirection and is left to the compiler to vectorize.
+ */
+template<typename T, typename Index>
+void MultiplyRowsByDenseBlock(const size_t *rowPtr, const Index *colIdx, const T *values,
+	const T *x, const size_t vectorCount, T *y, const size_t rowBegin, const size_t rowEnd)
+{
+	for (auto i = rowBegin; i < rowEnd; i++)
+	{
+		T *__restrict yRow = y + i * vectorCount;
+		for (size_t j = 0; j < vectorCount; j++)
+		{
+			yRow[j] = T();
+		}
+		for (auto k = rowPtr[i]; k < rowPtr[i + 1]; k++)
+		{
+			const T value = values[k];
+			const T *__restrict xRow = x + static_cast<size_t>(colIdx[k]) * vectorCount;
+			for (size_t j = 0; j < vectorCount; j++)
+			{
+				yRow[j] += value * xRow[j];
+			}
+		}
+	}
+}
+
+/**
+ * y = A * x for CSC arrays of A with rowCount rows, or y = A^T * x for CSR arrays of A with colCount columns.
+ * Result is scattered, so y is cleared first.
+ */
+template<typename T, typename Index>
+void MultiplyColumnsByVector(const size_t *colPtr, const Index *rowIdx, const T *values,
+	const T *x, T *y, const size_t colCount, const size_t rowCount)
+{
+	for (size_t i = 0; i < rowCount; i++)
+	{
+		y[i] = T();
+	}
+	for (size_t j = 0; j < colCount; j++)
+	{
+		const auto xj = x[j];
+		for (auto k = colPtr[j]; k < colPtr[j + 1]; k++)
+		{
+			y[rowIdx[k]] += values[k] * xj;
+		}
+	}
+}
+
+/**
+ * Splits rows into partitionCount contiguous ranges holding about the same number of nonzero elements.
+ * Returns partitionCount + 1 boundaries, range p is [boundaries[p], boundaries[p + 1]).
+ */
+inline std::vector<size_t> PartitionRowsByNonZeros(const size_t *rowPtr, const size_t rowCount, const size_t partitionCount)
+{
+	std::vector<size_t> boundaries(partitionCount + 1, rowCount);
+	boundaries[0] = 0;
+	const auto nonZeros = rowPtr[rowCount];
+	for (size_t p = 1; p < partitionCount; p++)
+	{
+		const auto target = nonZeros / partitionCount * p + nonZeros % partitionCount * p / partitionCount;
+		boundaries[p] = std::lower_bound(rowPtr + boundaries[p - 1], rowPtr + rowCount, target) - rowPtr;
+	}
+	return boundaries;
+}
@@ -0,0 +1,84 @@
+/**
+	Dense accumulator for sparse row products
+
+	Author: Belousov K.
+	Repository: https://github.com/kombuchamp/SparseMatrices
+*/
+
+#pragma once
+#include <algorithm>
+#include <vector>
+
+/**
+ * Accumulates one sparse row of a matrix product (Gustavson's algorithm).
+ * Values are kept in a dense array indexed by column, touched columns are remembered,
+ * so that flushing costs O(k log k) for k touched columns instead of O(columns).
+ * Generation counter lets the accumulator be reused for the next row without clearing.
+ */
+template<typename T>
+class SparseAccumulator
+{
+public:
+	explicit SparseAccumulator(const size_t size = 0)
+		: _values(size), _marks(size, 0), _generation(1)
+	{
+	}
+	/**
+	 * Makes room for indices below size, keeps storage if it is already big enough
+	 */
+	void Reserve(const size_t size)
+	{
+		if (_values.size() < size)
+		{
+			_values.resize(size);
+			_marks.resize(size, 0);
+		}
+	}
+	void Accumulate(const size_t index, const T &value)
+	{
+		if (_marks[index] != _generation)
+		{
+			_marks[index] = _generation;
+			_values[index] = value;
+			_touched.push_back(index);
+		}
+		else
+		{
+			_values[index] += value;
+		}
+	}
+	/**
+	 * Passes accumulated nonzero values to emit(index, value) in ascending index order and resets the accumulator
+	 */
+	template<typename Callback>
+	void Flush(Callback &&emit)
+	{
+		std::sort(_touched.begin(), _touched.end());
+		for (auto index : _touched)
+		{
+			if (_values[index] != T())
+			{
+				emit(index, _values[index]);
+			}
+		}
+		_touched.clear();
+		++_generation;
+	}
+private:
+	std::vector<T> _values;
+	std::vector<size_t> _marks;
+	std::vector<size_t> _touched;
+	size_t _generation;
+};
+
+/**
+ * Scratch storage of sparse matrix product, kept between MultiplyInto calls.
+ * Once it has grown to the size of the operands, repeated products don't allocate.
+ * RowBegin holds positions of rows of the right operand for formats without row pointers.
+ */
+template<typename T, typename Position = size_t>
+struct ProductWorkspace
+{
+	SparseAccumulator<T> Accumulator;
+	std::vector<Position> RowBegin;
+};
\ No newline at end of file
@@ -0,0 +1,40 @@
+/**
+	Index types of sparse matrices
+
+	Author: Belousov K.
+	Repository: https://github.com/kombuchamp/SparseMatrices
+*/
+
+#pragma once
+#include <stdexcept>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+/**
+ * Checks that every row and column index of rows x cols matrix can be stored in Index
+ */
+template<typename Index>
+bool FitsIndex(const size_t rows, const size_t cols)
+{
+	static_assert(std::is_unsigned<Index>::value, "Index type should be unsigned integer");
+	constexpr auto maxIndex = static_cast<uint64_t>(std::numeric_limits<Index>::max());
+	return (rows == 0 || rows - 1 <= maxIndex) && (cols == 0 || cols - 1 <= maxIndex);
+}
+
+template<typename Index>
+void ThrowIfIndexOverflows(const size_t rows, const size_t cols)
+{
+	if (!FitsIndex<Index>(rows, cols))
+	{
+		throw std::invalid_argument("Matrix size doesn't fit index type");
+	}
+}
+
+/**
+ * Position of element in row-major order, 64-bit for any matrix size
+ */
+inline uint64_t LinearPosition(const size_t row, const size_t col, const size_t colCount)
+{
+	return static_cast<uint64_t>(row) * colCount + col;
+}
@@ -0,0 +1,260 @@
+/**
+	Fixed-size thread pool for data-parallel loops
+
+	Author: Belousov K.
+	Repository: https://github.com/kombuchamp/SparseMatrices
+*/
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+enum class ThreadPinning
+{
+	None,
+	// Every worker is bound to its own logical processor, calling thread doesn't take part in jobs
+	PinToCores
+};
+
+/**
+ * Workers are started once and sleep between jobs.
+ * Calling thread takes part in every job as thread 0, workers are threads 1..n-1,
+ * so a pool of one thread runs everything inline.
+ * Pinned pool runs jobs on its own workers only, so thread index always denotes the same core.
+ * Nested calls from inside a job are executed serially by the calling worker.
+ */
+class ThreadPool
+{
+public:
+	explicit ThreadPool(size_t threadCount = std::thread::hardware_concurrency(), const ThreadPinning pinning = ThreadPinning::None)
+		: _threadCount(std::max<size_t>(1, threadCount)), _pinned(pinning == ThreadPinning::PinToCores)
+	{
+		for (size_t i = _pinned ? 0 : 1; i < _threadCount; i++)
+		{
+			_workers.emplace_back(&ThreadPool::WorkerLoop, this, i);
+		}
+	}
+	ThreadPool(const ThreadPool &) = delete;
+	ThreadPool &operator=(const ThreadPool &) = delete;
+	~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_stopping = true;
+		}
+		_jobStarted.notify_all();
+		for (auto &worker : _workers)
+		{
+			worker.join();
+		}
+	}
+	[[nodiscard]] size_t GetThreadCount() const
+	{
+		return _threadCount;
+	}
+	/**
+	 * Calls task(taskIndex, threadIndex) for every taskIndex in [0, taskCount).
+	 * Tasks are handed out dynamically, so they may differ in cost.
+	 * Blocks until all tasks are finished, rethrows the first exception thrown by a task.
+	 */
+	template<typename Task>
+	void ParallelFor(const size_t taskCount, Task &&task)
+	{
+		if (taskCount == 0)
+		{
+			return;
+		}
+		if ((_threadCount == 1 && !_pinned) || taskCount == 1 || InsideJob())
+		{
+			for (size_t i = 0; i < taskCount; i++)
+			{
+				task(i, 0);
+			}
+			return;
+		}
+		std::atomic<size_t> nextTask{ 0 };
+		Run([&](const size_t threadIndex)
+			{
+				for (auto i = nextTask++; i < taskCount; i = nextTask++)
+				{
+					task(i, threadIndex);
+				}
+			});
+	}
+	/**
+	 * Calls job(threadIndex) exactly once for every thread of the pool.
+	 * For pinned pool the same thread index is always executed by the same worker on the same core,
+	 * which allows static partitioning of data between threads.
+	 */
+	template<typename Job>
+	void RunOnEachThread(Job &&job)
+	{
+		if ((_threadCount == 1 && !_pinned) || InsideJob())
+		{
+			for (size_t i = 0; i < _threadCount; i++)
+			{
+				job(i);
+			}
+			return;
+		}
+		Run([&](const size_t threadIndex)
+			{
+				job(threadIndex);
+			});
+	}
+	/**
+	 * Splits [0, count) into contiguous ranges, calls body(begin, end, threadIndex) for each of them
+	 */
+	template<typename Body>
+	void ParallelForRange(const size_t count, Body &&body, const size_t minRangeSize = 1024)
+	{
+		const auto rangeCount = std::max<size_t>(1, std::min(4 * _threadCount, count / std::max<size_t>(1, minRangeSize)));
+		const auto rangeSize = (count + rangeCount - 1) / rangeCount;
+		ParallelFor(rangeCount,
+			[&](const size_t range, const size_t threadIndex)
+			{
+				const auto begin = range * rangeSize;
+				const auto end = std::min(count, begin + rangeSize);
+				if (begin < end)
+				{
+					body(begin, end, threadIndex);
+				}
+			});
+	}
+	static ThreadPool &Default()
+	{
+		static ThreadPool pool;
+		return pool;
+	}
+private:
+	static bool &InsideJob()
+	{
+		thread_local bool insideJob = false;
+		return insideJob;
+	}
+	using JobInvoker = void (*)(void *job, size_t threadIndex);
+	/**
+	 * Job is referenced, not copied into std::function, so dispatching a job doesn't allocate
+	 */
+	template<typename Job>
+	void Run(Job &&job)
+	{
+		Run(&job, [](void *context, const size_t threadIndex)
+			{
+				(*static_cast<std::remove_reference_t<Job> *>(context))(threadIndex);
+			});
+	}
+	void Run(void *job, const JobInvoker invoker)
+	{
+		std::lock_guard<std::mutex> runLock(_runMutex);
+		std::unique_lock<std::mutex> lock(_mutex);
+		_job = job;
+		_jobInvoker = invoker;
+		_error = nullptr;
+		_busyWorkers = _workers.size();
+		++_jobGeneration;
+		lock.unlock();
+		_jobStarted.notify_all();
+
+		if (!_pinned)
+		{
+			Execute(job, invoker, 0);
+		}
+
+		lock.lock();
+		_jobFinished.wait(lock, [this] { return _busyWorkers == 0; });
+		_job = nullptr;
+		if (_error)
+		{
+			std::rethrow_exception(_error);
+		}
+	}
+	void Execute(void *job, const JobInvoker invoker, const size_t threadIndex)
+	{
+		InsideJob() = true;
+		try
+		{
+			invoker(job, threadIndex);
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			if (!_error)
+			{
+				_error = std::current_exception();
+			}
+		}
+		InsideJob() = false;
+	}
+	void WorkerLoop(const size_t threadIndex)
+	{
+		if (_pinned)
+		{
+			PinCurrentThread(threadIndex % std::max(1u, std::thread::hardware_concurrency()));
+		}
+		size_t seenGeneration = 0;
+		while (true)
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_jobStarted.wait(lock, [&] { return _stopping || _jobGeneration != seenGeneration; });
+			if (_stopping)
+			{
+				return;
+			}
+			seenGeneration = _jobGeneration;
+			auto *job = _job;
+			const auto invoker = _jobInvoker;
+			lock.unlock();
+
+			Execute(job, invoker, threadIndex);
+
+			lock.lock();
+			if (--_busyWorkers == 0)
+			{
+				_jobFinished.notify_one();
+			}
+		}
+	}
+	static void PinCurrentThread(const size_t core)
+	{
+#if defined(_WIN32)
+		SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << (core % (8 * sizeof(DWORD_PTR))));
+#elif defined(__linux__)
+		cpu_set_t cpuSet;
+		CPU_ZERO(&cpuSet);
+		CPU_SET(core % CPU_SETSIZE, &cpuSet);
+		pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+#else
+		(void)core;
+#endif
+	}
+	const size_t _threadCount;
+	const bool _pinned;
+	std::vector<std::thread> _workers;
+	// Serializes jobs submitted by different threads
+	std::mutex _runMutex;
+	std::mutex _mutex;
+	std::condition_variable _jobStarted;
+	std::condition_variable _jobFinished;
+	void *_job = nullptr;
+	JobInvoker _jobInvoker = nullptr;
+	std::exception_ptr _error;
+	size_t _busyWorkers = 0;
+	size_t _jobGeneration = 0;
+	bool _stopping = false;
+};
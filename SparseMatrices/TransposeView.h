@@ -0,0 +1,84 @@
+/**
+	Read-only transposed view over compressed sparse matrix
+
+	Author: Belousov K.
+	Repository: https://github.com/kombuchamp/SparseMatrices
+*/
+
+#pragma once
+#include "CSRSparseMatrix.h"
+#include "CSCSparseMatrix.h"
+
+/**
+ * Reinterprets CSR matrix A as CSC matrix A^T and vice versa without copying any data.
+ * View holds a reference, so viewed matrix should outlive it.
+ * Compressed arrays accessors are only available for the orientation the viewed matrix has:
+ * row pointers of the view are column pointers of the viewed matrix and so on.
+ */
+template<typename Matrix>
+class TransposeView
+{
+public:
+	explicit TransposeView(const Matrix &matrix)
+		: _matrix(matrix)
+	{
+	}
+	[[nodiscard]] auto ElementAt(int row, int col) const
+	{
+		return _matrix.ElementAt(col, row);
+	}
+	[[nodiscard]] size_t GetNonZeroElementsCount() const
+	{
+		return _matrix.GetNonZeroElementsCount();
+	}
+	[[nodiscard]] size_t GetRowCount() const
+	{
+		return _matrix.GetColCount();
+	}
+	[[nodiscard]] size_t GetColCount() const
+	{
+		return _matrix.GetRowCount();
+	}
+	[[nodiscard]] decltype(auto) GetRowPointers() const
+	{
+		return _matrix.GetColPointers();
+	}
+	[[nodiscard]] decltype(auto) GetColIndices() const
+	{
+		return _matrix.GetRowIndices();
+	}
+	[[nodiscard]] decltype(auto) GetColPointers() const
+	{
+		return _matrix.GetRowPointers();
+	}
+	[[nodiscard]] decltype(auto) GetRowIndices() const
+	{
+		return _matrix.GetColIndices();
+	}
+	[[nodiscard]] decltype(auto) GetValues() const
+	{
+		return _matrix.GetValues();
+	}
+	template<typename T>
+	void Multiply(const T *x, T *y) const
+	{
+		_matrix.MultiplyTransposed(x, y);
+	}
+	template<typename T>
+	void MultiplyTransposed(const T *x, T *y) const
+	{
+		_matrix.Multiply(x, y);
+	}
+	[[nodiscard]] const Matrix &GetViewedMatrix() const
+	{
+		return _matrix;
+	}
+private:
+	const Matrix &_matrix;
+};
+
+template<typename Matrix>
+TransposeView<Matrix> MakeTransposeView(const Matrix &matrix)
+{
+	return TransposeView<Matrix>(matrix);
+}
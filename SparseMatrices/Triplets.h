@@ -0,0 +1,142 @@
+/**
+	Bulk input of sparse matrix elements as coordinate triplets
+
+	Author: Belousov K.
+	Repository: https://github.com/kombuchamp/SparseMatrices
+*/
+
+#pragma once
+#include <stdexcept>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+#include "RadixSort.h"
+#include "SparseIndex.h"
+#include "ThreadPool.h"
+
+/**
+ * One element of matrix in coordinate (COO) form
+ */
+template<typename T>
+struct Triplet
+{
+	size_t Row;
+	size_t Col;
+	T Value;
+};
+
+enum class TripletOrder
+{
+	// Any order, triplets are radix sorted
+	Unsorted,
+	// Row-major order with duplicates next to each other, sorting is skipped
+	Sorted
+};
+
+enum class DuplicatePolicy
+{
+	// Values of triplets with the same position are added up
+	Sum,
+	// The latest triplet in input order wins
+	LastWins
+};
+
+/**
+ * Sorts elements by key unless they are already sorted, then merges elements with equal keys
+ * in input order (radix sort is stable) in the same pass that drops zeros.
+ * maxKey bounds the keys, so that radix sort skips digits that are zero in all of them.
+ */
+template<typename T>
+void SortAndMergeByKey(std::vector<KeyedValue<T>> &items, const uint64_t maxKey, const TripletOrder order, const DuplicatePolicy policy,
+	ThreadPool &pool = ThreadPool::Default())
+{
+	if (order == TripletOrder::Unsorted)
+	{
+		std::vector<KeyedValue<T>> buffer;
+		ParallelRadixSortByKey(items, buffer, maxKey, pool);
+	}
+
+	size_t count = 0;
+	for (size_t k = 0; k < items.size(); k++)
+	{
+		if (count != 0 && items[count - 1].Key == items[k].Key)
+		{
+			if (policy == DuplicatePolicy::Sum)
+			{
+				items[count - 1].Value += items[k].Value;
+			}
+			else
+			{
+				items[count - 1].Value = items[k].Value;
+			}
+			continue;
+		}
+		// Previous position is complete, it is overwritten if it summed up to zero
+		if (count != 0 && items[count - 1].Value == T())
+		{
+			--count;
+		}
+		items[count++] = items[k];
+	}
+	if (count != 0 && items[count - 1].Value == T())
+	{
+		--count;
+	}
+	items.resize(count);
+}
+
+/**
+ * Turns triplets [first, last) of rows x cols matrix into nonzero elements sorted by row-major position,
+ * one element per position. Input elements may be of any type with Row, Col and Value members (Triplet, MatrixNode).
+ * Key of every result element is LinearPosition(row, col, cols).
+ * Keys of random access ranges are computed by all threads of the pool.
+ */
+template<typename T, typename Iterator>
+std::vector<KeyedValue<T>> SortTriplets(const size_t rows, const size_t cols, Iterator first, Iterator last,
+	const TripletOrder order, const DuplicatePolicy policy, ThreadPool &pool = ThreadPool::Default())
+{
+	const auto toKeyedValue = [&](const auto &triplet)
+	{
+		const auto row = static_cast<size_t>(triplet.Row);
+		const auto col = static_cast<size_t>(triplet.Col);
+		if (row >= rows || col >= cols)
+		{
+			throw std::invalid_argument("Element indices are out of bounds");
+		}
+		return KeyedValue<T>{ LinearPosition(row, col, cols), triplet.Value };
+	};
+
+	std::vector<KeyedValue<T>> items;
+	if constexpr (std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<Iterator>::iterator_category>::value)
+	{
+		items.resize(last - first);
+		pool.ParallelForRange(items.size(),
+			[&](size_t begin, size_t end, size_t)
+			{
+				for (auto k = begin; k < end; k++)
+				{
+					items[k] = toKeyedValue(first[k]);
+				}
+			}, 1 << 14);
+	}
+	else
+	{
+		for (; first != last; ++first)
+		{
+			items.push_back(toKeyedValue(*first));
+		}
+	}
+	if (order == TripletOrder::Sorted)
+	{
+		for (size_t k = 1; k < items.size(); k++)
+		{
+			if (items[k].Key < items[k - 1].Key)
+			{
+				throw std::invalid_argument("Triplets are not sorted");
+			}
+		}
+	}
+	SortAndMergeByKey(items, LinearPosition(rows, 0, cols), order, policy, pool);
+	return items;
+}
\ No newline at end of file
@@ -0,0 +1,318 @@
+/**
+	Dense vector kernels of iterative solvers
+
+	Author: Belousov K.
+	Repository: https://github.com/kombuchamp/SparseMatrices
+*/
+
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "CSRSparseMatrix.h"
+#include "SpMVKernels.h"
+#include "ThreadPool.h"
+
+/**
+ * Vector operations over n elements split between threads of the pool in fixed blocks.
+ * Partial sums of reductions are kept per block and added up in block order,
+ * so results don't depend on scheduling and repeated solves give identical iterates.
+ * Fused operations make one pass over their vectors where separate AXPY and dot products would make several.
+ * Nothing is allocated after Resize.
+ */
+template<typename T>
+class VectorKernels
+{
+public:
+	explicit VectorKernels(ThreadPool &pool = ThreadPool::Default())
+		: _pool(pool), _size(0), _blockSize(1)
+	{
+	}
+	void Resize(size_t size);
+	[[nodiscard]] size_t GetSize() const;
+	[[nodiscard]] ThreadPool &GetPool() const;
+	[[nodiscard]] T Dot(const T *x, const T *y);
+	[[nodiscard]] T Norm(const T *x);
+	void Copy(const T *x, T *y);
+	void Fill(T value, T *y);
+	// y += a * x
+	void Axpy(T a, const T *x, T *y);
+	// y = x + a * y
+	void Xpay(const T *x, T a, T *y);
+	// y = a * x + b * y
+	void Axpby(T a, const T *x, T b, T *y);
+	// y *= a
+	void Scale(T a, T *y);
+	// r = b - q, returns r . r
+	[[nodiscard]] T Residual(const T *b, const T *q, T *r);
+	// x += alpha * p, r -= alpha * q, returns r . r
+	[[nodiscard]] T UpdateSolution(T alpha, const T *p, const T *q, T *x, T *r);
+	// y = A * x, returns x . y
+	template<typename Matrix>
+	[[nodiscard]] T MultiplyDot(const Matrix &matrix, const T *x, T *y);
+	// y = A * x, returns d . y
+	template<typename Matrix>
+	[[nodiscard]] T MultiplyDot(const Matrix &matrix, const T *x, T *y, const T *d);
+	template<typename Index>
+	[[nodiscard]] T MultiplyDot(const CSRSparseMatrix<T, Index> &matrix, const T *x, T *y, const T *d);
+	// y = A * x
+	template<typename Matrix>
+	void Multiply(const Matrix &matrix, const T *x, T *y);
+	template<typename Index>
+	void Multiply(const CSRSparseMatrix<T, Index> &matrix, const T *x, T *y);
+	/**
+	 * Calls body(begin, end) for every block and returns sum of returned values in block order
+	 */
+	template<typename Body>
+	[[nodiscard]] T Reduce(Body &&body);
+	/**
+	 * Calls body(begin, end) for every block
+	 */
+	template<typename Body>
+	void ForEachBlock(Body &&body);
+private:
+	// Blocks are big enough to amortize task dispatch, small vectors are processed by one thread
+	static constexpr size_t MinBlockSize = 1 << 13;
+	ThreadPool &_pool;
+	size_t _size;
+	size_t _blockSize;
+	std::vector<T> _partialSums;
+};
+
+template<typename T>
+void VectorKernels<T>::Resize(const size_t size)
+{
+	const auto blockCount = std::max<size_t>(1, std::min(4 * _pool.GetThreadCount(), size / MinBlockSize));
+	_size = size;
+	_blockSize = (size + blockCount - 1) / blockCount;
+	_partialSums.assign(blockCount, T());
+}
+
+template<typename T>
+size_t VectorKernels<T>::GetSize() const
+{
+	return _size;
+}
+
+template<typename T>
+ThreadPool &VectorKernels<T>::GetPool() const
+{
+	return _pool;
+}
+
+template<typename T>
+template<typename Body>
+T VectorKernels<T>::Reduce(Body &&body)
+{
+	_pool.ParallelFor(_partialSums.size(),
+		[&](size_t block, size_t)
+		{
+			_partialSums[block] = body(block * _blockSize, std::min(_size, (block + 1) * _blockSize));
+		});
+	T sum = T();
+	for (auto &partialSum : _partialSums)
+	{
+		sum += partialSum;
+	}
+	return sum;
+}
+
+template<typename T>
+template<typename Body>
+void VectorKernels<T>::ForEachBlock(Body &&body)
+{
+	_pool.ParallelFor(_partialSums.size(),
+		[&](size_t block, size_t)
+		{
+			body(block * _blockSize, std::min(_size, (block + 1) * _blockSize));
+		});
+}
+
+template<typename T>
+T VectorKernels<T>::Dot(const T *x, const T *y)
+{
+	return Reduce(
+		[&](size_t begin, size_t end)
+		{
+			T sum = T();
+			for (auto i = begin; i < end; i++)
+			{
+				sum += x[i] * y[i];
+			}
+			return sum;
+		});
+}
+
+template<typename T>
+T VectorKernels<T>::Norm(const T *x)
+{
+	return std::sqrt(Dot(x, x));
+}
+
+template<typename T>
+void VectorKernels<T>::Copy(const T *x, T *y)
+{
+	ForEachBlock(
+		[&](size_t begin, size_t end)
+		{
+			std::copy(x + begin, x + end, y + begin);
+		});
+}
+
+template<typename T>
+void VectorKernels<T>::Fill(const T value, T *y)
+{
+	ForEachBlock(
+		[&](size_t begin, size_t end)
+		{
+			std::fill(y + begin, y + end, value);
+		});
+}
+
+template<typename T>
+void VectorKernels<T>::Axpy(const T a, const T *x, T *y)
+{
+	ForEachBlock(
+		[&](size_t begin, size_t end)
+		{
+			for (auto i = begin; i < end; i++)
+			{
+				y[i] += a * x[i];
+			}
+		});
+}
+
+template<typename T>
+void VectorKernels<T>::Xpay(const T *x, const T a, T *y)
+{
+	ForEachBlock(
+		[&](size_t begin, size_t end)
+		{
+			for (auto i = begin; i < end; i++)
+			{
+				y[i] = x[i] + a * y[i];
+			}
+		});
+}
+
+template<typename T>
+void VectorKernels<T>::Axpby(const T a, const T *x, const T b, T *y)
+{
+	ForEachBlock(
+		[&](size_t begin, size_t end)
+		{
+			for (auto i = begin; i < end; i++)
+			{
+				y[i] = a * x[i] + b * y[i];
+			}
+		});
+}
+
+template<typename T>
+void VectorKernels<T>::Scale(const T a, T *y)
+{
+	ForEachBlock(
+		[&](size_t begin, size_t end)
+		{
+			for (auto i = begin; i < end; i++)
+			{
+				y[i] *= a;
+			}
+		});
+}
+
+template<typename T>
+T VectorKernels<T>::Residual(const T *b, const T *q, T *r)
+{
+	return Reduce(
+		[&](size_t begin, size_t end)
+		{
+			T sum = T();
+			for (auto i = begin; i < end; i++)
+			{
+				r[i] = b[i] - q[i];
+				sum += r[i] * r[i];
+			}
+			return sum;
+		});
+}
+
+template<typename T>
+T VectorKernels<T>::UpdateSolution(const T alpha, const T *p, const T *q, T *x, T *r)
+{
+	return Reduce(
+		[&](size_t begin, size_t end)
+		{
+			T sum = T();
+			for (auto i = begin; i < end; i++)
+			{
+				x[i] += alpha * p[i];
+				r[i] -= alpha * q[i];
+				sum += r[i] * r[i];
+			}
+			return sum;
+		});
+}
+
+template<typename T>
+template<typename Matrix>
+T VectorKernels<T>::MultiplyDot(const Matrix &matrix, const T *x, T *y)
+{
+	return MultiplyDot(matrix, x, y, x);
+}
+
+/**
+ * Any matrix with Multiply(x, y) is multiplied as a whole, then the dot product is taken
+ */
+template<typename T>
+template<typename Matrix>
+T VectorKernels<T>::MultiplyDot(const Matrix &matrix, const T *x, T *y, const T *d)
+{
+	matrix.Multiply(x, y);
+	return Dot(d, y);
+}
+
+/**
+ * Rows of CSR matrix are multiplied block by block, every block takes its dot product
+ * while its part of y is still in cache
+ */
+template<typename T>
+template<typename Index>
+T VectorKernels<T>::MultiplyDot(const CSRSparseMatrix<T, Index> &matrix, const T *x, T *y, const T *d)
+{
+	const auto *rowPtr = matrix.GetRowPointers().data();
+	const auto *colIdx = matrix.GetColIndices().data();
+	const auto *values = matrix.GetValues().data();
+	return Reduce(
+		[&](size_t begin, size_t end)
+		{
+			MultiplyRowsByVector(rowPtr, colIdx, values, x, y, begin, end);
+			T sum = T();
+			for (auto i = begin; i < end; i++)
+			{
+				sum += d[i] * y[i];
+			}
+			return sum;
+		});
+}
+
+template<typename T>
+template<typename Matrix>
+void VectorKernels<T>::Multiply(const Matrix &matrix, const T *x, T *y)
+{
+	matrix.Multiply(x, y);
+}
+
+template<typename T>
+template<typename Index>
+void VectorKernels<T>::Multiply(const CSRSparseMatrix<T, Index> &matrix, const T *x, T *y)
+{
+	const auto *rowPtr = matrix.GetRowPointers().data();
+	const auto *colIdx = matrix.GetColIndices().data();
+	const auto *values = matrix.GetValues().data();
+	ForEachBlock(
+		[&](size_t begin, size_t end)
+		{
+			MultiplyRowsByVector(rowPtr, colIdx, values, x, y, begin, end);
+		});
+}
\ No newline at end of file
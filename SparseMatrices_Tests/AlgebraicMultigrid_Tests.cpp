@@ -0,0 +1,194 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "AllocationCounter.h"
+#include "TestMatrices.h"
+#include "../SparseMatrices/AlgebraicMultigrid.h"
+#include "../SparseMatrices/ConjugateGradient.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace SparseMatrices_Tests
+{
+	TEST_CLASS(AlgebraicMultigrid_Tests)
+	{
+	public:
+		TEST_METHOD(ShouldBuildSymmetricCoarseLevels)
+		{
+			const auto matrix = Poisson(64);
+			const AlgebraicMultigrid<> amg(matrix);
+
+			Assert::IsTrue(amg.GetLevelCount() >= 3);
+			for (size_t level = 1; level < amg.GetLevelCount(); level++)
+			{
+				const auto &coarse = amg.GetLevelMatrix(level);
+				Assert::IsTrue(coarse.GetRowCount() < amg.GetLevelMatrix(level - 1).GetRowCount());
+				Assert::AreEqual(amg.GetLevelMatrix(level - 1).GetRowCount(), amg.GetProlongator(level - 1).GetRowCount());
+				Assert::AreEqual(coarse.GetRowCount(), amg.GetProlongator(level - 1).GetColCount());
+				const auto transposed = coarse.Transposed();
+				Assert::IsTrue(coarse.GetColIndices() == transposed.GetColIndices());
+				for (size_t k = 0; k < coarse.GetValues().size(); k++)
+				{
+					Assert::AreEqual(coarse.GetValues()[k], transposed.GetValues()[k], 1e-12);
+				}
+			}
+			Assert::IsTrue(amg.GetLevelMatrix(amg.GetLevelCount() - 1).GetRowCount() <= amg.GetOptions().CoarsestSize);
+			Assert::IsTrue(amg.GetOperatorComplexity() > 1. && amg.GetOperatorComplexity() < 2.);
+		}
+
+		TEST_METHOD(ShouldConvergeAsStandaloneSolver)
+		{
+			const auto matrix = Poisson(48);
+			AlgebraicMultigrid<> amg(matrix);
+			const std::vector<double> b(matrix.GetRowCount(), 1.);
+			std::vector<double> x(b.size(), 0.);
+			const auto initial = ResidualNorm(matrix, b, x);
+
+			for (size_t cycle = 0; cycle < 10; cycle++)
+			{
+				amg.Cycle(b.data(), x.data());
+			}
+
+			Assert::IsTrue(ResidualNorm(matrix, b, x) < 1e-3 * initial);
+		}
+
+		TEST_METHOD(ShouldPreconditionConjugateGradient)
+		{
+			const auto matrix = Poisson(64);
+			ThreadPool pool(4);
+			AlgebraicMultigrid<> amg(matrix, MultigridOptions(), pool);
+			std::vector<double> b(matrix.GetRowCount());
+			for (size_t i = 0; i < b.size(); i++)
+			{
+				b[i] = static_cast<double>(i % 7) - 3.;
+			}
+			std::vector<double> x0(b.size(), 0.);
+			std::vector<double> x1(b.size(), 0.);
+			ConjugateGradient<> solver(SolverOptions(), pool);
+
+			const auto plain = solver.Solve(matrix, b, x0);
+			const auto preconditioned = solver.Solve(matrix, b, x1, amg);
+
+			Assert::IsTrue(plain.Converged && preconditioned.Converged);
+			Assert::IsTrue(preconditioned.Iterations < 20);
+			Assert::IsTrue(4 * preconditioned.Iterations < plain.Iterations);
+			Assert::IsTrue(ResidualNorm(matrix, b, x1) <= 1e-7 * plain.ResidualHistory.front());
+		}
+
+		TEST_METHOD(ShouldApplyInParallelLikeSerially)
+		{
+			const auto matrix = Poisson(100);
+			ThreadPool serialPool(1);
+			ThreadPool parallelPool(4);
+			AlgebraicMultigrid<> serial(matrix, MultigridOptions(), serialPool);
+			AlgebraicMultigrid<> parallel(matrix, MultigridOptions(), parallelPool);
+			std::vector<double> r(matrix.GetRowCount());
+			for (size_t i = 0; i < r.size(); i++)
+			{
+				r[i] = static_cast<double>(i % 11) - 5.;
+			}
+			std::vector<double> z0(r.size());
+			std::vector<double> z1(r.size());
+
+			serial.Apply(r.data(), z0.data());
+			parallel.Apply(r.data(), z1.data());
+
+			Assert::AreEqual(serial.GetLevelCount(), parallel.GetLevelCount());
+			for (size_t i = 0; i < r.size(); i++)
+			{
+				Assert::AreEqual(z0[i], z1[i], 1e-12);
+			}
+		}
+
+		TEST_METHOD(ShouldReuseHierarchyWhenValuesChange)
+		{
+			auto matrix = Poisson(32);
+			AlgebraicMultigrid<> reused(matrix);
+			const auto levelCount = reused.GetLevelCount();
+			const auto coarseNonZeros = reused.GetLevelMatrix(1).GetNonZeroElementsCount();
+			std::vector<double> r(matrix.GetRowCount(), 1.);
+			std::vector<double> z0(r.size());
+			std::vector<double> z1(r.size());
+			reused.Apply(r.data(), z0.data());
+
+			// Scaling doesn't change strength of connection, so the hierarchy is the same and the cycle scales back
+			const auto &rowPtr = matrix.GetRowPointers();
+			for (size_t i = 0; i < matrix.GetRowCount(); i++)
+			{
+				for (auto k = rowPtr[i]; k < rowPtr[i + 1]; k++)
+				{
+					const auto col = matrix.GetColIndices()[k];
+					matrix.SetElement(static_cast<int>(i), static_cast<int>(col), 2. * matrix.GetValues()[k]);
+				}
+			}
+			reused.UpdateValues();
+			reused.Apply(r.data(), z1.data());
+
+			Assert::AreEqual(levelCount, reused.GetLevelCount());
+			Assert::AreEqual(coarseNonZeros, reused.GetLevelMatrix(1).GetNonZeroElementsCount());
+			for (size_t i = 0; i < r.size(); i++)
+			{
+				Assert::AreEqual(z0[i], 2. * z1[i], 1e-12);
+			}
+		}
+
+		TEST_METHOD(ShouldNotAllocateWhenAppliedOnThreadPool)
+		{
+			ThreadPool pool(4);
+			const auto matrix = Poisson(200);
+			AlgebraicMultigrid<> amg(matrix, MultigridOptions(), pool);
+			std::vector<double> r(matrix.GetRowCount(), 1.);
+			std::vector<double> z(r.size());
+
+			AllocationCounter counter;
+			amg.Apply(r.data(), z.data());
+			amg.Apply(r.data(), z.data());
+
+			Assert::AreEqual(size_t(0), counter.GetCount());
+		}
+
+		TEST_METHOD(ShouldSolveSmallSystemDirectly)
+		{
+			const auto matrix = Poisson(5);
+			AlgebraicMultigrid<> amg(matrix);
+			const std::vector<double> b(25, 1.);
+			std::vector<double> x(25);
+
+			amg.Apply(b.data(), x.data());
+
+			Assert::AreEqual(size_t(1), amg.GetLevelCount());
+			Assert::IsTrue(ResidualNorm(matrix, b, x) < 1e-12);
+		}
+
+		TEST_METHOD(ThrowIfMatrixIsInvalid)
+		{
+			const CSRSparseMatrix<double> rectangular(2, 3);
+			std::vector<Triplet<double>> noDiagonal{ { 0, 0, 1. }, { 1, 0, 1. } };
+			const auto noDiagonalMatrix = CSRSparseMatrix<double>::FromTriplets(2, 2, noDiagonal.begin(), noDiagonal.end());
+
+			Assert::ExpectException<std::exception>([&]()
+				{
+					AlgebraicMultigrid<> amg(rectangular);
+				});
+			Assert::ExpectException<std::exception>([&]()
+				{
+					AlgebraicMultigrid<> amg(noDiagonalMatrix);
+				});
+		}
+
+		TEST_METHOD(ThrowIfPatternChangesBeforeUpdate)
+		{
+			std::vector<Triplet<double>> upper{ { 0, 0, 2. }, { 1, 1, 2. }, { 2, 2, 2. }, { 0, 1, -1. }, { 1, 0, -1. } };
+			std::vector<Triplet<double>> lower{ { 0, 0, 2. }, { 1, 1, 2. }, { 2, 2, 2. }, { 1, 2, -1. }, { 2, 1, -1. } };
+			auto matrix = CSRSparseMatrix<double>::FromTriplets(3, 3, upper.begin(), upper.end());
+			AlgebraicMultigrid<> amg(matrix);
+
+			// Same number of nonzero elements in other positions
+			matrix = CSRSparseMatrix<double>::FromTriplets(3, 3, lower.begin(), lower.end());
+
+			Assert::ExpectException<std::invalid_argument>([&]()
+				{
+					amg.UpdateValues();
+				});
+		}
+	};
+}
\ No newline at end of file
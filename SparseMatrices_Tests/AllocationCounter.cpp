@@ -0,0 +1,24 @@
+#include "pch.h"
+#include <cstdlib>
+#include <new>
+#include "AllocationCounter.h"
+
+void *operator new(const size_t size)
+{
+	SparseMatrices_Tests::AllocationCounter::OnAllocation();
+	if (auto *block = std::malloc(size == 0 ? 1 : size))
+	{
+		return block;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void *block) noexcept
+{
+	std::free(block);
+}
+
+void operator delete(void *block, size_t) noexcept
+{
+	std::free(block);
+}
\ No newline at end of file
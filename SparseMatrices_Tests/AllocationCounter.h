@@ -0,0 +1,48 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+
+namespace SparseMatrices_Tests
+{
+	/**
+	 * Counts operator new calls made by any thread while the counter is alive.
+	 * Global operator new of the test module is replaced in AllocationCounter.cpp.
+	 */
+	class AllocationCounter
+	{
+	public:
+		AllocationCounter()
+		{
+			Count() = 0;
+			Enabled() = true;
+		}
+		AllocationCounter(const AllocationCounter &) = delete;
+		AllocationCounter &operator=(const AllocationCounter &) = delete;
+		~AllocationCounter()
+		{
+			Enabled() = false;
+		}
+		[[nodiscard]] size_t GetCount() const
+		{
+			return Count();
+		}
+		static void OnAllocation()
+		{
+			if (Enabled())
+			{
+				++Count();
+			}
+		}
+	private:
+		static std::atomic<size_t> &Count()
+		{
+			static std::atomic<size_t> count{ 0 };
+			return count;
+		}
+		static std::atomic<bool> &Enabled()
+		{
+			static std::atomic<bool> enabled{ false };
+			return enabled;
+		}
+	};
+}
\ No newline at end of file
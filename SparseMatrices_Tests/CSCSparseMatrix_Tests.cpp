@@ -0,0 +1,208 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../SparseMatrices/ISparseMatrix.h"
+#include "../SparseMatrices/CSCSparseMatrix.h"
+#include "../SparseMatrices/TransposeView.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace SparseMatrices_Tests
+{
+	TEST_CLASS(CSCSparseMatrix_Tests)
+	{
+	public:
+		TEST_METHOD(ShouldSetElements)
+		{
+			CSCSparseMatrix<> mat(3, 4);
+
+			mat.SetElement(2, 1, 3.);
+			mat.SetElement(0, 1, 1.);
+			mat.SetElement(1, 3, 2.);
+
+			Assert::AreEqual(size_t(3), mat.GetRowCount());
+			Assert::AreEqual(size_t(4), mat.GetColCount());
+			Assert::AreEqual(1., mat.ElementAt(0, 1));
+			Assert::AreEqual(3., mat.ElementAt(2, 1));
+			Assert::AreEqual(2., mat.ElementAt(1, 3));
+			Assert::AreEqual(0., mat.ElementAt(2, 3));
+		}
+
+		TEST_METHOD(ShouldStoreElementsByColumns)
+		{
+			CSCSparseMatrix<int> mat(3, 3);
+			mat.SetElement(2, 0, 3);
+			mat.SetElement(0, 0, 1);
+			mat.SetElement(1, 2, 2);
+
+			const std::vector<size_t> expectedColPtr = { 0, 2, 2, 3 };
+			const std::vector<size_t> expectedRowIdx = { 0, 2, 1 };
+			const std::vector<int> expectedValues = { 1, 3, 2 };
+			Assert::IsTrue(expectedColPtr == mat.GetColPointers());
+			Assert::IsTrue(expectedRowIdx == mat.GetRowIndices());
+			Assert::IsTrue(expectedValues == mat.GetValues());
+		}
+
+		TEST_METHOD(ShouldPrintPreviewWindow)
+		{
+			CSCSparseMatrix<int> mat(3, 3);
+			mat.SetElement(0, 1, 1);
+			mat.SetElement(2, 0, 2);
+			mat.SetElement(1, 2, 3);
+
+			std::stringstream preview, full, coordinate;
+			PrintOptions previewOptions;
+			previewOptions.PreviewRows = 2;
+			previewOptions.PreviewCols = 2;
+			mat.Print(preview, previewOptions);
+			full << mat;
+			mat.Print(coordinate, PrintOptions{ PrintMode::Coordinate });
+
+			Assert::AreEqual(std::string("3 x 3, 3 nonzero elements\n0 1 ...\n0 0 ...\n...\n"), preview.str());
+			Assert::AreEqual(std::string("0 1 0 \n0 0 3 \n2 0 0 \n"), full.str());
+			Assert::AreEqual(std::string("3 3 3\n0 1 1\n1 2 3\n2 0 2\n"), coordinate.str());
+		}
+
+		TEST_METHOD(ThrowIfGettingElementOutOfBounds)
+		{
+			CSCSparseMatrix<> mat(2, 5);
+
+			Assert::ExpectException<std::exception>([&]()
+				{
+					mat.ElementAt(3, 1);
+				});
+		}
+
+		TEST_METHOD(ShouldConvertFromAndToCSRSparseMatrix)
+		{
+			CSRSparseMatrix<int> csr(2, 3);
+			csr.SetElement(0, 2, 1);
+			csr.SetElement(1, 0, 2);
+			csr.SetElement(1, 2, 3);
+
+			CSCSparseMatrix<int> csc(csr);
+			auto back = csc.ToCSRSparseMatrix();
+
+			Assert::IsTrue(csr.GetRowPointers() == back.GetRowPointers());
+			Assert::IsTrue(csr.GetColIndices() == back.GetColIndices());
+			Assert::IsTrue(csr.GetValues() == back.GetValues());
+			for (int i = 0; i < 2; i++)
+			{
+				for (int j = 0; j < 3; j++)
+				{
+					Assert::AreEqual(csr.ElementAt(i, j), csc.ElementAt(i, j));
+				}
+			}
+		}
+
+		TEST_METHOD(ShouldTakeOverTransposedCSRWithoutCopying)
+		{
+			CSRSparseMatrix<int> csr(2, 3);
+			csr.SetElement(0, 2, 1);
+			csr.SetElement(1, 0, 2);
+			const auto *values = csr.GetValues().data();
+
+			auto csc = CSCSparseMatrix<int>::FromTransposed(std::move(csr));
+
+			Assert::AreEqual(size_t(3), csc.GetRowCount());
+			Assert::AreEqual(size_t(2), csc.GetColCount());
+			Assert::AreEqual(1, csc.ElementAt(2, 0));
+			Assert::AreEqual(2, csc.ElementAt(0, 1));
+			Assert::IsTrue(values == csc.GetValues().data());
+
+			auto released = csc.ReleaseTransposed();
+			Assert::IsTrue(values == released.GetValues().data());
+			Assert::AreEqual(size_t(0), csc.GetNonZeroElementsCount());
+		}
+
+		TEST_METHOD(ShouldViewCSRAsTransposedCSC)
+		{
+			CSRSparseMatrix<int> csr(2, 3);
+			csr.SetElement(0, 1, 1);
+			csr.SetElement(1, 2, 2);
+
+			auto view = MakeTransposeView(csr);
+
+			Assert::AreEqual(size_t(3), view.GetRowCount());
+			Assert::AreEqual(size_t(2), view.GetColCount());
+			Assert::AreEqual(1, view.ElementAt(1, 0));
+			Assert::AreEqual(2, view.ElementAt(2, 1));
+			Assert::AreEqual(0, view.ElementAt(0, 0));
+			Assert::IsTrue(&csr.GetRowPointers() == &view.GetColPointers());
+			Assert::IsTrue(&csr.GetColIndices() == &view.GetRowIndices());
+		}
+
+		TEST_METHOD(ShouldViewCSCAsTransposedCSR)
+		{
+			CSCSparseMatrix<int> csc(2, 3);
+			csc.SetElement(0, 1, 1);
+			csc.SetElement(1, 2, 2);
+
+			auto view = MakeTransposeView(csc);
+
+			Assert::AreEqual(1, view.ElementAt(1, 0));
+			Assert::AreEqual(2, view.ElementAt(2, 1));
+			Assert::IsTrue(&csc.GetColPointers() == &view.GetRowPointers());
+			Assert::IsTrue(&csc.GetRowIndices() == &view.GetColIndices());
+		}
+
+		TEST_METHOD(ShouldMultiplyByVector)
+		{
+			CSCSparseMatrix<int> mat(3, 2);
+			mat.SetElement(0, 0, 1);
+			mat.SetElement(1, 1, 2);
+			mat.SetElement(2, 0, 3);
+			const int x[] = { 1, 2, 3 };
+			int y[] = { -1, -1 };
+
+			auto product = mat.Multiply(std::vector<int>{ 5, 6 });
+			mat.MultiplyTransposed(x, y);
+
+			Assert::AreEqual(5, product[0]);
+			Assert::AreEqual(12, product[1]);
+			Assert::AreEqual(15, product[2]);
+			Assert::AreEqual(10, y[0]);
+			Assert::AreEqual(4, y[1]);
+		}
+
+		TEST_METHOD(ShouldMultiplyTransposeViewByVector)
+		{
+			CSRSparseMatrix<int> csr(3, 2);
+			csr.SetElement(0, 0, 1);
+			csr.SetElement(1, 1, 2);
+			csr.SetElement(2, 0, 3);
+			CSCSparseMatrix<int> csc(csr);
+			const int x[] = { 1, 2, 3 };
+			int fromCSR[] = { 0, 0 };
+			int fromCSC[] = { 0, 0 };
+
+			MakeTransposeView(csr).Multiply(x, fromCSR);
+			MakeTransposeView(csc).Multiply(x, fromCSC);
+
+			Assert::AreEqual(10, fromCSR[0]);
+			Assert::AreEqual(4, fromCSR[1]);
+			Assert::AreEqual(10, fromCSC[0]);
+			Assert::AreEqual(4, fromCSC[1]);
+		}
+
+		TEST_METHOD(ShouldAddMatrices)
+		{
+			CSCSparseMatrix<int> mat0(2, 3);
+			CSCSparseMatrix<int> mat1(2, 3);
+			mat0.SetElement(0, 1, 1);
+			mat0.SetElement(1, 2, 2);
+			mat1.SetElement(1, 1, 3);
+			mat1.SetElement(1, 2, -2);
+
+			const auto sum = mat0.Add(mat1);
+			const auto combination = mat0.ParallelScaledAdd(3, 2, mat1);
+
+			Assert::AreEqual(size_t(2), sum.GetNonZeroElementsCount());
+			Assert::AreEqual(1, sum.ElementAt(0, 1));
+			Assert::AreEqual(3, sum.ElementAt(1, 1));
+			Assert::AreEqual(0, sum.ElementAt(1, 2));
+			Assert::AreEqual(3, combination.ElementAt(0, 1));
+			Assert::AreEqual(6, combination.ElementAt(1, 1));
+			Assert::AreEqual(2, combination.ElementAt(1, 2));
+		}
+	};
+}
@@ -0,0 +1,693 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../SparseMatrices/ISparseMatrix.h"
+#include "../SparseMatrices/CSRSparseMatrix.h"
+#include "../SparseMatrices/CSCSparseMatrix.h"
+#include "../SparseMatrices/DOKSparseMatrix.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace SparseMatrices_Tests
+{
+	TEST_CLASS(CSRSparseMatrix_Tests)
+	{
+	public:
+		TEST_METHOD(ShouldResizeCorrectly)
+		{
+			CSRSparseMatrix<> mat(2, 2);
+			mat.SetElement(1, 1, 1.);
+
+			const size_t newRows = 4;
+			const size_t newCols = 5;
+
+			mat.Resize(newRows, newCols);
+
+			Assert::AreEqual(newRows, mat.GetRowCount());
+			Assert::AreEqual(newCols, mat.GetColCount());
+			Assert::AreEqual(1., mat.ElementAt(1, 1));
+			Assert::AreEqual(0., mat.ElementAt(3, 4));
+		}
+
+		TEST_METHOD(ShouldSetElements)
+		{
+			CSRSparseMatrix<> mat(4, 4);
+
+			mat.SetElement(1, 2, 3.);
+			mat.SetElement(0, 0, 1.);
+			mat.SetElement(1, 1, 2.);
+			mat.SetElement(1, 1, 5.);
+
+			Assert::AreEqual(1., mat.ElementAt(0, 0));
+			Assert::AreEqual(5., mat.ElementAt(1, 1));
+			Assert::AreEqual(3., mat.ElementAt(1, 2));
+			Assert::AreEqual(0., mat.ElementAt(3, 3));
+			Assert::AreEqual(size_t(3), mat.GetNonZeroElementsCount());
+		}
+
+		TEST_METHOD(ShouldRemoveElements)
+		{
+			CSRSparseMatrix<> mat(4, 4);
+
+			mat.SetElement(0, 0, 1.);
+			mat.SetElement(2, 3, 1.);
+			mat.RemoveElement(0, 0);
+			mat.RemoveElement(1, 1);
+			mat.SetElement(2, 3, 0.);
+
+			Assert::AreEqual(0., mat.ElementAt(0, 0));
+			Assert::AreEqual(0., mat.ElementAt(1, 1));
+			Assert::AreEqual(0., mat.ElementAt(2, 3));
+			Assert::AreEqual(size_t(0), mat.GetNonZeroElementsCount());
+		}
+
+		TEST_METHOD(ThrowIfSettingElementOutOfBounds)
+		{
+			CSRSparseMatrix<> mat(1, 1);
+
+			Assert::ExpectException<std::exception>([&]()
+				{
+					mat.SetElement(100, 100, 1);
+				});
+		}
+
+		TEST_METHOD(ThrowIfResizeWithDataLoss)
+		{
+			CSRSparseMatrix<> mat(100, 100);
+
+			Assert::ExpectException<std::exception>([&]()
+				{
+					mat.Resize(1, 1);
+				});
+		}
+
+		TEST_METHOD(ThrowIfGettingElementOutOfBounds)
+		{
+			CSRSparseMatrix<> mat;
+
+			Assert::ExpectException<std::exception>([&]()
+				{
+					mat.ElementAt(100, 100);
+				});
+		}
+
+		TEST_METHOD(ShouldPrintOutMatrix)
+		{
+			CSRSparseMatrix<> mat(2, 2);
+			mat.SetElement(0, 1, 1.);
+			mat.SetElement(1, 0, 2.);
+
+			std::stringstream buf;
+			double tmp;
+			buf << mat;
+
+			buf >> tmp;
+			Assert::AreEqual(0., tmp);
+			buf >> tmp;
+			Assert::AreEqual(1., tmp);
+			buf >> tmp;
+			Assert::AreEqual(2., tmp);
+			buf >> tmp;
+			Assert::AreEqual(0., tmp);
+		}
+
+		TEST_METHOD(ShouldTransposeMatrix)
+		{
+			CSRSparseMatrix<> mat(2, 3);
+			mat.SetElement(0, 0, 1.);
+			mat.SetElement(0, 2, 3.);
+			mat.SetElement(1, 1, 2.);
+
+			mat.Transpose();
+
+			Assert::AreEqual(size_t(3), mat.GetRowCount());
+			Assert::AreEqual(size_t(2), mat.GetColCount());
+			Assert::AreEqual(1., mat.ElementAt(0, 0));
+			Assert::AreEqual(2., mat.ElementAt(1, 1));
+			Assert::AreEqual(3., mat.ElementAt(2, 0));
+			Assert::AreEqual(0., mat.ElementAt(0, 1));
+		}
+
+		TEST_METHOD(ShouldConvertFromAndToLLSparseMatrix)
+		{
+			LLSparseMatrix<int> source(3, 3);
+			source.SetElement(2, 0, 7);
+			source.SetElement(0, 1, 4);
+			source.SetElement(0, 0, 1);
+			source.SetElement(1, 2, 5);
+
+			CSRSparseMatrix<int> csr(source);
+			Assert::AreEqual(size_t(4), csr.GetNonZeroElementsCount());
+			Assert::AreEqual(1, csr.ElementAt(0, 0));
+			Assert::AreEqual(4, csr.ElementAt(0, 1));
+			Assert::AreEqual(5, csr.ElementAt(1, 2));
+			Assert::AreEqual(7, csr.ElementAt(2, 0));
+
+			auto roundTrip = csr.ToLLSparseMatrix();
+			Assert::AreEqual(size_t(4), roundTrip.GetNonZeroElementsCount());
+			for (int i = 0; i < 3; i++)
+			{
+				for (int j = 0; j < 3; j++)
+				{
+					Assert::AreEqual(source.ElementAt(i, j), roundTrip.ElementAt(i, j));
+				}
+			}
+		}
+
+		TEST_METHOD(ShouldMultiplyMatrices)
+		{
+			CSRSparseMatrix<int> mat0(2, 3);
+			CSRSparseMatrix<int> mat1(3, 2);
+
+			mat0.SetElement(0, 0, 1);
+			mat0.SetElement(0, 2, 2);
+			mat0.SetElement(1, 1, 3);
+
+			mat1.SetElement(0, 1, 4);
+			mat1.SetElement(1, 0, 5);
+			mat1.SetElement(2, 1, 6);
+
+			auto resultMat = mat0.Multiply(mat1);
+
+			Assert::AreEqual(0, resultMat.ElementAt(0, 0));
+			Assert::AreEqual(16, resultMat.ElementAt(0, 1));
+			Assert::AreEqual(15, resultMat.ElementAt(1, 0));
+			Assert::AreEqual(0, resultMat.ElementAt(1, 1));
+			Assert::AreEqual(size_t(2), resultMat.GetNonZeroElementsCount());
+		}
+
+		TEST_METHOD(ShouldMultiplyMatricesLikeDenseProduct)
+		{
+			const int n = 12;
+			CSRSparseMatrix<int> mat0(n, n);
+			CSRSparseMatrix<int> mat1(n, n);
+			for (int i = 0; i < n; i++)
+			{
+				for (int j = 0; j < n; j++)
+				{
+					if ((i * 7 + j * 3) % 5 == 0)
+					{
+						mat0.SetElement(i, j, i + j + 1);
+					}
+					if ((i * 2 + j * 5) % 7 == 0)
+					{
+						mat1.SetElement(i, j, i - j);
+					}
+				}
+			}
+
+			auto resultMat = mat0.Multiply(mat1);
+
+			for (int i = 0; i < n; i++)
+			{
+				for (int j = 0; j < n; j++)
+				{
+					int expected = 0;
+					for (int k = 0; k < n; k++)
+					{
+						expected += mat0.ElementAt(i, k) * mat1.ElementAt(k, j);
+					}
+					Assert::AreEqual(expected, resultMat.ElementAt(i, j));
+				}
+			}
+		}
+
+		TEST_METHOD(ThrowIfMultiplyingIncompatibleMatrices)
+		{
+			CSRSparseMatrix<int> mat0(2, 3);
+			CSRSparseMatrix<int> mat1(2, 3);
+
+			Assert::ExpectException<std::exception>([&]()
+				{
+					auto result = mat0.Multiply(mat1);
+				});
+		}
+
+		TEST_METHOD(ShouldMultiplyInParallelLikeSerially)
+		{
+			const int n = 200;
+			CSRSparseMatrix<int> mat0(n, n);
+			CSRSparseMatrix<int> mat1(n, n);
+			for (int i = 0; i < n; i++)
+			{
+				// Few dense rows and many short ones
+				const int step = i % 50 == 0 ? 1 : 17;
+				for (int j = i % step; j < n; j += step)
+				{
+					mat0.SetElement(i, j, (i + j) % 7 - 3);
+					mat1.SetElement(j, i, (i * j) % 5 - 2);
+				}
+			}
+			ThreadPool pool(4);
+
+			auto expected = mat0.Multiply(mat1);
+			auto actual = mat0.ParallelMultiply(mat1, pool);
+
+			Assert::IsTrue(expected.GetRowPointers() == actual.GetRowPointers());
+			Assert::IsTrue(expected.GetColIndices() == actual.GetColIndices());
+			Assert::IsTrue(expected.GetValues() == actual.GetValues());
+		}
+
+		TEST_METHOD(ShouldDropCancelledElementsWhenMultiplyingInParallel)
+		{
+			CSRSparseMatrix<int> mat0(2, 2);
+			CSRSparseMatrix<int> mat1(2, 2);
+			mat0.SetElement(0, 0, 1);
+			mat0.SetElement(0, 1, 1);
+			mat0.SetElement(1, 0, 2);
+			mat1.SetElement(0, 0, 1);
+			mat1.SetElement(1, 0, -1);
+			mat1.SetElement(1, 1, 3);
+			ThreadPool pool(2);
+
+			auto resultMat = mat0.ParallelMultiply(mat1, pool);
+
+			Assert::AreEqual(size_t(2), resultMat.GetNonZeroElementsCount());
+			Assert::AreEqual(0, resultMat.ElementAt(0, 0));
+			Assert::AreEqual(3, resultMat.ElementAt(0, 1));
+			Assert::AreEqual(2, resultMat.ElementAt(1, 0));
+			Assert::AreEqual(0, resultMat.ElementAt(1, 1));
+		}
+
+		TEST_METHOD(ShouldMultiplyByVector)
+		{
+			CSRSparseMatrix<int> mat(3, 4);
+			mat.SetElement(0, 0, 1);
+			mat.SetElement(0, 3, 2);
+			mat.SetElement(2, 1, 3);
+			mat.SetElement(2, 2, 4);
+
+			auto y = mat.Multiply(std::vector<int>{ 1, 2, 3, 4 });
+
+			Assert::AreEqual(size_t(3), y.size());
+			Assert::AreEqual(9, y[0]);
+			Assert::AreEqual(0, y[1]);
+			Assert::AreEqual(18, y[2]);
+		}
+
+		TEST_METHOD(ShouldMultiplyLongRowsByVector)
+		{
+			// Rows are long enough to go through vectorized kernels with a scalar tail
+			const int rows = 5;
+			const int cols = 101;
+			CSRSparseMatrix<double> matDouble(rows, cols);
+			CSRSparseMatrix<float> matFloat(rows, cols);
+			std::vector<double> xDouble(cols);
+			std::vector<float> xFloat(cols);
+			for (int j = 0; j < cols; j++)
+			{
+				xDouble[j] = j % 4 - 1.5;
+				xFloat[j] = static_cast<float>(xDouble[j]);
+			}
+			std::vector<double> expected(rows, 0.);
+			for (int i = 0; i < rows; i++)
+			{
+				for (int j = i; j < cols; j += i + 1)
+				{
+					matDouble.SetElement(i, j, 0.5 * j);
+					matFloat.SetElement(i, j, 0.5f * j);
+					expected[i] += 0.5 * j * xDouble[j];
+				}
+			}
+
+			auto yDouble = matDouble.Multiply(xDouble);
+			auto yFloat = matFloat.Multiply(xFloat);
+
+			for (int i = 0; i < rows; i++)
+			{
+				Assert::AreEqual(expected[i], yDouble[i], 1e-9);
+				Assert::AreEqual(static_cast<float>(expected[i]), yFloat[i], 1e-3f);
+			}
+		}
+
+		TEST_METHOD(ShouldMultiplyTransposedByVector)
+		{
+			CSRSparseMatrix<int> mat(3, 2);
+			mat.SetElement(0, 0, 1);
+			mat.SetElement(1, 1, 2);
+			mat.SetElement(2, 0, 3);
+			const int x[] = { 1, 2, 3 };
+			int y[] = { -1, -1 };
+
+			mat.MultiplyTransposed(x, y);
+
+			Assert::AreEqual(10, y[0]);
+			Assert::AreEqual(4, y[1]);
+		}
+
+		TEST_METHOD(ThrowIfMultiplyingByVectorOfWrongSize)
+		{
+			CSRSparseMatrix<int> mat(3, 4);
+
+			Assert::ExpectException<std::exception>([&]()
+				{
+					auto y = mat.Multiply(std::vector<int>(3));
+				});
+		}
+
+		TEST_METHOD(ShouldMultiplyByVectorInParallel)
+		{
+			const int n = 500;
+			CSRSparseMatrix<int> mat(n, n);
+			std::vector<int> x(n);
+			for (int i = 0; i < n; i++)
+			{
+				mat.SetElement(i, i, 2);
+				mat.SetElement(i, (i * 7) % n, 1);
+				x[i] = i % 3;
+			}
+			std::vector<int> actual(n);
+			ThreadPool pool(4);
+
+			auto expected = mat.Multiply(x);
+			mat.ParallelMultiply(x.data(), actual.data(), pool);
+
+			Assert::IsTrue(expected == actual);
+		}
+
+		TEST_METHOD(ShouldMultiplyByDenseBlock)
+		{
+			const size_t vectorCount = 3;
+			CSRSparseMatrix<int> mat(2, 3);
+			mat.SetElement(0, 0, 1);
+			mat.SetElement(0, 2, 2);
+			mat.SetElement(1, 1, 3);
+			const int x[] = {
+				1, 2, 3,
+				4, 5, 6,
+				7, 8, 9 };
+			int y[6];
+
+			mat.MultiplyDenseBlock(x, vectorCount, y);
+
+			const int expected[] = {
+				15, 18, 21,
+				12, 15, 18 };
+			for (int i = 0; i < 6; i++)
+			{
+				Assert::AreEqual(expected[i], y[i]);
+			}
+		}
+
+		TEST_METHOD(ShouldMultiplyByDenseBlockInParallelLikeByVectors)
+		{
+			const int n = 300;
+			const size_t vectorCount = 8;
+			CSRSparseMatrix<double> mat(n, n);
+			for (int i = 0; i < n; i++)
+			{
+				mat.SetElement(i, i, 4.);
+				mat.SetElement(i, (i * 13 + 5) % n, -1.);
+			}
+			std::vector<double> x(n * vectorCount);
+			for (size_t k = 0; k < x.size(); k++)
+			{
+				x[k] = static_cast<double>(k % 11) - 5.;
+			}
+			std::vector<double> y(n * vectorCount);
+			ThreadPool pool(4);
+
+			mat.ParallelMultiplyDenseBlock(x.data(), vectorCount, y.data(), pool);
+
+			for (size_t v = 0; v < vectorCount; v++)
+			{
+				std::vector<double> column(n);
+				for (int j = 0; j < n; j++)
+				{
+					column[j] = x[j * vectorCount + v];
+				}
+				auto expected = mat.Multiply(column);
+				for (int i = 0; i < n; i++)
+				{
+					Assert::AreEqual(expected[i], y[i * vectorCount + v], 1e-12);
+				}
+			}
+		}
+
+		TEST_METHOD(ShouldPrintInAllModes)
+		{
+			CSRSparseMatrix<int> mat(3, 3);
+			mat.SetElement(0, 2, 1);
+			mat.SetElement(2, 0, 2);
+
+			std::stringstream dense, preview, coordinate, compact;
+			PrintOptions previewOptions;
+			previewOptions.PreviewRows = 2;
+			mat.Print(dense, PrintOptions{ PrintMode::Dense });
+			mat.Print(preview, previewOptions);
+			mat.Print(coordinate, PrintOptions{ PrintMode::Coordinate });
+			mat.Print(compact, PrintOptions{ PrintMode::CompactRows });
+
+			Assert::AreEqual(std::string("0 0 1 \n0 0 0 \n2 0 0 \n"), dense.str());
+			Assert::AreEqual(std::string("3 x 3, 2 nonzero elements\n0 0 1 \n0 0 0 \n...\n"), preview.str());
+			Assert::AreEqual(std::string("3 3 2\n0 2 1\n2 0 2\n"), coordinate.str());
+			Assert::AreEqual(std::string("0: 2:1\n2: 0:2\n"), compact.str());
+		}
+
+		TEST_METHOD(ShouldMultiplyWithNarrowIndices)
+		{
+			const int n = 300;
+			CSRSparseMatrix<double> wide(n, n);
+			for (int i = 0; i < n; i++)
+			{
+				for (int k = 0; k < 20; k++)
+				{
+					wide.SetElement(i, (i * 31 + k * 17) % n, i + k + 1.);
+				}
+			}
+			CSRSparseMatrix<double, uint16_t> narrow16(wide);
+			CSRSparseMatrix<double, uint32_t> narrow32(wide);
+			CSRSparseMatrix<float, uint16_t> narrowFloat(n, n);
+			for (int i = 0; i < n; i++)
+			{
+				for (int k = 0; k < 20; k++)
+				{
+					narrowFloat.SetElement(i, (i * 31 + k * 17) % n, static_cast<float>(k + 1));
+				}
+			}
+			std::vector<double> x(n);
+			std::vector<float> xFloat(n);
+			for (int i = 0; i < n; i++)
+			{
+				x[i] = i % 7;
+				xFloat[i] = static_cast<float>(i % 7);
+			}
+
+			const auto expected = wide.Multiply(x);
+			const auto from16 = narrow16.Multiply(x);
+			const auto from32 = narrow32.Multiply(x);
+			const auto fromFloat = narrowFloat.Multiply(xFloat);
+
+			Assert::IsTrue(expected == from16);
+			Assert::IsTrue(expected == from32);
+			for (int i = 0; i < n; i++)
+			{
+				float sum = 0;
+				for (int k = 0; k < 20; k++)
+				{
+					sum += (k + 1) * xFloat[(i * 31 + k * 17) % n];
+				}
+				Assert::AreEqual(sum, fromFloat[i]);
+			}
+			Assert::IsTrue(wide.Multiply(wide).GetValues() == narrow16.Multiply(narrow16).GetValues());
+		}
+
+		TEST_METHOD(ShouldPickNarrowestIndex)
+		{
+			CSRSparseMatrix<> small(100, 65536);
+			small.SetElement(99, 65535, 1.);
+			CSRSparseMatrix<> medium(65537, 2);
+			medium.SetElement(65536, 1, 2.);
+
+			auto narrowSmall = ToNarrowestIndex(small);
+			auto narrowMedium = ToNarrowestIndex(medium);
+
+			Assert::AreEqual(size_t(0), narrowSmall.index());
+			Assert::AreEqual(size_t(1), narrowMedium.index());
+			Assert::AreEqual(1., std::get<0>(narrowSmall).ElementAt(99, 65535));
+			Assert::AreEqual(2., std::get<1>(narrowMedium).ElementAt(65536, 1));
+			Assert::ExpectException<std::exception>([&]()
+				{
+					CSRSparseMatrix<double, uint16_t> overflow(medium);
+				});
+		}
+
+		TEST_METHOD(ShouldNotTruncateDimensionsAboveIntRange)
+		{
+			if (sizeof(size_t) <= sizeof(uint32_t))
+			{
+				return;
+			}
+			const auto huge = static_cast<size_t>(std::numeric_limits<uint32_t>::max()) + 2;
+
+			LLSparseMatrix<double> list(huge, huge);
+			DOKSparseMatrix<double> dictionary(huge, 2);
+
+			Assert::AreEqual(huge, list.GetRowCount());
+			Assert::AreEqual(huge, list.GetColCount());
+			Assert::AreEqual(huge, dictionary.GetRowCount());
+			Assert::ExpectException<std::exception>([&]()
+				{
+					CSRSparseMatrix<double, uint32_t> overflow(huge, 2);
+				});
+			Assert::ExpectException<std::exception>([&]()
+				{
+					CSCSparseMatrix<double, uint32_t> overflow(2, huge);
+				});
+		}
+
+		TEST_METHOD(ShouldReuseResultStorageWhenMultiplyingInto)
+		{
+			LLSparseMatrix<double> source(40, 40);
+			for (int i = 0; i < 40; i++)
+			{
+				source.SetElement(i, i, 1.5);
+				source.SetElement(i, (i * 3 + 1) % 40, -2.0);
+			}
+			const CSRSparseMatrix<double> mat(source);
+			CSRSparseMatrix<double> result;
+			CSRSparseMatrix<double>::MultiplyWorkspace workspace;
+
+			MultiplyInto(result, mat, mat, workspace);
+			const auto *colIdx = result.GetColIndices().data();
+			const auto *values = result.GetValues().data();
+			for (int iteration = 0; iteration < 10; iteration++)
+			{
+				MultiplyInto(result, mat, mat, workspace);
+			}
+
+			Assert::IsTrue(colIdx == result.GetColIndices().data());
+			Assert::IsTrue(values == result.GetValues().data());
+			const auto expected = mat.Multiply(mat);
+			Assert::IsTrue(expected.GetRowPointers() == result.GetRowPointers());
+			Assert::IsTrue(expected.GetColIndices() == result.GetColIndices());
+			Assert::IsTrue(expected.GetValues() == result.GetValues());
+		}
+
+		TEST_METHOD(ShouldMultiplyIntoOperand)
+		{
+			CSRSparseMatrix<int> mat0(2, 3);
+			CSRSparseMatrix<int> mat1(3, 1);
+			mat0.SetElement(0, 2, 2);
+			mat0.SetElement(1, 0, 3);
+			mat1.SetElement(2, 0, 5);
+
+			MultiplyInto(mat1, mat0, mat1);
+
+			Assert::AreEqual(size_t(2), mat1.GetRowCount());
+			Assert::AreEqual(size_t(1), mat1.GetColCount());
+			Assert::AreEqual(10, mat1.ElementAt(0, 0));
+			Assert::AreEqual(0, mat1.ElementAt(1, 0));
+		}
+
+		TEST_METHOD(ShouldBuildFromTripletsLikeElementByElement)
+		{
+			const size_t rows = 300;
+			const size_t cols = 700;
+			std::vector<Triplet<double>> triplets;
+			CSRSparseMatrix<double> expected(rows, cols);
+			for (size_t k = 0; k < 5000; k++)
+			{
+				const auto row = (k * 7919) % rows;
+				const auto col = (k * 104729) % cols;
+				triplets.push_back(Triplet<double>{ row, col, k + 1. });
+				expected.SetElement(row, col, expected.ElementAt(row, col) + k + 1.);
+			}
+
+			const auto mat = CSRSparseMatrix<double>::FromTriplets(rows, cols, triplets.begin(), triplets.end());
+
+			Assert::IsTrue(expected.GetRowPointers() == mat.GetRowPointers());
+			Assert::IsTrue(expected.GetColIndices() == mat.GetColIndices());
+			Assert::IsTrue(expected.GetValues() == mat.GetValues());
+		}
+
+		TEST_METHOD(ShouldBuildFromTripletsInParallelLikeSerially)
+		{
+			const size_t rows = 5000;
+			const size_t cols = 3000;
+			std::vector<Triplet<double>> triplets;
+			for (size_t k = 0; k < 200000; k++)
+			{
+				triplets.push_back(Triplet<double>{ (k * 7919) % rows, (k * k + 13) % cols, k % 7 + 1. });
+			}
+			ThreadPool serialPool(1);
+			ThreadPool parallelPool(4);
+
+			const auto serial = CSRSparseMatrix<double>::FromTriplets(rows, cols, triplets.begin(), triplets.end(),
+				TripletOrder::Unsorted, DuplicatePolicy::LastWins, serialPool);
+			const auto parallel = CSRSparseMatrix<double>::FromTriplets(rows, cols, triplets.begin(), triplets.end(),
+				TripletOrder::Unsorted, DuplicatePolicy::LastWins, parallelPool);
+
+			Assert::IsTrue(serial.GetRowPointers() == parallel.GetRowPointers());
+			Assert::IsTrue(serial.GetColIndices() == parallel.GetColIndices());
+			Assert::IsTrue(serial.GetValues() == parallel.GetValues());
+			for (size_t i = 0; i < rows; i++)
+			{
+				const auto begin = parallel.GetRowPointers()[i];
+				const auto end = parallel.GetRowPointers()[i + 1];
+				Assert::IsTrue(std::is_sorted(parallel.GetColIndices().begin() + begin, parallel.GetColIndices().begin() + end));
+			}
+			Assert::AreEqual(static_cast<double>(199999 % 7 + 1), parallel.ElementAt(static_cast<int>((199999 * 7919) % rows), static_cast<int>((199999ull * 199999 + 13) % cols)));
+		}
+
+		TEST_METHOD(ShouldTransposeOutOfPlaceInParallel)
+		{
+			const size_t rows = 3000;
+			const size_t cols = 200;
+			std::vector<Triplet<double>> triplets;
+			std::vector<Triplet<double>> transposedTriplets;
+			for (size_t k = 0; k < 100000; k++)
+			{
+				const auto row = (k * 7919) % rows;
+				const auto col = (k * k + 5) % cols;
+				triplets.push_back(Triplet<double>{ row, col, k + 1. });
+				transposedTriplets.push_back(Triplet<double>{ col, row, k + 1. });
+			}
+			const auto mat = CSRSparseMatrix<double>::FromTriplets(rows, cols, triplets.begin(), triplets.end());
+			const auto expected = CSRSparseMatrix<double>::FromTriplets(cols, rows, transposedTriplets.begin(), transposedTriplets.end());
+			const auto copy = mat;
+			ThreadPool pool(4);
+
+			const auto transposed = mat.Transposed(pool);
+
+			Assert::AreEqual(cols, transposed.GetRowCount());
+			Assert::AreEqual(rows, transposed.GetColCount());
+			Assert::IsTrue(expected.GetRowPointers() == transposed.GetRowPointers());
+			Assert::IsTrue(expected.GetColIndices() == transposed.GetColIndices());
+			Assert::IsTrue(expected.GetValues() == transposed.GetValues());
+			Assert::IsTrue(copy.GetColIndices() == mat.GetColIndices());
+			Assert::IsTrue(copy.GetValues() == mat.GetValues());
+		}
+
+		TEST_METHOD(ShouldAddScaledMatricesInParallelLikeSerially)
+		{
+			const size_t rows = 2000;
+			const size_t cols = 500;
+			std::vector<Triplet<double>> triplets0;
+			std::vector<Triplet<double>> triplets1;
+			for (size_t k = 0; k < 20000; k++)
+			{
+				triplets0.push_back(Triplet<double>{ (k * 7919) % rows, (k * 13) % cols, k % 4 + 1. });
+				triplets1.push_back(Triplet<double>{ (k * 104729) % rows, (k * 17) % cols, k % 3 + 1. });
+			}
+			const auto mat0 = CSRSparseMatrix<double>::FromTriplets(rows, cols, triplets0.begin(), triplets0.end());
+			const auto mat1 = CSRSparseMatrix<double>::FromTriplets(rows, cols, triplets1.begin(), triplets1.end());
+			ThreadPool pool(4);
+
+			const auto serial = mat0.ScaledAdd(2., -0.5, mat1);
+			const auto parallel = mat0.ParallelScaledAdd(2., -0.5, mat1, pool);
+			const auto difference = mat0.Subtract(mat0);
+
+			Assert::IsTrue(serial.GetRowPointers() == parallel.GetRowPointers());
+			Assert::IsTrue(serial.GetColIndices() == parallel.GetColIndices());
+			Assert::IsTrue(serial.GetValues() == parallel.GetValues());
+			Assert::AreEqual(size_t(0), difference.GetNonZeroElementsCount());
+			for (int i = 0; i < 50; i++)
+			{
+				for (int j = 0; j < static_cast<int>(cols); j++)
+				{
+					Assert::AreEqual(2. * mat0.ElementAt(i, j) - 0.5 * mat1.ElementAt(i, j), serial.ElementAt(i, j));
+				}
+			}
+		}
+	};
+}
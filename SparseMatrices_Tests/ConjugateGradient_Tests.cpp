@@ -0,0 +1,107 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "AllocationCounter.h"
+#include "TestMatrices.h"
+#include "../SparseMatrices/ConjugateGradient.h"
+#include "../SparseMatrices/CSCSparseMatrix.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace SparseMatrices_Tests
+{
+	TEST_CLASS(ConjugateGradient_Tests)
+	{
+	public:
+		TEST_METHOD(ShouldSolvePoissonSystem)
+		{
+			const auto matrix = Poisson(30);
+			std::vector<double> b(900);
+			for (size_t i = 0; i < b.size(); i++)
+			{
+				b[i] = static_cast<double>(i % 7) - 3.;
+			}
+			std::vector<double> x(900, 0.);
+			ThreadPool pool(4);
+			ConjugateGradient<> solver(SolverOptions(), pool);
+
+			const auto result = solver.Solve(matrix, b, x);
+
+			Assert::IsTrue(result.Converged);
+			Assert::IsTrue(result.Iterations > 0 && result.Iterations < 200);
+			Assert::AreEqual(result.Iterations + 1, result.ResidualHistory.size());
+			// Initial guess is zero, so the first residual is b
+			const auto bNorm = result.ResidualHistory.front();
+			Assert::IsTrue(result.ResidualHistory.back() <= 1e-8 * bNorm);
+			Assert::IsTrue(ResidualNorm(matrix, b, x) <= 1e-7 * bNorm);
+		}
+
+		TEST_METHOD(ShouldSolveWithPreconditionerAndReuseSolver)
+		{
+			const auto matrix = Poisson(20);
+			const CSCSparseMatrix<double> cscMatrix(matrix);
+			JacobiPreconditioner jacobi{ std::vector<double>(400, 0.25) };
+			std::vector<double> b(400, 1.);
+			std::vector<double> x0(400, 0.);
+			std::vector<double> x1(400, 0.);
+			std::vector<double> x2(400, 0.);
+			ConjugateGradient<> solver;
+
+			const auto plain = solver.Solve(matrix, b, x0);
+			const auto preconditioned = solver.Solve(matrix, b, x1, jacobi);
+			const auto generic = solver.Solve(cscMatrix, b, x2);
+
+			Assert::IsTrue(plain.Converged && preconditioned.Converged && generic.Converged);
+			// Constant diagonal scaling doesn't change CG iterates
+			Assert::AreEqual(plain.Iterations, preconditioned.Iterations);
+			Assert::AreEqual(plain.Iterations, generic.Iterations);
+			for (size_t i = 0; i < x0.size(); i++)
+			{
+				Assert::AreEqual(x0[i], x1[i], 1e-9);
+				Assert::AreEqual(x0[i], x2[i], 1e-9);
+			}
+		}
+
+		TEST_METHOD(ShouldStopAtIterationLimit)
+		{
+			const auto matrix = Poisson(20);
+			std::vector<double> b(400, 1.);
+			std::vector<double> x(400, 0.);
+			SolverOptions options;
+			options.MaxIterations = 5;
+			options.RecordResidualHistory = false;
+			ConjugateGradient<> solver(options);
+
+			const auto result = solver.Solve(matrix, b, x);
+
+			Assert::IsFalse(result.Converged);
+			Assert::AreEqual(size_t(5), result.Iterations);
+			Assert::IsTrue(result.ResidualHistory.empty());
+			Assert::AreEqual(ResidualNorm(matrix, b, x), result.ResidualNorm, 1e-9);
+			Assert::ExpectException<std::exception>([&]()
+				{
+					std::vector<double> shortX(10);
+					solver.Solve(matrix, b, shortX);
+				});
+		}
+
+		TEST_METHOD(ShouldNotAllocateWhenReusedOnThreadPool)
+		{
+			ThreadPool pool(4);
+			const auto matrix = Poisson(200);
+			std::vector<double> b(matrix.GetRowCount(), 1.);
+			std::vector<double> x(matrix.GetRowCount(), 0.);
+			SolverOptions options;
+			options.MaxIterations = 50;
+			options.RecordResidualHistory = false;
+			ConjugateGradient<> solver(options, pool);
+			solver.Solve(matrix, b, x);
+			std::fill(x.begin(), x.end(), 0.);
+
+			AllocationCounter counter;
+			const auto result = solver.Solve(matrix, b, x);
+
+			Assert::AreEqual(size_t(50), result.Iterations);
+			Assert::AreEqual(size_t(0), counter.GetCount());
+		}
+	};
+}
@@ -0,0 +1,152 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../SparseMatrices/ISparseMatrix.h"
+#include "../SparseMatrices/DOKSparseMatrix.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace SparseMatrices_Tests
+{
+	TEST_CLASS(DOKSparseMatrix_Tests)
+	{
+	public:
+		TEST_METHOD(ShouldSetElements)
+		{
+			DOKSparseMatrix<> mat(4, 4);
+
+			mat.SetElement(1, 2, 3.);
+			mat.SetElement(0, 0, 1.);
+			mat.SetElement(1, 1, 2.);
+			mat.SetElement(1, 1, 5.);
+
+			Assert::AreEqual(1., mat.ElementAt(0, 0));
+			Assert::AreEqual(5., mat.ElementAt(1, 1));
+			Assert::AreEqual(3., mat.ElementAt(1, 2));
+			Assert::AreEqual(0., mat.ElementAt(3, 3));
+			Assert::AreEqual(size_t(3), mat.GetNonZeroElementsCount());
+		}
+
+		TEST_METHOD(ShouldRemoveElements)
+		{
+			DOKSparseMatrix<> mat(4, 4);
+
+			mat.SetElement(0, 0, 1.);
+			mat.SetElement(2, 3, 1.);
+			mat.RemoveElement(0, 0);
+			mat.RemoveElement(1, 1);
+			mat.SetElement(2, 3, 0.);
+
+			Assert::AreEqual(0., mat.ElementAt(0, 0));
+			Assert::AreEqual(0., mat.ElementAt(2, 3));
+			Assert::AreEqual(size_t(0), mat.GetNonZeroElementsCount());
+		}
+
+		TEST_METHOD(ShouldKeepElementsAfterManyInsertionsAndRemovals)
+		{
+			const int size = 64;
+			DOKSparseMatrix<int> mat(size, size);
+
+			for (int i = 0; i < size; i++)
+			{
+				for (int j = 0; j < size; j++)
+				{
+					mat.SetElement((i * 37) % size, (j * 11) % size, i * size + j + 1);
+				}
+			}
+			for (int i = 0; i < size; i += 2)
+			{
+				for (int j = 0; j < size; j++)
+				{
+					mat.RemoveElement((i * 37) % size, (j * 11) % size);
+				}
+			}
+
+			Assert::AreEqual(size_t(size * size / 2), mat.GetNonZeroElementsCount());
+			for (int i = 0; i < size; i++)
+			{
+				for (int j = 0; j < size; j++)
+				{
+					const auto expected = i % 2 == 0 ? 0 : i * size + j + 1;
+					Assert::AreEqual(expected, mat.ElementAt((i * 37) % size, (j * 11) % size));
+				}
+			}
+		}
+
+		TEST_METHOD(ThrowIfSettingElementOutOfBounds)
+		{
+			DOKSparseMatrix<> mat(1, 1);
+
+			Assert::ExpectException<std::exception>([&]()
+				{
+					mat.SetElement(100, 100, 1);
+				});
+		}
+
+		TEST_METHOD(ShouldTransposeMatrix)
+		{
+			DOKSparseMatrix<> mat(2, 3);
+			mat.SetElement(0, 2, 3.);
+			mat.SetElement(1, 0, 2.);
+
+			mat.Transpose();
+
+			Assert::AreEqual(size_t(3), mat.GetRowCount());
+			Assert::AreEqual(3., mat.ElementAt(2, 0));
+			Assert::AreEqual(2., mat.ElementAt(0, 1));
+			Assert::AreEqual(0., mat.ElementAt(1, 0));
+		}
+
+		TEST_METHOD(ShouldPrintPreviewWindow)
+		{
+			DOKSparseMatrix<int> mat(3, 3);
+			mat.SetElement(0, 1, 1);
+			mat.SetElement(2, 0, 2);
+			mat.SetElement(1, 2, 3);
+
+			std::stringstream preview, full, coordinate;
+			PrintOptions previewOptions;
+			previewOptions.PreviewRows = 2;
+			previewOptions.PreviewCols = 2;
+			mat.Print(preview, previewOptions);
+			full << mat;
+			mat.Print(coordinate, PrintOptions{ PrintMode::Coordinate });
+
+			Assert::AreEqual(std::string("3 x 3, 3 nonzero elements\n0 1 ...\n0 0 ...\n...\n"), preview.str());
+			Assert::AreEqual(std::string("0 1 0 \n0 0 3 \n2 0 0 \n"), full.str());
+			Assert::AreEqual(std::string("3 3 3\n0 1 1\n1 2 3\n2 0 2\n"), coordinate.str());
+		}
+
+		TEST_METHOD(ShouldExportSortedCSRSparseMatrix)
+		{
+			DOKSparseMatrix<int> mat(3, 4);
+			mat.SetElement(2, 3, 6);
+			mat.SetElement(0, 3, 2);
+			mat.SetElement(2, 0, 5);
+			mat.SetElement(0, 1, 1);
+			mat.SetElement(1, 2, 4);
+
+			auto csr = mat.ToCSRSparseMatrix();
+
+			const std::vector<size_t> expectedRowPtr = { 0, 2, 3, 5 };
+			const std::vector<size_t> expectedColIdx = { 1, 3, 2, 0, 3 };
+			const std::vector<int> expectedValues = { 1, 2, 4, 5, 6 };
+			Assert::IsTrue(expectedRowPtr == csr.GetRowPointers());
+			Assert::IsTrue(expectedColIdx == csr.GetColIndices());
+			Assert::IsTrue(expectedValues == csr.GetValues());
+		}
+
+		TEST_METHOD(ShouldExportLLSparseMatrix)
+		{
+			DOKSparseMatrix<int> mat(2, 2);
+			mat.SetElement(1, 1, 4);
+			mat.SetElement(0, 1, 2);
+
+			auto ll = mat.ToLLSparseMatrix();
+
+			Assert::AreEqual(size_t(2), ll.GetNonZeroElementsCount());
+			Assert::AreEqual(2, ll.ElementAt(0, 1));
+			Assert::AreEqual(4, ll.ElementAt(1, 1));
+			Assert::AreEqual(0, ll.ElementAt(1, 0));
+		}
+	};
+}
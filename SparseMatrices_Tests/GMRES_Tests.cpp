@@ -0,0 +1,84 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "TestMatrices.h"
+#include "../SparseMatrices/GMRES.h"
+#include "../SparseMatrices/CSCSparseMatrix.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace SparseMatrices_Tests
+{
+	TEST_CLASS(GMRES_Tests)
+	{
+	public:
+		TEST_METHOD(ShouldSolveNonsymmetricSystem)
+		{
+			const auto matrix = ConvectionDiffusion(30, 2.);
+			std::vector<double> b(900);
+			for (size_t i = 0; i < b.size(); i++)
+			{
+				b[i] = static_cast<double>(i % 7) - 3.;
+			}
+			std::vector<double> x(900, 0.);
+			ThreadPool pool(4);
+			GMRES<> solver(SolverOptions(), 10, pool);
+
+			const auto result = solver.Solve(matrix, b, x);
+
+			Assert::IsTrue(result.Converged);
+			Assert::IsTrue(result.Iterations > 0 && result.Iterations < 500);
+			Assert::AreEqual(result.Iterations + 1, result.ResidualHistory.size());
+			// Initial guess is zero, so the first residual is b
+			const auto bNorm = result.ResidualHistory.front();
+			Assert::IsTrue(result.ResidualNorm <= 1e-8 * bNorm);
+			Assert::IsTrue(ResidualNorm(matrix, b, x) <= 1e-7 * bNorm);
+		}
+
+		TEST_METHOD(ShouldSolveWithPreconditionerAndReuseSolver)
+		{
+			const auto matrix = ConvectionDiffusion(20, 1.);
+			const CSCSparseMatrix<double> cscMatrix(matrix);
+			JacobiPreconditioner jacobi{ std::vector<double>(400, 0.2) };
+			std::vector<double> b(400, 1.);
+			std::vector<double> x0(400, 0.);
+			std::vector<double> x1(400, 0.);
+			std::vector<double> x2(400, 0.);
+			GMRES<> solver(SolverOptions(), 10);
+
+			const auto plain = solver.Solve(matrix, b, x0);
+			const auto preconditioned = solver.Solve(matrix, b, x1, jacobi);
+			const auto generic = solver.Solve(cscMatrix, b, x2);
+
+			Assert::IsTrue(plain.Converged && preconditioned.Converged && generic.Converged);
+			Assert::AreEqual(plain.Iterations, generic.Iterations);
+			const auto bNorm = plain.ResidualHistory.front();
+			for (const auto *x : { &x0, &x1, &x2 })
+			{
+				Assert::IsTrue(ResidualNorm(matrix, b, *x) <= 1e-7 * bNorm);
+			}
+		}
+
+		TEST_METHOD(ShouldStopAtIterationLimit)
+		{
+			const auto matrix = ConvectionDiffusion(20, 1.);
+			std::vector<double> b(400, 1.);
+			std::vector<double> x(400, 0.);
+			SolverOptions options;
+			options.MaxIterations = 5;
+			options.RecordResidualHistory = false;
+			GMRES<> solver(options, 10);
+
+			const auto result = solver.Solve(matrix, b, x);
+
+			Assert::IsFalse(result.Converged);
+			Assert::AreEqual(size_t(5), result.Iterations);
+			Assert::IsTrue(result.ResidualHistory.empty());
+			Assert::AreEqual(ResidualNorm(matrix, b, x), result.ResidualNorm, 1e-9);
+			Assert::ExpectException<std::exception>([&]()
+				{
+					std::vector<double> shortX(10);
+					solver.Solve(matrix, b, shortX);
+				});
+		}
+	};
+}
\ No newline at end of file
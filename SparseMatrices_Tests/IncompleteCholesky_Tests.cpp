@@ -0,0 +1,120 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "TestMatrices.h"
+#include "../SparseMatrices/IncompleteCholesky.h"
+#include "../SparseMatrices/ConjugateGradient.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace SparseMatrices_Tests
+{
+	TEST_CLASS(IncompleteCholesky_Tests)
+	{
+	public:
+		TEST_METHOD(ShouldSolveTridiagonalSystemExactly)
+		{
+			std::vector<Triplet<double>> triplets;
+			for (size_t i = 0; i < 50; i++)
+			{
+				triplets.push_back({ i, i, 2. });
+				if (i > 0) triplets.push_back({ i, i - 1, -1. });
+				if (i + 1 < 50) triplets.push_back({ i, i + 1, -1. });
+			}
+			const auto matrix = CSRSparseMatrix<double>::FromTriplets(50, 50, triplets.begin(), triplets.end());
+			IncompleteCholesky<> ic(matrix);
+			std::vector<double> b(50, 1.);
+			std::vector<double> x(50);
+
+			ic.Apply(b.data(), x.data());
+
+			const auto ax = matrix.Multiply(x);
+			for (size_t i = 0; i < b.size(); i++)
+			{
+				Assert::AreEqual(b[i], ax[i], 1e-10);
+			}
+		}
+
+		TEST_METHOD(ShouldPreconditionConjugateGradient)
+		{
+			const auto matrix = Poisson(40);
+			ThreadPool pool(4);
+			const IncompleteCholesky<> ic(matrix, pool);
+			std::vector<double> b(1600, 1.);
+			std::vector<double> x0(1600, 0.);
+			std::vector<double> x1(1600, 0.);
+			ConjugateGradient<> solver(SolverOptions(), pool);
+
+			const auto plain = solver.Solve(matrix, b, x0);
+			const auto preconditioned = solver.Solve(matrix, b, x1, ic);
+
+			Assert::IsTrue(plain.Converged && preconditioned.Converged);
+			Assert::IsTrue(preconditioned.Iterations < plain.Iterations);
+			for (size_t i = 0; i < x0.size(); i++)
+			{
+				Assert::AreEqual(x0[i], x1[i], 1e-6);
+			}
+		}
+
+		TEST_METHOD(ShouldApplyInParallelLikeSerially)
+		{
+			const auto matrix = Poisson(300);
+			ThreadPool serialPool(1);
+			ThreadPool parallelPool(4);
+			IncompleteCholesky<> serial(matrix, serialPool);
+			IncompleteCholesky<> parallel(matrix, parallelPool);
+			std::vector<double> r(matrix.GetRowCount());
+			for (size_t i = 0; i < r.size(); i++)
+			{
+				r[i] = static_cast<double>(i % 11) - 5.;
+			}
+			std::vector<double> z0(r.size());
+			std::vector<double> z1(r.size());
+
+			serial.Apply(r.data(), z0.data());
+			parallel.Apply(r.data(), z1.data());
+
+			Assert::IsTrue(z0 == z1);
+			Assert::AreEqual(size_t(599), parallel.GetLowerSchedule().GetLevelCount());
+		}
+
+		TEST_METHOD(ShouldRefactorizeWithSamePattern)
+		{
+			const auto matrix = Poisson(8);
+			IncompleteCholesky<> ic(matrix);
+			std::vector<double> r(64, 1.);
+			std::vector<double> z0(64);
+			std::vector<double> z1(64);
+			ic.Apply(r.data(), z0.data());
+
+			// Factors of 4 A are 2 L, so the preconditioned vector shrinks by 4
+			ic.Factorize(Poisson(8, 4.));
+			ic.Apply(r.data(), z1.data());
+
+			for (size_t i = 0; i < r.size(); i++)
+			{
+				Assert::AreEqual(z0[i], 4. * z1[i], 1e-14);
+			}
+			Assert::ExpectException<std::exception>([&]()
+				{
+					ic.Factorize(Poisson(7));
+				});
+		}
+
+		TEST_METHOD(ThrowIfNotPositiveDefinite)
+		{
+			std::vector<Triplet<double>> triplets{ { 0, 0, 1. }, { 1, 0, 2. }, { 0, 1, 2. }, { 1, 1, 1. } };
+			const auto matrix = CSRSparseMatrix<double>::FromTriplets(2, 2, triplets.begin(), triplets.end());
+			std::vector<Triplet<double>> noDiagonal{ { 0, 0, 1. }, { 1, 0, 1. } };
+			const auto noDiagonalMatrix = CSRSparseMatrix<double>::FromTriplets(2, 2, noDiagonal.begin(), noDiagonal.end());
+
+			Assert::ExpectException<std::exception>([&]()
+				{
+					IncompleteCholesky<> ic(matrix);
+				});
+			Assert::ExpectException<std::exception>([&]()
+				{
+					IncompleteCholesky<> ic(noDiagonalMatrix);
+				});
+		}
+	};
+}
\ No newline at end of file
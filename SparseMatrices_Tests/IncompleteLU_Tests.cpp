@@ -0,0 +1,152 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "TestMatrices.h"
+#include "../SparseMatrices/IncompleteLU.h"
+#include "../SparseMatrices/GMRES.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace SparseMatrices_Tests
+{
+	TEST_CLASS(IncompleteLU_Tests)
+	{
+	public:
+		TEST_METHOD(ShouldSolveTridiagonalSystemExactly)
+		{
+			// ILU(0) of a tridiagonal matrix has no dropped fill-in, so it is the exact LU
+			std::vector<Triplet<double>> triplets;
+			for (size_t i = 0; i < 50; i++)
+			{
+				triplets.push_back({ i, i, 3. });
+				if (i > 0) triplets.push_back({ i, i - 1, -1. });
+				if (i + 1 < 50) triplets.push_back({ i, i + 1, -2. });
+			}
+			const auto matrix = CSRSparseMatrix<double>::FromTriplets(50, 50, triplets.begin(), triplets.end());
+			IncompleteLU<> ilu(matrix);
+			std::vector<double> b(50);
+			for (size_t i = 0; i < b.size(); i++)
+			{
+				b[i] = static_cast<double>(i % 5);
+			}
+			std::vector<double> x(50);
+
+			ilu.Apply(b.data(), x.data());
+
+			const auto ax = matrix.Multiply(x);
+			for (size_t i = 0; i < b.size(); i++)
+			{
+				Assert::AreEqual(b[i], ax[i], 1e-10);
+			}
+			Assert::AreEqual(size_t(50), ilu.GetLowerSchedule().GetLevelCount());
+			Assert::AreEqual(size_t(50), ilu.GetUpperSchedule().GetLevelCount());
+		}
+
+		TEST_METHOD(ShouldScheduleGridByAntidiagonals)
+		{
+			const auto matrix = ConvectionDiffusion(10, 1.);
+			IncompleteLU<> ilu;
+
+			ilu.Analyze(matrix);
+
+			const auto &schedule = ilu.GetLowerSchedule();
+			Assert::AreEqual(size_t(19), schedule.GetLevelCount());
+			Assert::AreEqual(size_t(19), ilu.GetUpperSchedule().GetLevelCount());
+			Assert::AreEqual(size_t(100), schedule.GetRowCount());
+			// Level l holds the points with i + j == l
+			for (size_t l = 0; l < schedule.GetLevelCount(); l++)
+			{
+				for (auto k = schedule.GetLevelPointers()[l]; k < schedule.GetLevelPointers()[l + 1]; k++)
+				{
+					const auto row = schedule.GetRows()[k];
+					Assert::AreEqual(l, row / 10 + row % 10);
+				}
+			}
+		}
+
+		TEST_METHOD(ShouldApplyInParallelLikeSerially)
+		{
+			const auto matrix = ConvectionDiffusion(300, 1.);
+			ThreadPool serialPool(1);
+			ThreadPool parallelPool(4);
+			IncompleteLU<> serial(matrix, serialPool);
+			IncompleteLU<> parallel(matrix, parallelPool);
+			std::vector<double> r(matrix.GetRowCount());
+			for (size_t i = 0; i < r.size(); i++)
+			{
+				r[i] = static_cast<double>(i % 11) - 5.;
+			}
+			std::vector<double> z0(r.size());
+			std::vector<double> z1(r.size());
+
+			serial.Apply(r.data(), z0.data());
+			parallel.Apply(r.data(), z1.data());
+
+			Assert::IsTrue(z0 == z1);
+		}
+
+		TEST_METHOD(ShouldPreconditionGMRES)
+		{
+			const auto matrix = ConvectionDiffusion(30, 2.);
+			const IncompleteLU<> ilu(matrix);
+			std::vector<double> b(900, 1.);
+			std::vector<double> x0(900, 0.);
+			std::vector<double> x1(900, 0.);
+			GMRES<> solver(SolverOptions(), 30);
+
+			const auto plain = solver.Solve(matrix, b, x0);
+			const auto preconditioned = solver.Solve(matrix, b, x1, ilu);
+
+			Assert::IsTrue(plain.Converged && preconditioned.Converged);
+			Assert::IsTrue(2 * preconditioned.Iterations < plain.Iterations);
+			for (size_t i = 0; i < x0.size(); i++)
+			{
+				Assert::AreEqual(x0[i], x1[i], 1e-6);
+			}
+		}
+
+		TEST_METHOD(ShouldRefactorizeWithSamePattern)
+		{
+			const auto matrix = ConvectionDiffusion(8, 1.);
+			const auto scaled = ConvectionDiffusion(8, 1., 2.);
+			IncompleteLU<> reused(matrix);
+			const IncompleteLU<> fresh(scaled);
+			std::vector<double> r(64, 1.);
+			std::vector<double> z0(64);
+			std::vector<double> z1(64);
+
+			reused.Factorize(scaled);
+			reused.Apply(r.data(), z0.data());
+			fresh.Apply(r.data(), z1.data());
+
+			for (size_t i = 0; i < r.size(); i++)
+			{
+				Assert::AreEqual(z1[i], z0[i], 1e-14);
+			}
+			Assert::ExpectException<std::exception>([&]()
+				{
+					reused.Factorize(ConvectionDiffusion(7, 1.));
+				});
+		}
+
+		TEST_METHOD(ThrowIfDiagonalIsMissing)
+		{
+			std::vector<Triplet<double>> triplets{ { 0, 0, 1. }, { 1, 0, 1. }, { 0, 1, 1. } };
+			const auto matrix = CSRSparseMatrix<double>::FromTriplets(2, 2, triplets.begin(), triplets.end());
+			std::vector<Triplet<double>> singular{ { 0, 0, 1. }, { 0, 1, 1. }, { 1, 0, 1. }, { 1, 1, 1. } };
+			const auto singularMatrix = CSRSparseMatrix<double>::FromTriplets(2, 2, singular.begin(), singular.end());
+
+			Assert::ExpectException<std::exception>([&]()
+				{
+					IncompleteLU<> ilu(matrix);
+				});
+			Assert::ExpectException<std::exception>([&]()
+				{
+					IncompleteLU<> ilu(singularMatrix);
+				});
+			Assert::ExpectException<std::exception>([&]()
+				{
+					IncompleteLU<> ilu(CSRSparseMatrix<double>(2, 3));
+				});
+		}
+	};
+}
\ No newline at end of file
@@ -2,6 +2,8 @@
 #include "CppUnitTest.h"
 #include "../SparseMatrices/ISparseMatrix.h"
 #include "../SparseMatrices/LLSparseMatrix.h"
+#include "../SparseMatrices/CSRSparseMatrix.h"
+#include "../SparseMatrices/NodePoolAllocator.h"
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
@@ -321,5 +323,261 @@ namespace SparseMatrices_Tests
 			Assert::AreEqual(0, resultMat.ElementAt(2, 1));
 			Assert::AreEqual(0, resultMat.ElementAt(2, 2));
 		}
+
+		TEST_METHOD(ShouldMultiplyMatricesWithEmptyRows)
+		{
+			LLSparseMatrix<int> mat0(3, 4);
+			LLSparseMatrix<int> mat1(4, 3);
+
+			mat0.SetElement(0, 1, 2);
+			mat0.SetElement(0, 3, 1);
+			mat0.SetElement(2, 0, 3);
+			mat0.SetElement(2, 2, 4);
+
+			mat1.SetElement(1, 2, 5);
+			mat1.SetElement(3, 0, 6);
+			mat1.SetElement(3, 2, 7);
+
+			auto resultMat = mat0.Multiply(mat1);
+
+			Assert::AreEqual(6, resultMat.ElementAt(0, 0));
+			Assert::AreEqual(0, resultMat.ElementAt(0, 1));
+			Assert::AreEqual(17, resultMat.ElementAt(0, 2));
+			Assert::AreEqual(0, resultMat.ElementAt(1, 2));
+			Assert::AreEqual(0, resultMat.ElementAt(2, 0));
+			Assert::AreEqual(0, resultMat.ElementAt(2, 2));
+			Assert::AreEqual(size_t(2), resultMat.GetNonZeroElementsCount());
+		}
+
+		TEST_METHOD(ShouldPrintPreviewOfLargeMatrix)
+		{
+			LLSparseMatrix<int> mat(100000, 100000);
+			mat.SetElement(0, 1, 5);
+			mat.SetElement(1, 0, 7);
+			mat.SetElement(99999, 99999, 9);
+
+			std::stringstream buf;
+			PrintOptions options;
+			options.PreviewRows = 2;
+			options.PreviewCols = 3;
+			mat.Print(buf, options);
+
+			Assert::AreEqual(std::string("100000 x 100000, 3 nonzero elements\n0 5 0 ...\n7 0 0 ...\n...\n"), buf.str());
+		}
+
+		TEST_METHOD(ShouldPrintNonZerosOnly)
+		{
+			LLSparseMatrix<int> mat(100000, 100000);
+			mat.SetElement(3, 4, 1);
+			mat.SetElement(3, 7, 2);
+			mat.SetElement(99999, 0, 3);
+
+			std::stringstream coordinate;
+			std::stringstream compact;
+			mat.Print(coordinate, PrintOptions{ PrintMode::Coordinate });
+			mat.Print(compact, PrintOptions{ PrintMode::CompactRows });
+
+			Assert::AreEqual(std::string("100000 100000 3\n3 4 1\n3 7 2\n99999 0 3\n"), coordinate.str());
+			Assert::AreEqual(std::string("3: 4:1 7:2\n99999: 0:3\n"), compact.str());
+		}
+
+		TEST_METHOD(ShouldKeepOrderOfElementsBeyond32BitPositions)
+		{
+			LLSparseMatrix<int> mat(100000, 100000);
+			mat.SetElement(99999, 5, 1);
+			mat.SetElement(50000, 99999, 2);
+			mat.SetElement(99999, 4, 3);
+			mat.SetElement(0, 0, 4);
+
+			std::stringstream buf;
+			mat.Print(buf, PrintOptions{ PrintMode::Coordinate });
+
+			Assert::AreEqual(std::string("100000 100000 4\n0 0 4\n50000 99999 2\n99999 4 3\n99999 5 1\n"), buf.str());
+		}
+
+		TEST_METHOD(ShouldStoreNarrowIndices)
+		{
+			LLSparseMatrix<float, std::allocator<MatrixNode<float>>, uint16_t> mat(3, 3);
+			mat.SetElement(2, 1, 1.f);
+			mat.SetElement(0, 2, 2.f);
+			mat.Transpose();
+
+			Assert::AreEqual(size_t(8), sizeof(MatrixNode<float, uint16_t>));
+			Assert::AreEqual(1.f, mat.ElementAt(1, 2));
+			Assert::AreEqual(2.f, mat.ElementAt(2, 0));
+			Assert::ExpectException<std::exception>([&]()
+				{
+					LLSparseMatrix<float, std::allocator<MatrixNode<float>>, uint16_t> big(70000, 2);
+				});
+			Assert::ExpectException<std::exception>([&]()
+				{
+					mat.Resize(3, 65537);
+				});
+		}
+
+		TEST_METHOD(ShouldMultiplyIntoExistingResult)
+		{
+			LLSparseMatrix<int> mat0(3, 4);
+			LLSparseMatrix<int> mat1(4, 2);
+			mat0.SetElement(0, 1, 2);
+			mat0.SetElement(0, 3, 1);
+			mat0.SetElement(2, 0, 5);
+			mat1.SetElement(1, 0, 3);
+			mat1.SetElement(3, 0, 4);
+			mat1.SetElement(0, 1, 7);
+			LLSparseMatrix<int> result(5, 5);
+			result.SetElement(4, 4, 9);
+			result.SetElement(1, 1, 9);
+			result.SetElement(0, 0, 9);
+			LLSparseMatrix<int>::MultiplyWorkspace workspace;
+
+			MultiplyInto(result, mat0, mat1, workspace);
+
+			Assert::AreEqual(size_t(3), result.GetRowCount());
+			Assert::AreEqual(size_t(2), result.GetColCount());
+			Assert::AreEqual(size_t(2), result.GetNonZeroElementsCount());
+			Assert::AreEqual(10, result.ElementAt(0, 0));
+			Assert::AreEqual(35, result.ElementAt(2, 1));
+			Assert::AreEqual(0, result.ElementAt(1, 1));
+		}
+
+		TEST_METHOD(ShouldNotAllocateWhenMultiplyingIntoSameResult)
+		{
+			using PooledMatrix = LLSparseMatrix<double, NodePoolAllocator<MatrixNode<double>>>;
+			PooledMatrix mat(50, 50);
+			for (int i = 0; i < 50; i++)
+			{
+				mat.SetElement(i, i, 2.0);
+				mat.SetElement(i, (i * 7) % 50, 1.0);
+			}
+			PooledMatrix result;
+			PooledMatrix::MultiplyWorkspace workspace;
+
+			MultiplyInto(result, mat, mat, workspace);
+			const auto reserved = result.GetAllocator().GetPool()->GetReservedBytes();
+			for (int iteration = 0; iteration < 10; iteration++)
+			{
+				MultiplyInto(result, mat, mat, workspace);
+			}
+
+			Assert::AreEqual(reserved, result.GetAllocator().GetPool()->GetReservedBytes());
+			const auto expected = mat.Multiply(mat);
+			Assert::AreEqual(expected.GetNonZeroElementsCount(), result.GetNonZeroElementsCount());
+			for (int i = 0; i < 50; i++)
+			{
+				for (int j = 0; j < 50; j++)
+				{
+					Assert::AreEqual(expected.ElementAt(i, j), result.ElementAt(i, j));
+				}
+			}
+		}
+
+		TEST_METHOD(ShouldMultiplyIntoOperand)
+		{
+			LLSparseMatrix<int> mat0(2, 2);
+			LLSparseMatrix<int> mat1(2, 2);
+			mat0.SetElement(0, 0, 1);
+			mat0.SetElement(0, 1, 2);
+			mat0.SetElement(1, 1, 3);
+			mat1.SetElement(1, 0, 4);
+
+			MultiplyInto(mat0, mat0, mat1);
+
+			Assert::AreEqual(size_t(2), mat0.GetNonZeroElementsCount());
+			Assert::AreEqual(8, mat0.ElementAt(0, 0));
+			Assert::AreEqual(12, mat0.ElementAt(1, 0));
+		}
+
+		TEST_METHOD(ShouldBuildFromUnsortedTriplets)
+		{
+			const std::vector<Triplet<int>> triplets = {
+				{ 2, 1, 4 }, { 0, 3, 1 }, { 2, 1, 5 }, { 1, 0, 7 }, { 0, 0, 2 }, { 1, 2, 3 }, { 1, 2, -3 }
+			};
+
+			const auto mat = LLSparseMatrix<int>::FromTriplets(3, 4, triplets.begin(), triplets.end());
+
+			Assert::AreEqual(size_t(3), mat.GetRowCount());
+			Assert::AreEqual(size_t(4), mat.GetColCount());
+			Assert::AreEqual(size_t(4), mat.GetNonZeroElementsCount());
+			std::ostringstream os;
+			mat.Print(os, PrintOptions{ PrintMode::Coordinate });
+			Assert::AreEqual(std::string("3 4 4\n0 0 2\n0 3 1\n1 0 7\n2 1 9\n"), os.str());
+		}
+
+		TEST_METHOD(ShouldBuildFromSortedTripletsKeepingLastDuplicate)
+		{
+			const std::vector<Triplet<int>> triplets = { { 0, 1, 1 }, { 0, 1, 6 }, { 1, 0, 2 }, { 1, 1, 3 }, { 1, 1, 0 } };
+
+			const auto mat = LLSparseMatrix<int>::FromTriplets(2, 2, triplets.begin(), triplets.end(),
+				TripletOrder::Sorted, DuplicatePolicy::LastWins);
+
+			Assert::AreEqual(size_t(2), mat.GetNonZeroElementsCount());
+			Assert::AreEqual(6, mat.ElementAt(0, 1));
+			Assert::AreEqual(2, mat.ElementAt(1, 0));
+			Assert::AreEqual(0, mat.ElementAt(1, 1));
+		}
+
+		TEST_METHOD(ThrowIfTripletsAreInvalid)
+		{
+			const std::vector<Triplet<int>> unsorted = { { 1, 0, 1 }, { 0, 1, 1 } };
+			const std::vector<Triplet<int>> outOfBounds = { { 0, 2, 1 } };
+
+			Assert::ExpectException<std::exception>([&]()
+				{
+					auto mat = LLSparseMatrix<int>::FromTriplets(2, 2, unsorted.begin(), unsorted.end(), TripletOrder::Sorted);
+				});
+			Assert::ExpectException<std::exception>([&]()
+				{
+					auto mat = LLSparseMatrix<int>::FromTriplets(2, 2, outOfBounds.begin(), outOfBounds.end());
+				});
+		}
+
+		TEST_METHOD(ShouldTransposeLargeMatrix)
+		{
+			std::vector<Triplet<int>> triplets;
+			for (size_t k = 0; k < 100000; k++)
+			{
+				triplets.push_back(Triplet<int>{ k % 400, (k * 31) % 997, static_cast<int>(k % 5 + 1) });
+			}
+			auto mat = LLSparseMatrix<int>::FromTriplets(400, 997, triplets.begin(), triplets.end());
+			auto expected = CSRSparseMatrix<int>::FromTriplets(400, 997, triplets.begin(), triplets.end());
+			expected.Transpose();
+
+			mat.Transpose();
+
+			const CSRSparseMatrix<int> transposed(mat);
+			Assert::IsTrue(expected.GetRowPointers() == transposed.GetRowPointers());
+			Assert::IsTrue(expected.GetColIndices() == transposed.GetColIndices());
+			Assert::IsTrue(expected.GetValues() == transposed.GetValues());
+		}
+
+		TEST_METHOD(ShouldAddAndSubtractMatrices)
+		{
+			LLSparseMatrix<int> mat0(3, 3);
+			LLSparseMatrix<int> mat1(3, 3);
+			mat0.SetElement(0, 0, 1);
+			mat0.SetElement(1, 2, 4);
+			mat0.SetElement(2, 1, 5);
+			mat1.SetElement(0, 2, 2);
+			mat1.SetElement(1, 2, 4);
+			mat1.SetElement(2, 0, 3);
+
+			const auto sum = mat0.Add(mat1);
+			const auto difference = mat0.Subtract(mat1);
+			const auto combination = mat0.ScaledAdd(2, -3, mat1);
+
+			std::ostringstream os;
+			sum.Print(os, PrintOptions{ PrintMode::CompactRows });
+			difference.Print(os, PrintOptions{ PrintMode::CompactRows });
+			combination.Print(os, PrintOptions{ PrintMode::CompactRows });
+			Assert::AreEqual(std::string(
+				"0: 0:1 2:2\n1: 2:8\n2: 0:3 1:5\n"
+				"0: 0:1 2:-2\n2: 0:-3 1:5\n"
+				"0: 0:2 2:-6\n1: 2:-4\n2: 0:-9 1:10\n"), os.str());
+			Assert::ExpectException<std::exception>([&]()
+				{
+					auto result = mat0.Add(LLSparseMatrix<int>(3, 4));
+				});
+		}
 	};
 }
\ No newline at end of file
@@ -0,0 +1,210 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../SparseMatrices/MappedCSRSparseMatrix.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace SparseMatrices_Tests
+{
+	TEST_CLASS(MappedCSRSparseMatrix_Tests)
+	{
+	public:
+		TEST_METHOD(ShouldMapWrittenSnapshot)
+		{
+			const std::string path = "MappedCSRSparseMatrix_Tests_map.bin";
+			CSRSparseMatrix<> csr(3, 4);
+			csr.SetElement(0, 1, 1.5);
+			csr.SetElement(2, 0, -2.);
+			csr.SetElement(2, 3, 4.);
+			BinarySnapshot::WriteFile(path, csr);
+
+			{
+				MappedCSRSparseMatrix<> mapped(path, SnapshotVerification::Checksum);
+
+				Assert::AreEqual(size_t(3), mapped.GetRowCount());
+				Assert::AreEqual(size_t(4), mapped.GetColCount());
+				Assert::AreEqual(size_t(3), mapped.GetNonZeroElementsCount());
+				for (int i = 0; i < 3; i++)
+				{
+					for (int j = 0; j < 4; j++)
+					{
+						Assert::AreEqual(csr.ElementAt(i, j), mapped.ElementAt(i, j));
+					}
+				}
+				Assert::AreEqual(size_t(0), reinterpret_cast<uintptr_t>(mapped.GetValues()) % 64);
+				auto copy = mapped.ToCSRSparseMatrix();
+				Assert::IsTrue(csr.GetRowPointers() == copy.GetRowPointers());
+				Assert::IsTrue(csr.GetColIndices() == copy.GetColIndices());
+				Assert::IsTrue(csr.GetValues() == copy.GetValues());
+			}
+			std::remove(path.c_str());
+		}
+
+		TEST_METHOD(ShouldMultiplyMappedMatrixByVector)
+		{
+			const std::string path = "MappedCSRSparseMatrix_Tests_multiply.bin";
+			const int n = 1000;
+			CSRSparseMatrix<float> csr(n, n);
+			for (int i = 0; i < n; i++)
+			{
+				csr.SetElement(i, i, 2.f);
+				csr.SetElement(i, (i * 7) % n, 1.f);
+			}
+			BinarySnapshot::WriteFile(path, csr);
+			std::vector<float> x(n);
+			for (int i = 0; i < n; i++)
+			{
+				x[i] = static_cast<float>(i % 10);
+			}
+
+			{
+				MappedCSRSparseMatrix<float> mapped(path);
+				ThreadPool pool(4);
+				std::vector<float> parallel(n);
+				std::vector<float> transposed(n), expectedTransposed(n);
+				mapped.ParallelMultiply(x.data(), parallel.data(), pool);
+				mapped.MultiplyTransposed(x.data(), transposed.data());
+				csr.MultiplyTransposed(x.data(), expectedTransposed.data());
+
+				Assert::IsTrue(csr.Multiply(x) == mapped.Multiply(x));
+				Assert::IsTrue(csr.Multiply(x) == parallel);
+				Assert::IsTrue(expectedTransposed == transposed);
+			}
+			std::remove(path.c_str());
+		}
+
+		TEST_METHOD(ShouldMapEmptyMatrix)
+		{
+			const std::string path = "MappedCSRSparseMatrix_Tests_empty.bin";
+			BinarySnapshot::WriteFile(path, CSRSparseMatrix<int>(2, 2));
+
+			{
+				MappedCSRSparseMatrix<int> mapped(path, SnapshotVerification::Checksum);
+				Assert::AreEqual(size_t(0), mapped.GetNonZeroElementsCount());
+				Assert::AreEqual(0, mapped.ElementAt(1, 1));
+			}
+			std::remove(path.c_str());
+		}
+
+		TEST_METHOD(ThrowIfValueTypeDoesNotMatch)
+		{
+			const std::string path = "MappedCSRSparseMatrix_Tests_type.bin";
+			CSRSparseMatrix<> csr(2, 2);
+			csr.SetElement(0, 0, 1.);
+			BinarySnapshot::WriteFile(path, csr);
+
+			Assert::ExpectException<std::exception>([&]()
+				{
+					MappedCSRSparseMatrix<float> mapped(path);
+				});
+			Assert::ExpectException<std::exception>([&]()
+				{
+					MappedCSRSparseMatrix<long long> mapped(path);
+				});
+			std::remove(path.c_str());
+
+			BinarySnapshot::WriteFile(path, CSRSparseMatrix<int>(2, 2));
+			Assert::ExpectException<std::exception>([&]()
+				{
+					MappedCSRSparseMatrix<unsigned> mapped(path);
+				});
+			std::remove(path.c_str());
+		}
+
+		TEST_METHOD(ThrowIfSnapshotIsCorrupted)
+		{
+			const std::string path = "MappedCSRSparseMatrix_Tests_corrupted.bin";
+			CSRSparseMatrix<> csr(2, 2);
+			csr.SetElement(1, 1, 1.);
+			std::stringstream buf;
+			BinarySnapshot::Write(buf, csr);
+			auto data = buf.str();
+			data[data.size() - 1] ^= 1;
+			{
+				std::ofstream file(path, std::ios::binary);
+				file << data;
+			}
+
+			{
+				MappedCSRSparseMatrix<> unchecked(path);
+				Assert::AreEqual(size_t(1), unchecked.GetNonZeroElementsCount());
+			}
+			Assert::ExpectException<std::exception>([&]()
+				{
+					MappedCSRSparseMatrix<> mapped(path, SnapshotVerification::Checksum);
+				});
+			{
+				std::ofstream file(path, std::ios::binary);
+				file << data.substr(0, data.size() - 1);
+			}
+			Assert::ExpectException<std::exception>([&]()
+				{
+					MappedCSRSparseMatrix<> mapped(path);
+				});
+			std::remove(path.c_str());
+		}
+
+		TEST_METHOD(ThrowIfSnapshotStructureIsInvalid)
+		{
+			const std::string path = "MappedCSRSparseMatrix_Tests_structure.bin";
+			CSRSparseMatrix<> csr(2, 2);
+			csr.SetElement(0, 0, 1.);
+			csr.SetElement(1, 1, 2.);
+			std::stringstream buf;
+			BinarySnapshot::Write(buf, csr);
+			const auto data = buf.str();
+			const auto writeWith = [&](size_t offset, size_t value)
+			{
+				auto corrupted = data;
+				std::memcpy(&corrupted[offset], &value, sizeof(value));
+				std::ofstream file(path, std::ios::binary);
+				file << corrupted;
+			};
+			const size_t rowPtrOffset = 64;
+			const size_t colIdxOffset = 128;
+
+			// Column index beyond column count passes only the header check
+			writeWith(colIdxOffset + sizeof(size_t), 5);
+			{
+				MappedCSRSparseMatrix<> unchecked(path);
+				Assert::AreEqual(size_t(2), unchecked.GetNonZeroElementsCount());
+			}
+			Assert::ExpectException<std::exception>([&]()
+				{
+					MappedCSRSparseMatrix<> mapped(path, SnapshotVerification::Structure);
+				});
+			writeWith(rowPtrOffset + sizeof(size_t), 3);
+			Assert::ExpectException<std::exception>([&]()
+				{
+					MappedCSRSparseMatrix<> mapped(path, SnapshotVerification::Structure);
+				});
+			writeWith(rowPtrOffset + 2 * sizeof(size_t), 1);
+			Assert::ExpectException<std::exception>([&]()
+				{
+					MappedCSRSparseMatrix<> mapped(path);
+				});
+			std::remove(path.c_str());
+		}
+
+		TEST_METHOD(ShouldMapSnapshotWithNarrowIndices)
+		{
+			const std::string path = "MappedCSRSparseMatrix_Tests_narrow.bin";
+			CSRSparseMatrix<float, uint32_t> csr(3, 5);
+			csr.SetElement(0, 4, 1.f);
+			csr.SetElement(2, 1, 2.f);
+			BinarySnapshot::WriteFile(path, csr);
+
+			{
+				MappedCSRSparseMatrix<float, uint32_t> mapped(path, SnapshotVerification::Checksum);
+				Assert::AreEqual(1.f, mapped.ElementAt(0, 4));
+				Assert::AreEqual(2.f, mapped.ElementAt(2, 1));
+				Assert::AreEqual(0.f, mapped.ElementAt(1, 1));
+				Assert::ExpectException<std::exception>([&]()
+					{
+						MappedCSRSparseMatrix<float> wide(path);
+					});
+			}
+			std::remove(path.c_str());
+		}
+	};
+}
@@ -0,0 +1,324 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../SparseMatrices/MatrixMarket.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace SparseMatrices_Tests
+{
+	TEST_CLASS(MatrixMarket_Tests)
+	{
+	public:
+		TEST_METHOD(ShouldReadCoordinateRealGeneral)
+		{
+			std::stringstream buf(
+				"%%MatrixMarket matrix coordinate real general\n"
+				"% comment\n"
+				"3 4 4\n"
+				"3 1 -2.5\n"
+				"1 4 1e2\n"
+				"1 2 +0.5\n"
+				"2 3 3\n");
+
+			auto mat = MatrixMarket::Read<double>(buf);
+
+			Assert::AreEqual(size_t(3), mat.GetRowCount());
+			Assert::AreEqual(size_t(4), mat.GetColCount());
+			Assert::AreEqual(size_t(4), mat.GetNonZeroElementsCount());
+			Assert::AreEqual(0.5, mat.ElementAt(0, 1));
+			Assert::AreEqual(100., mat.ElementAt(0, 3));
+			Assert::AreEqual(3., mat.ElementAt(1, 2));
+			Assert::AreEqual(-2.5, mat.ElementAt(2, 0));
+			const std::vector<size_t> expectedColIdx = { 1, 3, 2, 0 };
+			Assert::IsTrue(expectedColIdx == mat.GetColIndices());
+		}
+
+		TEST_METHOD(ShouldReadSymmetricAndSkewSymmetricMatrices)
+		{
+			std::stringstream symmetric(
+				"%%MatrixMarket matrix coordinate integer symmetric\r\n"
+				"3 3 3\r\n"
+				"1 1 4\r\n"
+				"3 1 2\r\n"
+				"3 2 5\r\n");
+			std::stringstream skew(
+				"%%MatrixMarket matrix coordinate integer skew-symmetric\n"
+				"2 2 1\n"
+				"2 1 7\n");
+
+			auto sym = MatrixMarket::Read<int>(symmetric);
+			auto skw = MatrixMarket::Read<int>(skew);
+
+			Assert::AreEqual(size_t(5), sym.GetNonZeroElementsCount());
+			Assert::AreEqual(4, sym.ElementAt(0, 0));
+			Assert::AreEqual(2, sym.ElementAt(2, 0));
+			Assert::AreEqual(2, sym.ElementAt(0, 2));
+			Assert::AreEqual(5, sym.ElementAt(1, 2));
+			Assert::AreEqual(7, skw.ElementAt(1, 0));
+			Assert::AreEqual(-7, skw.ElementAt(0, 1));
+		}
+
+		TEST_METHOD(ShouldReadPatternMatrix)
+		{
+			std::stringstream buf(
+				"%%MatrixMarket matrix coordinate pattern general\n"
+				"2 2 2\n"
+				"2 1\n"
+				"1 2\n");
+
+			auto mat = MatrixMarket::Read<float>(buf);
+
+			Assert::AreEqual(1.f, mat.ElementAt(0, 1));
+			Assert::AreEqual(1.f, mat.ElementAt(1, 0));
+			Assert::AreEqual(0.f, mat.ElementAt(0, 0));
+		}
+
+		TEST_METHOD(ShouldReadArrayMatrices)
+		{
+			std::stringstream general(
+				"%%MatrixMarket matrix array real general\n"
+				"2 3\n"
+				"1\n0\n0\n2\n3\n4\n");
+			std::stringstream symmetric(
+				"%%MatrixMarket matrix array real symmetric\n"
+				"3 3\n"
+				"1\n2\n3\n4\n5\n6\n");
+
+			auto gen = MatrixMarket::Read<double>(general);
+			auto sym = MatrixMarket::Read<double>(symmetric);
+
+			Assert::AreEqual(size_t(4), gen.GetNonZeroElementsCount());
+			Assert::AreEqual(1., gen.ElementAt(0, 0));
+			Assert::AreEqual(2., gen.ElementAt(1, 1));
+			Assert::AreEqual(3., gen.ElementAt(0, 2));
+			Assert::AreEqual(4., gen.ElementAt(1, 2));
+			Assert::AreEqual(2., sym.ElementAt(1, 0));
+			Assert::AreEqual(2., sym.ElementAt(0, 1));
+			Assert::AreEqual(4., sym.ElementAt(1, 1));
+			Assert::AreEqual(5., sym.ElementAt(1, 2));
+			Assert::AreEqual(6., sym.ElementAt(2, 2));
+		}
+
+		TEST_METHOD(ShouldSumDuplicateEntries)
+		{
+			std::stringstream buf(
+				"%%MatrixMarket matrix coordinate integer general\n"
+				"1 3 3\n"
+				"1 3 1\n"
+				"1 1 2\n"
+				"1 3 5\n");
+
+			auto mat = MatrixMarket::Read<int>(buf);
+
+			Assert::AreEqual(size_t(2), mat.GetNonZeroElementsCount());
+			Assert::AreEqual(6, mat.ElementAt(0, 2));
+		}
+
+		TEST_METHOD(ShouldWriteAndReadBack)
+		{
+			CSRSparseMatrix<double> source(3, 3);
+			source.SetElement(0, 0, 1.25);
+			source.SetElement(1, 0, -3.);
+			source.SetElement(0, 1, -3.);
+			source.SetElement(2, 2, 1e-7);
+
+			const MatrixMarketFormat formats[] = { MatrixMarketFormat::Coordinate, MatrixMarketFormat::Array };
+			const MatrixMarketSymmetry symmetries[] = { MatrixMarketSymmetry::General, MatrixMarketSymmetry::Symmetric };
+			for (auto format : formats)
+			{
+				for (auto symmetry : symmetries)
+				{
+					std::stringstream buf;
+					MatrixMarket::Write(buf, source, format, symmetry);
+					auto result = MatrixMarket::Read<double>(buf);
+
+					Assert::IsTrue(source.GetRowPointers() == result.GetRowPointers());
+					Assert::IsTrue(source.GetColIndices() == result.GetColIndices());
+					Assert::IsTrue(source.GetValues() == result.GetValues());
+				}
+			}
+		}
+
+		TEST_METHOD(ThrowIfWrittenMatrixDoesNotMatchHeader)
+		{
+			CSRSparseMatrix<double> skew(2, 2);
+			skew.SetElement(1, 0, 2.);
+			skew.SetElement(0, 1, -2.);
+			CSRSparseMatrix<double> general(skew);
+			general.SetElement(0, 1, 2.5);
+			CSRSparseMatrix<double> diagonal(skew);
+			diagonal.SetElement(1, 1, 1.);
+
+			std::stringstream buf;
+			MatrixMarket::Write(buf, skew, MatrixMarketFormat::Coordinate, MatrixMarketSymmetry::SkewSymmetric);
+			auto result = MatrixMarket::Read<double>(buf);
+			Assert::IsTrue(skew.GetValues() == result.GetValues());
+			Assert::ExpectException<std::invalid_argument>([&]()
+				{
+					MatrixMarket::Write(buf, skew, MatrixMarketFormat::Coordinate, MatrixMarketSymmetry::Symmetric);
+				});
+			Assert::ExpectException<std::invalid_argument>([&]()
+				{
+					MatrixMarket::Write(buf, general, MatrixMarketFormat::Array, MatrixMarketSymmetry::SkewSymmetric);
+				});
+			Assert::ExpectException<std::invalid_argument>([&]()
+				{
+					MatrixMarket::Write(buf, diagonal, MatrixMarketFormat::Coordinate, MatrixMarketSymmetry::SkewSymmetric);
+				});
+			Assert::ExpectException<std::invalid_argument>([&]()
+				{
+					MatrixMarket::Write(buf, skew, MatrixMarketFormat::Coordinate, MatrixMarketSymmetry::General, MatrixMarketField::Integer);
+				});
+		}
+
+		TEST_METHOD(ThrowIfBannerIsInvalid)
+		{
+			std::stringstream buf(
+				"%%MatrixMarket matrix coordinate complex general\n"
+				"1 1 0\n");
+
+			Assert::ExpectException<std::invalid_argument>([&]()
+				{
+					auto mat = MatrixMarket::Read<double>(buf);
+				});
+		}
+
+		TEST_METHOD(ThrowIfEntriesAreMissing)
+		{
+			std::stringstream buf(
+				"%%MatrixMarket matrix coordinate real general\n"
+				"2 2 2\n"
+				"1 1 1\n");
+
+			Assert::ExpectException<std::invalid_argument>([&]()
+				{
+					auto mat = MatrixMarket::Read<double>(buf);
+				});
+		}
+
+		TEST_METHOD(ThrowIfEntryIsOutOfBounds)
+		{
+			std::stringstream buf(
+				"%%MatrixMarket matrix coordinate real general\n"
+				"2 2 1\n"
+				"3 1 1\n");
+
+			Assert::ExpectException<std::invalid_argument>([&]()
+				{
+					auto mat = MatrixMarket::Read<double>(buf);
+				});
+		}
+
+		TEST_METHOD(ThrowIfValueDoesNotFitMatrixType)
+		{
+			std::stringstream real(
+				"%%MatrixMarket matrix coordinate real general\n"
+				"1 1 1\n"
+				"1 1 1.75\n");
+			std::stringstream fractional(
+				"%%MatrixMarket matrix coordinate integer general\n"
+				"1 1 1\n"
+				"1 1 1.75\n");
+			std::stringstream trailing(
+				"%%MatrixMarket matrix coordinate real general\n"
+				"1 1 1\n"
+				"1 1x 2\n");
+
+			Assert::ExpectException<std::invalid_argument>([&]()
+				{
+					auto mat = MatrixMarket::Read<int>(real);
+				});
+			Assert::ExpectException<std::invalid_argument>([&]()
+				{
+					auto mat = MatrixMarket::Read<int>(fractional);
+				});
+			Assert::ExpectException<std::invalid_argument>([&]()
+				{
+					auto mat = MatrixMarket::Read<double>(trailing);
+				});
+		}
+
+		TEST_METHOD(ShouldReadStreamLongerThanReadBlock)
+		{
+			const int n = 100000;
+			std::stringstream buf;
+			buf << "%%MatrixMarket matrix coordinate real general\n" << n << " " << n << " " << 2 * n << "\n";
+			for (int i = n; i > 0; i--)
+			{
+				buf << i << " " << i << " " << i * 0.5 << "\n";
+				buf << i << " " << (i * 7) % n + 1 << " " << -i << "\n";
+			}
+
+			auto mat = MatrixMarket::Read<double>(buf);
+
+			Assert::AreEqual(size_t(2 * n), mat.GetNonZeroElementsCount());
+			Assert::AreEqual(0.5, mat.ElementAt(0, 0));
+			Assert::AreEqual(-1., mat.ElementAt(0, 7));
+			Assert::AreEqual(n * 0.5, mat.ElementAt(n - 1, n - 1));
+		}
+
+		TEST_METHOD(ShouldReadFileInParallel)
+		{
+			const int n = 20000;
+			const std::string path = "MatrixMarket_Tests_parallel.mtx";
+			std::stringstream buf;
+			buf << "%%MatrixMarket matrix coordinate real symmetric\n% comment\n" << n << " " << n << " " << 3 * n << "\n";
+			for (int i = n; i > 0; i--)
+			{
+				buf << i << " " << i << " " << i * 0.5 << "\r\n";
+				buf << i << " " << (i * 7) % i + 1 << " " << -i << "\n";
+				buf << "% comment\n\n" << i << " " << i << " " << 1 << "\n";
+			}
+			{
+				std::ofstream file(path, std::ios::binary);
+				file << buf.str();
+			}
+
+			ThreadPool pool(4);
+			auto parallel = MatrixMarket::ReadFileParallel<double>(path, pool);
+			auto serial = MatrixMarket::Read<double>(buf);
+			std::remove(path.c_str());
+
+			Assert::AreEqual(size_t(n), parallel.GetRowCount());
+			Assert::IsTrue(serial.GetRowPointers() == parallel.GetRowPointers());
+			Assert::IsTrue(serial.GetColIndices() == parallel.GetColIndices());
+			Assert::IsTrue(serial.GetValues() == parallel.GetValues());
+			Assert::AreEqual(n * 0.5 + 1, parallel.ElementAt(n - 1, n - 1));
+		}
+
+		TEST_METHOD(ShouldReadArrayFileInParallel)
+		{
+			const std::string path = "MatrixMarket_Tests_array.mtx";
+			{
+				std::ofstream file(path, std::ios::binary);
+				file << "%%MatrixMarket matrix array real general\n2 2\n1\n0\n-3\n4\n";
+			}
+
+			auto mat = MatrixMarket::ReadFileParallel<double>(path);
+			std::remove(path.c_str());
+
+			Assert::AreEqual(size_t(3), mat.GetNonZeroElementsCount());
+			Assert::AreEqual(-3., mat.ElementAt(0, 1));
+			Assert::AreEqual(4., mat.ElementAt(1, 1));
+		}
+
+		TEST_METHOD(ThrowIfParallelFileHasWrongEntryCount)
+		{
+			const std::string path = "MatrixMarket_Tests_invalid.mtx";
+			{
+				std::ofstream file(path, std::ios::binary);
+				file << "%%MatrixMarket matrix coordinate real general\n2 2 3\n1 1 1\n2 2 2\n";
+			}
+
+			Assert::ExpectException<std::exception>([&]()
+				{
+					auto mat = MatrixMarket::ReadFileParallel<double>(path);
+				});
+			std::remove(path.c_str());
+			Assert::ExpectException<std::exception>([&]()
+				{
+					auto mat = MatrixMarket::ReadFileParallel<double>(path);
+				});
+		}
+	};
+}
@@ -0,0 +1,116 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../SparseMatrices/NodePoolAllocator.h"
+#include "../SparseMatrices/LLSparseMatrix.h"
+#include "../SparseMatrices/CSRSparseMatrix.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace SparseMatrices_Tests
+{
+	TEST_CLASS(NodePoolAllocator_Tests)
+	{
+	public:
+		TEST_METHOD(ShouldReuseFreedBlocks)
+		{
+			NodePool pool;
+
+			auto *first = pool.Allocate(24, 8);
+			auto *second = pool.Allocate(24, 8);
+			pool.Deallocate(first, 24, 8);
+			auto *third = pool.Allocate(24, 8);
+
+			Assert::IsTrue(first != second);
+			Assert::IsTrue(first == third);
+			Assert::AreEqual(size_t(0), reinterpret_cast<uintptr_t>(second) % 8);
+		}
+
+		TEST_METHOD(ShouldPackBlocksByTheirAlignment)
+		{
+			NodePool pool;
+
+			auto *first = static_cast<char *>(pool.Allocate(40, 8));
+			auto *second = static_cast<char *>(pool.Allocate(40, 8));
+			auto *aligned = static_cast<char *>(pool.Allocate(48, alignof(std::max_align_t)));
+			auto *next = static_cast<char *>(pool.Allocate(48, alignof(std::max_align_t)));
+
+			Assert::AreEqual(ptrdiff_t(40), second - first);
+			Assert::AreEqual(ptrdiff_t(48), next - aligned);
+			Assert::AreEqual(size_t(0), reinterpret_cast<uintptr_t>(next) % alignof(std::max_align_t));
+			Assert::AreEqual(size_t(64 * 40 + 64 * 48), pool.GetReservedBytes());
+		}
+
+		TEST_METHOD(ShouldAllocateNodesFromSlabs)
+		{
+			NodePoolAllocator<MatrixNode<int>> allocator;
+			std::vector<MatrixNode<int> *> nodes;
+
+			for (int i = 0; i < 1000; i++)
+			{
+				nodes.push_back(allocator.allocate(1));
+			}
+			const auto reserved = allocator.GetPool()->GetReservedBytes();
+			for (auto *node : nodes)
+			{
+				allocator.deallocate(node, 1);
+			}
+			for (int i = 0; i < 1000; i++)
+			{
+				nodes[i] = allocator.allocate(1);
+			}
+
+			Assert::IsTrue(reserved >= 1000 * sizeof(MatrixNode<int>));
+			Assert::IsTrue(reserved < 3000 * sizeof(MatrixNode<int>) + 1024);
+			Assert::AreEqual(reserved, allocator.GetPool()->GetReservedBytes());
+		}
+
+		TEST_METHOD(ShouldBuildPooledLLSparseMatrix)
+		{
+			LLSparseMatrix<int, NodePoolAllocator<MatrixNode<int>>> pooled(3, 3);
+			LLSparseMatrix<int> plain(3, 3);
+			for (int i = 0; i < 3; i++)
+			{
+				for (int j = 0; j < 3; j++)
+				{
+					pooled.SetElement(j, i, i + j + 1);
+					plain.SetElement(j, i, i + j + 1);
+				}
+			}
+			pooled.RemoveElement(1, 1);
+			plain.RemoveElement(1, 1);
+
+			auto product = pooled.Multiply(pooled);
+			auto expected = plain.Multiply(plain);
+			CSRSparseMatrix<int> csr(product);
+
+			Assert::AreEqual(size_t(8), pooled.GetNonZeroElementsCount());
+			Assert::IsTrue(pooled.GetAllocator().GetPool()->GetReservedBytes() > 0);
+			Assert::IsTrue(product.GetAllocator() != pooled.GetAllocator());
+			for (int i = 0; i < 3; i++)
+			{
+				for (int j = 0; j < 3; j++)
+				{
+					Assert::AreEqual(expected.ElementAt(i, j), product.ElementAt(i, j));
+					Assert::AreEqual(expected.ElementAt(i, j), csr.ElementAt(i, j));
+				}
+			}
+		}
+
+		TEST_METHOD(ShouldGiveCopyItsOwnPool)
+		{
+			NodePoolAllocator<MatrixNode<double>> allocator;
+			LLSparseMatrix<double, NodePoolAllocator<MatrixNode<double>>> mat(2, 2, allocator);
+			mat.SetElement(0, 1, 1.);
+
+			auto copy = mat;
+			auto moved = std::move(mat);
+			copy.SetElement(1, 0, 2.);
+
+			Assert::IsTrue(moved.GetAllocator() == allocator);
+			Assert::IsTrue(copy.GetAllocator() != allocator);
+			Assert::AreEqual(1., moved.ElementAt(0, 1));
+			Assert::AreEqual(0., moved.ElementAt(1, 0));
+			Assert::AreEqual(2., copy.ElementAt(1, 0));
+		}
+	};
+}
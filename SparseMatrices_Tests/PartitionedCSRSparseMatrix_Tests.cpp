@@ -0,0 +1,76 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../SparseMatrices/PartitionedCSRSparseMatrix.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace SparseMatrices_Tests
+{
+	TEST_CLASS(PartitionedCSRSparseMatrix_Tests)
+	{
+	public:
+		TEST_METHOD(ShouldMultiplyByVectorLikeCSRSparseMatrix)
+		{
+			const int n = 300;
+			CSRSparseMatrix<double> source(n, n);
+			for (int i = 0; i < n; i++)
+			{
+				const int step = i < 10 ? 1 : 23;
+				for (int j = i % step; j < n; j += step)
+				{
+					source.SetElement(i, j, (i + 2 * j) % 9 - 4.);
+				}
+			}
+			std::vector<double> x(n);
+			for (int j = 0; j < n; j++)
+			{
+				x[j] = j % 5 - 2.;
+			}
+			PartitionedCSRSparseMatrix<double> partitioned(source, 3);
+
+			auto expected = source.Multiply(x);
+			auto actual = partitioned.Multiply(x);
+
+			Assert::AreEqual(size_t(3), partitioned.GetPartitionCount());
+			Assert::AreEqual(source.GetNonZeroElementsCount(), partitioned.GetNonZeroElementsCount());
+			for (int i = 0; i < n; i++)
+			{
+				Assert::AreEqual(expected[i], actual[i], 1e-9);
+			}
+		}
+
+		TEST_METHOD(ShouldBalancePartitionsByNonZeroElements)
+		{
+			// First row holds half of all elements
+			CSRSparseMatrix<int> source(101, 100);
+			for (int j = 0; j < 100; j++)
+			{
+				source.SetElement(0, j, 1);
+				source.SetElement(j + 1, j, 1);
+			}
+
+			PartitionedCSRSparseMatrix<int> partitioned(source, 2);
+
+			Assert::AreEqual(size_t(0), partitioned.GetPartitionFirstRow(0));
+			Assert::AreEqual(size_t(1), partitioned.GetPartitionFirstRow(1));
+		}
+
+		TEST_METHOD(ShouldFirstTouchResultVector)
+		{
+			CSRSparseMatrix<int> source(5, 5);
+			source.SetElement(4, 4, 2);
+			PartitionedCSRSparseMatrix<int> partitioned(source, 2);
+			std::unique_ptr<int[]> y(new int[5]);
+			const int x[] = { 1, 1, 1, 1, 3 };
+
+			partitioned.FirstTouch(y.get());
+			for (int i = 0; i < 5; i++)
+			{
+				Assert::AreEqual(0, y[i]);
+			}
+			partitioned.Multiply(x, y.get());
+
+			Assert::AreEqual(6, y[4]);
+		}
+	};
+}
@@ -0,0 +1,198 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "AllocationCounter.h"
+#include "TestMatrices.h"
+#include "../SparseMatrices/Relaxation.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace SparseMatrices_Tests
+{
+	TEST_CLASS(Relaxation_Tests)
+	{
+	public:
+		TEST_METHOD(ShouldReduceResidualWithEverySweepKind)
+		{
+			const auto matrix = Poisson(10);
+			Relaxation<> relaxation(matrix);
+			const std::vector<double> b(100, 1.);
+			const auto initial = ResidualNorm(matrix, b, std::vector<double>(100, 0.));
+			std::vector<double> jacobi(100, 0.);
+			std::vector<double> gaussSeidel(100, 0.);
+			std::vector<double> sor(100, 0.);
+			std::vector<double> multicolor(100, 0.);
+
+			relaxation.Jacobi(b.data(), jacobi.data(), 20, 0.8);
+			relaxation.GaussSeidel(b.data(), gaussSeidel.data(), 20);
+			relaxation.SOR(b.data(), sor.data(), 1.5, 20);
+			relaxation.MulticolorGaussSeidel(b.data(), multicolor.data(), 20);
+
+			const auto jacobiResidual = ResidualNorm(matrix, b, jacobi);
+			const auto gaussSeidelResidual = ResidualNorm(matrix, b, gaussSeidel);
+			Assert::IsTrue(jacobiResidual < initial);
+			Assert::IsTrue(gaussSeidelResidual < jacobiResidual);
+			Assert::IsTrue(ResidualNorm(matrix, b, sor) < gaussSeidelResidual);
+			Assert::IsTrue(ResidualNorm(matrix, b, multicolor) < jacobiResidual);
+		}
+
+		TEST_METHOD(ShouldSweepLikeDefinition)
+		{
+			const auto matrix = Poisson(4);
+			Relaxation<> relaxation(matrix);
+			std::vector<double> b(16);
+			std::vector<double> x0(16);
+			for (size_t i = 0; i < b.size(); i++)
+			{
+				b[i] = static_cast<double>(i % 3);
+				x0[i] = static_cast<double>(i % 5) * 0.1;
+			}
+			auto jacobi = x0;
+			auto gaussSeidel = x0;
+			auto backward = x0;
+			auto expectedJacobi = x0;
+			auto expectedGaussSeidel = x0;
+			auto expectedBackward = x0;
+			const auto relaxRow = [&](std::vector<double> &target, const std::vector<double> &source, size_t i)
+			{
+				double sum = b[i];
+				for (size_t j = 0; j < 16; j++)
+				{
+					if (j != i)
+					{
+						sum -= matrix.ElementAt(static_cast<int>(i), static_cast<int>(j)) * source[j];
+					}
+				}
+				target[i] = sum / 4.;
+			};
+			for (size_t i = 0; i < 16; i++)
+			{
+				relaxRow(expectedJacobi, x0, i);
+				relaxRow(expectedGaussSeidel, expectedGaussSeidel, i);
+				relaxRow(expectedBackward, expectedBackward, 15 - i);
+			}
+
+			relaxation.Jacobi(b.data(), jacobi.data());
+			relaxation.GaussSeidel(b.data(), gaussSeidel.data());
+			relaxation.GaussSeidel(b.data(), backward.data(), 1, SweepDirection::Backward);
+
+			for (size_t i = 0; i < 16; i++)
+			{
+				Assert::AreEqual(expectedJacobi[i], jacobi[i], 1e-14);
+				Assert::AreEqual(expectedGaussSeidel[i], gaussSeidel[i], 1e-14);
+				Assert::AreEqual(expectedBackward[i], backward[i], 1e-14);
+			}
+		}
+
+		TEST_METHOD(ShouldColorGridRedBlack)
+		{
+			const auto matrix = Poisson(10);
+			Relaxation<> relaxation(matrix);
+
+			Assert::AreEqual(size_t(2), relaxation.GetColorCount());
+			const auto &coloring = relaxation.GetColoring();
+			for (size_t color = 0; color < 2; color++)
+			{
+				for (auto k = coloring.GetLevelPointers()[color]; k < coloring.GetLevelPointers()[color + 1]; k++)
+				{
+					const auto row = coloring.GetRows()[k];
+					Assert::AreEqual(color, (row / 10 + row % 10) % 2);
+				}
+			}
+		}
+
+		TEST_METHOD(ShouldColorNonsymmetricPattern)
+		{
+			// Row 2 references row 0, but row 0 doesn't reference row 2
+			std::vector<Triplet<double>> triplets{ { 0, 0, 2. }, { 1, 1, 2. }, { 2, 2, 2. }, { 2, 0, 1. }, { 1, 2, 1. } };
+			const auto matrix = CSRSparseMatrix<double>::FromTriplets(3, 3, triplets.begin(), triplets.end());
+			Relaxation<> relaxation(matrix);
+
+			const auto &rows = relaxation.GetColoring().GetRows();
+			const auto &colorPtr = relaxation.GetColoring().GetLevelPointers();
+			std::vector<size_t> colors(3);
+			for (size_t color = 0; color < relaxation.GetColorCount(); color++)
+			{
+				for (auto k = colorPtr[color]; k < colorPtr[color + 1]; k++)
+				{
+					colors[rows[k]] = color;
+				}
+			}
+			Assert::IsTrue(colors[0] != colors[2]);
+			Assert::IsTrue(colors[1] != colors[2]);
+		}
+
+		TEST_METHOD(ShouldSweepInParallelLikeSerially)
+		{
+			const auto matrix = Poisson(200);
+			ThreadPool serialPool(1);
+			ThreadPool parallelPool(4);
+			Relaxation<> serial(matrix, serialPool);
+			Relaxation<> parallel(matrix, parallelPool);
+			std::vector<double> b(matrix.GetRowCount());
+			for (size_t i = 0; i < b.size(); i++)
+			{
+				b[i] = static_cast<double>(i % 11) - 5.;
+			}
+			std::vector<double> x0(b.size(), 0.);
+			std::vector<double> x1(b.size(), 0.);
+			std::vector<double> x2(b.size(), 0.);
+			std::vector<double> x3(b.size(), 0.);
+
+			serial.MulticolorSOR(b.data(), x0.data(), 1.2, 3, SweepDirection::Symmetric);
+			parallel.MulticolorSOR(b.data(), x1.data(), 1.2, 3, SweepDirection::Symmetric);
+			serial.Jacobi(b.data(), x2.data(), 3);
+			parallel.Jacobi(b.data(), x3.data(), 3);
+
+			Assert::IsTrue(x0 == x1);
+			Assert::IsTrue(x2 == x3);
+		}
+
+		TEST_METHOD(ShouldUpdateDiagonalAfterValuesChange)
+		{
+			std::vector<Triplet<double>> triplets{ { 0, 0, 1. }, { 1, 1, 1. } };
+			auto matrix = CSRSparseMatrix<double>::FromTriplets(2, 2, triplets.begin(), triplets.end());
+			Relaxation<> relaxation(matrix);
+			const std::vector<double> b{ 1., 1. };
+			std::vector<double> x{ 0., 0. };
+
+			matrix.SetElement(1, 1, 2.);
+			relaxation.UpdateValues();
+			relaxation.Jacobi(b.data(), x.data());
+
+			Assert::AreEqual(1., x[0]);
+			Assert::AreEqual(0.5, x[1]);
+		}
+
+		TEST_METHOD(ThrowIfDiagonalIsMissing)
+		{
+			std::vector<Triplet<double>> noDiagonal{ { 0, 0, 1. }, { 1, 0, 1. } };
+			const auto noDiagonalMatrix = CSRSparseMatrix<double>::FromTriplets(2, 2, noDiagonal.begin(), noDiagonal.end());
+			const CSRSparseMatrix<double> rectangular(2, 3);
+
+			Assert::ExpectException<std::exception>([&]()
+				{
+					Relaxation<> relaxation(noDiagonalMatrix);
+				});
+			Assert::ExpectException<std::exception>([&]()
+				{
+					Relaxation<> relaxation(rectangular);
+				});
+		}
+
+		TEST_METHOD(ShouldNotAllocateWhileSweepingOnThreadPool)
+		{
+			ThreadPool pool(4);
+			const auto matrix = Poisson(200);
+			std::vector<double> b(matrix.GetRowCount(), 1.);
+			std::vector<double> x(matrix.GetRowCount(), 0.);
+			Relaxation<> relaxation(matrix, pool);
+
+			AllocationCounter counter;
+			relaxation.Jacobi(b.data(), x.data(), 3, 0.8);
+			relaxation.MulticolorGaussSeidel(b.data(), x.data(), 2, SweepDirection::Symmetric);
+			relaxation.MulticolorSOR(b.data(), x.data(), 1.2, 2);
+
+			Assert::AreEqual(size_t(0), counter.GetCount());
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,160 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "../SparseMatrices/ISparseMatrix.h"
+#include "../SparseMatrices/RowIndexedLLSparseMatrix.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace SparseMatrices_Tests
+{
+	TEST_CLASS(RowIndexedLLSparseMatrix_Tests)
+	{
+	public:
+		TEST_METHOD(ShouldResizeCorrectly)
+		{
+			RowIndexedLLSparseMatrix<> mat;
+
+			const size_t newRows = 4;
+			const size_t newCols = 5;
+
+			mat.Resize(newRows, newCols);
+			mat.SetElement(3, 4, 1.);
+
+			Assert::AreEqual(newRows, mat.GetRowCount());
+			Assert::AreEqual(newCols, mat.GetColCount());
+			Assert::AreEqual(1., mat.ElementAt(3, 4));
+		}
+
+		TEST_METHOD(ShouldSetElements)
+		{
+			RowIndexedLLSparseMatrix<> mat(4, 4);
+
+			mat.SetElement(1, 2, 3.);
+			mat.SetElement(0, 0, 1.);
+			mat.SetElement(1, 1, 2.);
+			mat.SetElement(1, 2, 5.);
+
+			Assert::AreEqual(1., mat.ElementAt(0, 0));
+			Assert::AreEqual(2., mat.ElementAt(1, 1));
+			Assert::AreEqual(5., mat.ElementAt(1, 2));
+			Assert::AreEqual(0., mat.ElementAt(3, 3));
+			Assert::AreEqual(size_t(3), mat.GetNonZeroElementsCount());
+		}
+
+		TEST_METHOD(ShouldRemoveElements)
+		{
+			RowIndexedLLSparseMatrix<> mat(4, 4);
+
+			mat.SetElement(0, 0, 1.);
+			mat.SetElement(0, 3, 1.);
+			mat.RemoveElement(0, 0);
+			mat.RemoveElement(1, 1);
+			mat.SetElement(0, 3, 0.);
+
+			Assert::AreEqual(0., mat.ElementAt(0, 0));
+			Assert::AreEqual(0., mat.ElementAt(0, 3));
+			Assert::AreEqual(size_t(0), mat.GetNonZeroElementsCount());
+		}
+
+		TEST_METHOD(ThrowIfSettingElementOutOfBounds)
+		{
+			RowIndexedLLSparseMatrix<> mat(1, 1);
+
+			Assert::ExpectException<std::exception>([&]()
+				{
+					mat.SetElement(100, 100, 1);
+				});
+		}
+
+		TEST_METHOD(ThrowIfRemovingElementOutOfBounds)
+		{
+			RowIndexedLLSparseMatrix<> mat;
+
+			Assert::ExpectException<std::exception>([&]()
+				{
+					mat.RemoveElement(100, 100);
+				});
+		}
+
+		TEST_METHOD(ShouldTransposeMatrix)
+		{
+			RowIndexedLLSparseMatrix<> mat(2, 3);
+			mat.SetElement(0, 0, 1.);
+			mat.SetElement(0, 2, 3.);
+			mat.SetElement(1, 0, 4.);
+			mat.SetElement(1, 1, 2.);
+
+			mat.Transpose();
+
+			Assert::AreEqual(size_t(3), mat.GetRowCount());
+			Assert::AreEqual(size_t(2), mat.GetColCount());
+			Assert::AreEqual(1., mat.ElementAt(0, 0));
+			Assert::AreEqual(4., mat.ElementAt(0, 1));
+			Assert::AreEqual(2., mat.ElementAt(1, 1));
+			Assert::AreEqual(3., mat.ElementAt(2, 0));
+
+			std::stringstream buf;
+			double tmp;
+			buf << mat;
+			buf >> tmp;
+			Assert::AreEqual(1., tmp);
+			buf >> tmp;
+			Assert::AreEqual(4., tmp);
+		}
+
+		TEST_METHOD(ShouldKeepRowsApartWhenFilledOutOfOrder)
+		{
+			RowIndexedLLSparseMatrix<int> mat(3, 3);
+			mat.SetElement(2, 2, 9);
+			mat.SetElement(0, 1, 2);
+			mat.SetElement(2, 0, 7);
+			mat.SetElement(0, 0, 1);
+			mat.SetElement(1, 1, 5);
+			mat.SetElement(0, 2, 3);
+			mat.RemoveElement(2, 0);
+			mat.SetElement(2, 1, 8);
+
+			RowIndexedLLSparseMatrix<int> copy(mat);
+			mat.SetElement(0, 0, 0);
+			copy.Transpose();
+
+			Assert::AreEqual(size_t(5), mat.GetNonZeroElementsCount());
+			Assert::AreEqual(0, mat.ElementAt(0, 0));
+			Assert::AreEqual(size_t(6), copy.GetNonZeroElementsCount());
+			Assert::AreEqual(1, copy.ElementAt(0, 0));
+			Assert::AreEqual(2, copy.ElementAt(1, 0));
+			Assert::AreEqual(3, copy.ElementAt(2, 0));
+			Assert::AreEqual(5, copy.ElementAt(1, 1));
+			Assert::AreEqual(8, copy.ElementAt(1, 2));
+			Assert::AreEqual(9, copy.ElementAt(2, 2));
+			Assert::AreEqual(0, copy.ElementAt(0, 2));
+
+			std::stringstream buf;
+			buf << copy;
+			int tmp;
+			for (int expected : { 1, 0, 0, 2, 5, 8, 3, 0, 9 })
+			{
+				buf >> tmp;
+				Assert::AreEqual(expected, tmp);
+			}
+		}
+
+		TEST_METHOD(ShouldConvertFromAndToLLSparseMatrix)
+		{
+			LLSparseMatrix<int> source(3, 3);
+			source.SetElement(2, 0, 7);
+			source.SetElement(0, 1, 4);
+			source.SetElement(1, 2, 5);
+
+			RowIndexedLLSparseMatrix<int> mat(source);
+			mat.SetElement(0, 0, 1);
+			auto result = mat.ToLLSparseMatrix();
+
+			Assert::AreEqual(size_t(4), result.GetNonZeroElementsCount());
+			Assert::AreEqual(1, result.ElementAt(0, 0));
+			Assert::AreEqual(4, result.ElementAt(0, 1));
+			Assert::AreEqual(5, result.ElementAt(1, 2));
+			Assert::AreEqual(7, result.ElementAt(2, 0));
+		}
+	};
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <cmath>
+#include <vector>
+#include "../SparseMatrices/CSRSparseMatrix.h"
+#include "../SparseMatrices/Triplets.h"
+
+namespace SparseMatrices_Tests
+{
+	/**
+	 * 5-point convection-diffusion operator on side x side grid, convection is discretized upwind,
+	 * every value is multiplied by scale
+	 */
+	inline CSRSparseMatrix<double> ConvectionDiffusion(const size_t side, const double convection, const double scale = 1.)
+	{
+		std::vector<Triplet<double>> triplets;
+		for (size_t i = 0; i < side; i++)
+		{
+			for (size_t j = 0; j < side; j++)
+			{
+				const auto row = i * side + j;
+				triplets.push_back({ row, row, scale * (4. + convection) });
+				if (i > 0) triplets.push_back({ row, row - side, -scale });
+				if (i + 1 < side) triplets.push_back({ row, row + side, -scale });
+				if (j > 0) triplets.push_back({ row, row - 1, -scale * (1. + convection) });
+				if (j + 1 < side) triplets.push_back({ row, row + 1, -scale });
+			}
+		}
+		return CSRSparseMatrix<double>::FromTriplets(side * side, side * side, triplets.begin(), triplets.end());
+	}
+
+	// 5-point Laplacian on side x side grid, every value multiplied by scale
+	inline CSRSparseMatrix<double> Poisson(const size_t side, const double scale = 1.)
+	{
+		return ConvectionDiffusion(side, 0., scale);
+	}
+
+	inline double ResidualNorm(const CSRSparseMatrix<double> &matrix, const std::vector<double> &b, const std::vector<double> &x)
+	{
+		const auto ax = matrix.Multiply(x);
+		double sum = 0;
+		for (size_t i = 0; i < b.size(); i++)
+		{
+			sum += (b[i] - ax[i]) * (b[i] - ax[i]);
+		}
+		return std::sqrt(sum);
+	}
+
+	struct JacobiPreconditioner
+	{
+		std::vector<double> InverseDiagonal;
+		void Apply(const double *r, double *z) const
+		{
+			for (size_t i = 0; i < InverseDiagonal.size(); i++)
+			{
+				z[i] = InverseDiagonal[i] * r[i];
+			}
+		}
+	};
+}
\ No newline at end of file
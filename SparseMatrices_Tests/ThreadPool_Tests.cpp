@@ -0,0 +1,134 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "AllocationCounter.h"
+#include "../SparseMatrices/ThreadPool.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace SparseMatrices_Tests
+{
+	TEST_CLASS(ThreadPool_Tests)
+	{
+	public:
+		TEST_METHOD(ShouldRunEveryTaskOnce)
+		{
+			ThreadPool pool(4);
+			std::vector<std::atomic<int>> runs(1000);
+
+			for (int repeat = 0; repeat < 3; repeat++)
+			{
+				pool.ParallelFor(runs.size(),
+					[&](size_t task, size_t threadIndex)
+					{
+						Assert::IsTrue(threadIndex < pool.GetThreadCount());
+						++runs[task];
+					});
+			}
+
+			for (auto &count : runs)
+			{
+				Assert::AreEqual(3, count.load());
+			}
+		}
+
+		TEST_METHOD(ShouldCoverWholeRange)
+		{
+			ThreadPool pool(3);
+			std::vector<int> visited(10000, 0);
+
+			pool.ParallelForRange(visited.size(),
+				[&](size_t begin, size_t end, size_t)
+				{
+					for (auto i = begin; i < end; i++)
+					{
+						++visited[i];
+					}
+				}, 100);
+
+			for (auto count : visited)
+			{
+				Assert::AreEqual(1, count);
+			}
+		}
+
+		TEST_METHOD(ShouldRunNestedLoopsSerially)
+		{
+			ThreadPool pool(2);
+			std::atomic<int> total{ 0 };
+
+			pool.ParallelFor(4,
+				[&](size_t, size_t)
+				{
+					pool.ParallelFor(5,
+						[&](size_t, size_t)
+						{
+							++total;
+						});
+				});
+
+			Assert::AreEqual(20, total.load());
+		}
+
+		TEST_METHOD(ShouldRethrowTaskException)
+		{
+			ThreadPool pool(4);
+
+			Assert::ExpectException<std::runtime_error>([&]()
+				{
+					pool.ParallelFor(100,
+						[](size_t task, size_t)
+						{
+							if (task == 42)
+							{
+								throw std::runtime_error("Task failed");
+							}
+						});
+				});
+		}
+
+		TEST_METHOD(ShouldRunEachThreadIndexOnSameWorker)
+		{
+			ThreadPool pool(3, ThreadPinning::PinToCores);
+			std::vector<std::thread::id> firstRun(3);
+			std::vector<std::thread::id> secondRun(3);
+
+			pool.RunOnEachThread([&](size_t threadIndex) { firstRun[threadIndex] = std::this_thread::get_id(); });
+			pool.RunOnEachThread([&](size_t threadIndex) { secondRun[threadIndex] = std::this_thread::get_id(); });
+
+			Assert::IsTrue(firstRun == secondRun);
+			for (auto &id : firstRun)
+			{
+				Assert::IsTrue(id != std::this_thread::get_id());
+			}
+		}
+
+		TEST_METHOD(ShouldNotAllocateWhenDispatchingJobs)
+		{
+			ThreadPool pool(4);
+			std::vector<double> values(1 << 16, 1.);
+			std::atomic<size_t> calls{ 0 };
+
+			AllocationCounter counter;
+			for (int repeat = 0; repeat < 10; repeat++)
+			{
+				pool.ParallelForRange(values.size(),
+					[&](size_t begin, size_t end, size_t)
+					{
+						for (auto i = begin; i < end; i++)
+						{
+							values[i] *= 2.;
+						}
+					});
+				pool.RunOnEachThread(
+					[&](size_t)
+					{
+						++calls;
+					});
+			}
+
+			Assert::AreEqual(size_t(0), counter.GetCount());
+			Assert::AreEqual(size_t(40), calls.load());
+			Assert::AreEqual(1024., values.back());
+		}
+	};
+}
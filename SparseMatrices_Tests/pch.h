@@ -11,5 +11,8 @@
 #include <exception>
 #include <iostream>
 #include <sstream>
+#include <stdexcept>
+#include <vector>
+#include <atomic>
 
 #endif //PCH_H